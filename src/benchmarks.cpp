@@ -0,0 +1,542 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include "s21_fixed_matrix.h"
+#include "s21_matrix_batch.h"
+#include "s21_matrix_blas.h"
+#include "s21_matrix_io.h"
+#include "s21_matrix_oop.h"
+#include "s21_matrix_solver.h"
+#include "s21_sparse_matrix.h"
+#include "s21_tiled_matrix.h"
+
+// Throughput of every S21Matrix operation for n x n matrices (the product
+// also for float). Each case reports bytes_per_second from the bytes it has
+// to move at minimum and, for arithmetic, FLOPS from the nominal operation
+// count of the classical algorithm, so that the rates stay comparable when
+// an implementation changes. `make bench` writes the results to bench.json;
+// two such files can be diffed with compare.py from the Google Benchmark
+// tools.
+
+namespace {
+
+constexpr int kMinSize = 4;
+constexpr int kMaxSize = 4096;
+
+// Well conditioned and diagonally dominant, so that Determinant and
+// InverseMatrix never hit a singular matrix.
+template <typename T = double>
+S21BasicMatrix<T> BenchMatrix(int n, int seed) {
+  S21BasicMatrix<T> result(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++)
+      result(i, j) = ((i * 31 + j * 17 + seed) % 23) / 23.0 - 0.5;
+  for (int i = 0; i < n; i++) result(i, i) += n;
+  return result;
+}
+
+double Elements(const benchmark::State& state) {
+  return (double)state.range(0) * state.range(0);
+}
+
+void SetRates(benchmark::State& state, double bytes, double flops) {
+  state.SetBytesProcessed((int64_t)(bytes * state.iterations()));
+  if (flops > 0)
+    state.counters["FLOPS"] = benchmark::Counter(
+        flops, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void BM_Construct(benchmark::State& state) {
+  int n = (int)state.range(0);
+  for (auto _ : state) {
+    S21Matrix matrix(n, n);
+    benchmark::DoNotOptimize(matrix.data());
+  }
+  SetRates(state, 8 * Elements(state), 0);
+}
+
+void BM_Copy(benchmark::State& state) {
+  S21Matrix a = BenchMatrix((int)state.range(0), 1);
+  for (auto _ : state) {
+    S21Matrix copy(a);
+    benchmark::DoNotOptimize(copy.data());
+  }
+  SetRates(state, 16 * Elements(state), 0);
+}
+
+void BM_Move(benchmark::State& state) {
+  S21Matrix a = BenchMatrix((int)state.range(0), 1);
+  for (auto _ : state) {
+    S21Matrix moved(std::move(a));
+    a = std::move(moved);
+    benchmark::DoNotOptimize(a.data());
+  }
+  SetRates(state, 0, 0);
+}
+
+void BM_SumMatrix(benchmark::State& state) {
+  S21Matrix a = BenchMatrix((int)state.range(0), 1);
+  S21Matrix b = BenchMatrix((int)state.range(0), 2);
+  for (auto _ : state) {
+    a.SumMatrix(b);
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 24 * Elements(state), Elements(state));
+}
+
+void BM_MulNumber(benchmark::State& state) {
+  S21Matrix a = BenchMatrix((int)state.range(0), 1);
+  for (auto _ : state) {
+    a.MulNumber(1.0000001);
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 16 * Elements(state), Elements(state));
+}
+
+// D = A + B - C * 2 through the expression templates: one pass over four
+// matrices.
+void BM_ExpressionChain(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21Matrix a = BenchMatrix(n, 1);
+  S21Matrix b = BenchMatrix(n, 2);
+  S21Matrix c = BenchMatrix(n, 3);
+  S21Matrix d(n, n);
+  for (auto _ : state) {
+    d = a + b - c * 2.0;
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 32 * Elements(state), 3 * Elements(state));
+}
+
+template <typename T>
+void BM_MulMatrix(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21BasicMatrix<T> a = BenchMatrix<T>(n, 1);
+  S21BasicMatrix<T> b = BenchMatrix<T>(n, 2);
+  for (auto _ : state) {
+    S21BasicMatrix<T> product = a * b;
+    benchmark::DoNotOptimize(product.data());
+  }
+  SetRates(state, 3 * sizeof(T) * Elements(state), 2.0 * Elements(state) * n);
+}
+
+void BM_Transpose(benchmark::State& state) {
+  S21Matrix a = BenchMatrix((int)state.range(0), 1);
+  for (auto _ : state) {
+    S21Matrix transposed = a.Transpose();
+    benchmark::DoNotOptimize(transposed.data());
+  }
+  SetRates(state, 16 * Elements(state), 0);
+}
+
+void BM_TransposeInPlace(benchmark::State& state) {
+  S21Matrix a = BenchMatrix((int)state.range(0), 1);
+  for (auto _ : state) {
+    a.TransposeInPlace();
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 16 * Elements(state), 0);
+}
+
+void BM_Determinant(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21Matrix a = BenchMatrix(n, 1);
+  for (auto _ : state) benchmark::DoNotOptimize(a.Determinant());
+  SetRates(state, 16 * Elements(state), 2.0 / 3.0 * Elements(state) * n);
+}
+
+// Nominal count of the LU route (factorization plus inverse).
+void BM_CalcComplements(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21Matrix a = BenchMatrix(n, 1);
+  for (auto _ : state) {
+    S21Matrix complements = a.CalcComplements();
+    benchmark::DoNotOptimize(complements.data());
+  }
+  SetRates(state, 16 * Elements(state), 2.0 * Elements(state) * n);
+}
+
+void BM_InverseMatrix(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21Matrix a = BenchMatrix(n, 1);
+  for (auto _ : state) {
+    S21Matrix inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(inverse.data());
+  }
+  SetRates(state, 16 * Elements(state), 2.0 * Elements(state) * n);
+}
+
+// Grows by one row (or column) and shrinks back, two reallocations each.
+void BM_SetRows(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21Matrix a = BenchMatrix(n, 1);
+  for (auto _ : state) {
+    a.setRows(n + 1);
+    a.setRows(n);
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 32 * Elements(state), 0);
+}
+
+void BM_SetCols(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21Matrix a = BenchMatrix(n, 1);
+  for (auto _ : state) {
+    a.setCols(n + 1);
+    a.setCols(n);
+    benchmark::ClobberMemory();
+  }
+  SetRates(state, 32 * Elements(state), 0);
+}
+
+// Small transforms through S21FixedMatrix, to compare with BM_MulMatrix and
+// BM_InverseMatrix at the same size.
+template <int N>
+void BM_FixedMulMatrix(benchmark::State& state) {
+  S21FixedMatrix<N, N> a(BenchMatrix(N, 1));
+  S21FixedMatrix<N, N> b(BenchMatrix(N, 2));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    S21FixedMatrix<N, N> product = a * b;
+    benchmark::DoNotOptimize(product);
+  }
+  SetRates(state, 24.0 * N * N, 2.0 * N * N * N);
+}
+
+template <int N>
+void BM_FixedInverseMatrix(benchmark::State& state) {
+  S21FixedMatrix<N, N> a(BenchMatrix(N, 1));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a);
+    S21FixedMatrix<N, N> inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(inverse);
+  }
+  SetRates(state, 16.0 * N * N, 2.0 * N * N * N);
+}
+
+constexpr int kBatchCount = 1 << 14;
+
+S21MatrixBatch BenchBatch(int n, int seed) {
+  S21MatrixBatch batch(kBatchCount, n, n);
+  for (int k = 0; k < kBatchCount; k++) batch.Set(k, BenchMatrix(n, seed + k));
+  return batch;
+}
+
+// kBatchCount products at once; items are matrices.
+template <int N>
+void BM_BatchMulMatrix(benchmark::State& state) {
+  S21MatrixBatch a = BenchBatch(N, 1);
+  S21MatrixBatch b = BenchBatch(N, 2);
+  for (auto _ : state) {
+    S21MatrixBatch product = a;
+    product.MulMatrix(b);
+    benchmark::DoNotOptimize(product.Lanes(0, 0));
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchCount);
+  SetRates(state, 24.0 * N * N * kBatchCount, 2.0 * N * N * N * kBatchCount);
+}
+
+template <int N>
+void BM_BatchInverseMatrix(benchmark::State& state) {
+  S21MatrixBatch a = BenchBatch(N, 1);
+  for (auto _ : state) {
+    S21MatrixBatch inverse = a.InverseMatrix();
+    benchmark::DoNotOptimize(inverse.Lanes(0, 0));
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchCount);
+  SetRates(state, 16.0 * N * N * kBatchCount, 2.0 * N * N * N * kBatchCount);
+}
+
+// The same inverses one S21Matrix at a time, for comparison.
+template <int N>
+void BM_LoopInverseMatrix(benchmark::State& state) {
+  std::vector<S21Matrix> matrices;
+  for (int k = 0; k < kBatchCount; k++)
+    matrices.push_back(BenchMatrix(N, 1 + k));
+  for (auto _ : state) {
+    for (const S21Matrix& matrix : matrices) {
+      S21Matrix inverse = matrix.InverseMatrix();
+      benchmark::DoNotOptimize(inverse.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchCount);
+  SetRates(state, 16.0 * N * N * kBatchCount, 2.0 * N * N * N * kBatchCount);
+}
+
+// Symmetric and diagonally dominant with a positive diagonal, hence SPD.
+S21Matrix BenchSpdMatrix(int n) {
+  S21Matrix a = BenchMatrix(n, 1);
+  return a + a.Transpose();
+}
+
+void BM_Cholesky(benchmark::State& state) {
+  S21Matrix a = BenchSpdMatrix((int)state.range(0));
+  for (auto _ : state) {
+    S21MatrixCholesky cholesky = a.Cholesky();
+    benchmark::DoNotOptimize(cholesky.getL().data());
+  }
+  SetRates(state, 16 * Elements(state),
+           Elements(state) * state.range(0) / 3.0);
+}
+
+// One right-hand side against a factorization made once, outside the loop.
+template <S21SolverMethod kMethod>
+void BM_SolverSolve(benchmark::State& state) {
+  S21Matrix a = BenchSpdMatrix((int)state.range(0));
+  S21Solver solver(a, kMethod);
+  std::vector<double> b(state.range(0), 1.0);
+  for (auto _ : state) {
+    std::vector<double> x = solver.Solve(b);
+    benchmark::DoNotOptimize(x.data());
+  }
+  SetRates(state, 8 * Elements(state), 2 * Elements(state));
+}
+
+// n x n with about eight nonzeros per row, a 1D stencil plus scattered
+// couplings.
+S21SparseMatrix BenchSparse(int n) {
+  std::vector<S21Triplet<double>> triplets;
+  for (int i = 0; i < n; i++) {
+    triplets.push_back({i, i, 4.0});
+    for (int k = 1; k < 8; k++)
+      triplets.push_back({i, (int)((i * 7919L + k * 104729L) % n), -0.5});
+  }
+  return S21SparseMatrix(n, n, triplets);
+}
+
+void BM_SparseMulVector(benchmark::State& state) {
+  S21SparseMatrix a = BenchSparse((int)state.range(0));
+  std::vector<double> x(state.range(0), 1.0);
+  for (auto _ : state) {
+    std::vector<double> y = a.MulVector(x);
+    benchmark::DoNotOptimize(y.data());
+  }
+  SetRates(state, 12.0 * a.getNonZeros() + 16.0 * state.range(0),
+           2.0 * a.getNonZeros());
+}
+
+void BM_SparseMulMatrix(benchmark::State& state) {
+  S21SparseMatrix a = BenchSparse((int)state.range(0));
+  for (auto _ : state) {
+    S21SparseMatrix product = a;
+    product.MulMatrix(a);
+    benchmark::DoNotOptimize(product.getValues().data());
+  }
+  SetRates(state, 24.0 * a.getNonZeros(), 0);
+}
+
+const char kBenchFile[] = "s21_bench_matrix.bin";
+
+void BM_LoadBinary(benchmark::State& state) {
+  BenchMatrix((int)state.range(0), 1).SaveBinary(kBenchFile);
+  for (auto _ : state) {
+    S21Matrix a = S21Matrix::LoadBinary(kBenchFile);
+    benchmark::DoNotOptimize(a.data());
+  }
+  SetRates(state, 8.0 * state.range(0) * state.range(0), 0);
+  std::remove(kBenchFile);
+}
+
+// Touches one element per page, so the cost includes the page faults.
+void BM_MapBinary(benchmark::State& state) {
+  BenchMatrix((int)state.range(0), 1).SaveBinary(kBenchFile);
+  for (auto _ : state) {
+    S21Matrix a = S21Matrix::MapBinary(kBenchFile);
+    double sum = 0;
+    for (long i = 0; i < (long)a.getRows() * a.getCols(); i += 512)
+      sum += a.data()[i];
+    benchmark::DoNotOptimize(sum);
+  }
+  SetRates(state, 8.0 * state.range(0) * state.range(0), 0);
+  std::remove(kBenchFile);
+}
+
+const char kBenchCsv[] = "s21_bench_matrix.csv";
+
+void BM_ToCSV(benchmark::State& state) {
+  S21Matrix a = BenchMatrix((int)state.range(0), 1) * 0.1;
+  for (auto _ : state) a.ToCSV(kBenchCsv);
+  std::ifstream file(kBenchCsv, std::ios::ate);
+  SetRates(state, (double)file.tellg(), 0);
+  std::remove(kBenchCsv);
+}
+
+void BM_FromCSV(benchmark::State& state) {
+  (BenchMatrix((int)state.range(0), 1) * 0.1).ToCSV(kBenchCsv);
+  for (auto _ : state) {
+    S21Matrix a = S21Matrix::FromCSV(kBenchCsv);
+    benchmark::DoNotOptimize(a.data());
+  }
+  std::ifstream file(kBenchCsv, std::ios::ate);
+  SetRates(state, (double)file.tellg(), 0);
+  std::remove(kBenchCsv);
+}
+
+// Out-of-core runs with a cache of a quarter of one operand.
+std::size_t TiledCacheBytes(benchmark::State& state) {
+  return 2 * state.range(0) * state.range(0);
+}
+
+void BM_TiledMulMatrix(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21TiledMatrix a = S21TiledMatrix::FromMatrix(
+      BenchMatrix(n, 1), S21TiledMatrix::kDefaultTileSize,
+      TiledCacheBytes(state));
+  for (auto _ : state) {
+    S21TiledMatrix product = a.Transpose();
+    product.MulMatrix(a);
+    benchmark::DoNotOptimize(product.getCacheStats());
+  }
+  SetRates(state, 0, 2.0 * n * n * n);
+}
+
+void BM_TiledLU(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21TiledMatrix a = S21TiledMatrix::FromMatrix(
+      BenchMatrix(n, 1), S21TiledMatrix::kDefaultTileSize,
+      TiledCacheBytes(state));
+  for (auto _ : state) {
+    S21TiledLU lu = a.LU();
+    benchmark::DoNotOptimize(lu.getPivots().data());
+  }
+  SetRates(state, 0, 2.0 / 3 * n * n * n);
+}
+
+// Product of the minors of two (n + 1) x (n + 1) matrices, read in place.
+void BM_MinorProduct(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21Matrix a = BenchMatrix(n + 1, 1);
+  S21Matrix b = BenchMatrix(n + 1, 2);
+  for (auto _ : state) {
+    S21Matrix product = a.Minor(n / 2, n / 3) * b.Minor(n / 3, n / 2);
+    benchmark::DoNotOptimize(product.data());
+  }
+  SetRates(state, 3 * sizeof(double) * Elements(state),
+           2.0 * Elements(state) * n);
+}
+
+// y = A * x + y into an existing vector, the kernel of iterative solvers.
+void BM_Gemv(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21Matrix a = BenchMatrix(n, 1);
+  S21Matrix x = a.block(0, 0, n, 1);
+  S21Matrix y(n, 1);
+  for (auto _ : state) {
+    S21Gemv(1.0, a, S21Op::kNoTrans, x, 1.0, y);
+    benchmark::DoNotOptimize(y.data());
+  }
+  SetRates(state, sizeof(double) * Elements(state), 2.0 * Elements(state));
+}
+
+// Streams n rows of n elements into a matrix one row at a time.
+void BM_AppendRow(benchmark::State& state) {
+  int n = (int)state.range(0);
+  std::vector<double> row(n, 1.0);
+  for (auto _ : state) {
+    S21Matrix matrix(1, n);
+    for (int i = 1; i < n; i++) matrix.AppendRow(row);
+    benchmark::DoNotOptimize(matrix.data());
+  }
+  SetRates(state, sizeof(double) * Elements(state), 0);
+}
+
+// Strassen-Winograd products of n x n matrices with crossover range(1);
+// FLOPS counts the 2 * n^3 operations of the classic product.
+void BM_MulStrassen(benchmark::State& state) {
+  int n = (int)state.range(0);
+  S21Matrix a = BenchMatrix(n, 1);
+  S21Matrix b = BenchMatrix(n, 2);
+  S21Matrix product(n, n);
+  for (auto _ : state) {
+    S21GemmStrassen(n, n, n, 1.0, a.data(), a.stride(), 1, b.data(),
+                    b.stride(), 1, 0.0, product.data(), product.stride(),
+                    (int)state.range(1));
+    benchmark::DoNotOptimize(product.data());
+  }
+  SetRates(state, 3 * sizeof(double) * Elements(state),
+           2.0 * Elements(state) * n);
+}
+
+void Sizes(benchmark::internal::Benchmark* bench) {
+  bench->RangeMultiplier(4)->Range(kMinSize, kMaxSize);
+}
+
+}  // namespace
+
+BENCHMARK(BM_Construct)->Apply(Sizes);
+BENCHMARK(BM_Copy)->Apply(Sizes);
+BENCHMARK(BM_Move)->Apply(Sizes);
+BENCHMARK(BM_SumMatrix)->Apply(Sizes);
+BENCHMARK(BM_MulNumber)->Apply(Sizes);
+BENCHMARK(BM_ExpressionChain)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_MulMatrix, double)
+    ->Apply(Sizes)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_MulMatrix, float)
+    ->Apply(Sizes)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Transpose)->Apply(Sizes);
+BENCHMARK(BM_TransposeInPlace)->Apply(Sizes);
+BENCHMARK(BM_Determinant)->Apply(Sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CalcComplements)->Apply(Sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_InverseMatrix)->Apply(Sizes)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SetRows)->Apply(Sizes);
+BENCHMARK(BM_SetCols)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_FixedMulMatrix, 3);
+BENCHMARK_TEMPLATE(BM_FixedMulMatrix, 4);
+BENCHMARK_TEMPLATE(BM_FixedInverseMatrix, 3);
+BENCHMARK_TEMPLATE(BM_FixedInverseMatrix, 4);
+BENCHMARK_TEMPLATE(BM_BatchMulMatrix, 4);
+BENCHMARK_TEMPLATE(BM_BatchMulMatrix, 8);
+BENCHMARK_TEMPLATE(BM_BatchInverseMatrix, 4);
+BENCHMARK_TEMPLATE(BM_BatchInverseMatrix, 8);
+BENCHMARK_TEMPLATE(BM_LoopInverseMatrix, 4);
+BENCHMARK(BM_Cholesky)
+    ->RangeMultiplier(4)
+    ->Range(kMinSize, 1024)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SolverSolve, S21SolverMethod::kLU)
+    ->RangeMultiplier(4)
+    ->Range(kMinSize, 1024);
+BENCHMARK_TEMPLATE(BM_SolverSolve, S21SolverMethod::kCholesky)
+    ->RangeMultiplier(4)
+    ->Range(kMinSize, 1024);
+BENCHMARK_TEMPLATE(BM_SolverSolve, S21SolverMethod::kQR)
+    ->RangeMultiplier(4)
+    ->Range(kMinSize, 1024);
+BENCHMARK(BM_SparseMulVector)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_SparseMulMatrix)
+    ->RangeMultiplier(16)
+    ->Range(1 << 10, 1 << 18)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadBinary)->Apply(Sizes);
+BENCHMARK(BM_MapBinary)->Apply(Sizes);
+BENCHMARK(BM_ToCSV)
+    ->RangeMultiplier(4)
+    ->Range(256, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FromCSV)
+    ->RangeMultiplier(4)
+    ->Range(256, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TiledMulMatrix)
+    ->RangeMultiplier(2)
+    ->Range(1024, 2048)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TiledLU)
+    ->RangeMultiplier(2)
+    ->Range(1024, 2048)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_MinorProduct)->Apply(Sizes);
+BENCHMARK(BM_AppendRow)->Apply(Sizes);
+BENCHMARK(BM_Gemv)->Apply(Sizes);
+BENCHMARK(BM_MulStrassen)
+    ->ArgsProduct({{1024, 2048, 4096}, {512, 1024}})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
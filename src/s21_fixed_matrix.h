@@ -0,0 +1,438 @@
+#ifndef SRC_S21_FIXED_MATRIX_H_
+#define SRC_S21_FIXED_MATRIX_H_
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "s21_matrix_oop.h"
+
+// Matrix with dimensions fixed at compile time, for the many small (3x3,
+// 4x4) transforms where a heap buffer and runtime size checks cost more
+// than the arithmetic itself. Elements live inside the object, operands of
+// mismatched dimensions do not compile, and every operation is constexpr.
+// Loops over dimensions up to kS21FixedUnroll are unrolled; Determinant and
+// InverseMatrix use closed forms up to 4x4 and Gaussian elimination above.
+//
+//   constexpr S21FixedMatrix<2, 2> kRotate(0, -1, 1, 0);
+//   static_assert(kRotate * kRotate * kRotate * kRotate ==
+//                 S21FixedMatrix<2, 2>::Identity());
+
+constexpr int kS21FixedUnroll = 16;
+
+namespace s21_fixed_internal {
+
+template <typename Body, int... I>
+constexpr void Unrolled(Body& body, std::integer_sequence<int, I...>) {
+  (body(std::integral_constant<int, I>()), ...);
+}
+
+// body(i) for i in [0, N), unrolled when N is small. body takes its index
+// as auto so that it works either way.
+template <int N, typename Body>
+constexpr void For(Body body) {
+  if constexpr (N <= kS21FixedUnroll) {
+    Unrolled(body, std::make_integer_sequence<int, N>());
+  } else {
+    for (int i = 0; i < N; i++) body(i);
+  }
+}
+
+template <typename T>
+constexpr T Abs(T value) {
+  return value < T(0) ? -value : value;
+}
+
+}  // namespace s21_fixed_internal
+
+template <int R, int C, typename T = double>
+class S21FixedMatrix {
+  static_assert(R > 0 && C > 0, "Invalid size of matrix");
+
+ public:
+  using value_type = T;
+
+  // Zero matrix.
+  constexpr S21FixedMatrix() : matrix_() {}
+  // All R * C elements in row-major order.
+  template <typename... Values,
+            typename = std::enable_if_t<
+                sizeof...(Values) == R * C &&
+                (std::is_arithmetic<Values>::value && ...)>>
+  constexpr explicit S21FixedMatrix(Values... values)
+      : matrix_{static_cast<T>(values)...} {}
+  // Throws if other is not R x C.
+  explicit S21FixedMatrix(const S21BasicMatrix<T>& other) : matrix_() {
+    if (other.getRows() != R || other.getCols() != C)
+      throw std::invalid_argument("Different dimension of matrices");
+    for (int i = 0; i < R; i++)
+      for (int j = 0; j < C; j++)
+        at_unchecked(i, j) = other.at_unchecked(i, j);
+  }
+
+  static constexpr S21FixedMatrix Identity() {
+    static_assert(R == C, "The matrix is not square");
+    S21FixedMatrix result;
+    s21_fixed_internal::For<R>([&](auto i) { result.at_unchecked(i, i) = 1; });
+    return result;
+  }
+
+  S21BasicMatrix<T> ToMatrix() const {
+    S21BasicMatrix<T> result(R, C);
+    for (int i = 0; i < R; i++)
+      for (int j = 0; j < C; j++)
+        result.at_unchecked(i, j) = at_unchecked(i, j);
+    return result;
+  }
+
+  static constexpr int getRows() { return R; }
+  static constexpr int getCols() { return C; }
+  constexpr T* data() { return matrix_; }
+  constexpr const T* data() const { return matrix_; }
+
+  constexpr T& operator()(int i, int j) {
+    if (i < 0 || i >= R || j < 0 || j >= C)
+      throw std::invalid_argument("Index out of range");
+    return matrix_[i * C + j];
+  }
+  constexpr const T& operator()(int i, int j) const {
+    if (i < 0 || i >= R || j < 0 || j >= C)
+      throw std::invalid_argument("Index out of range");
+    return matrix_[i * C + j];
+  }
+  constexpr T& at_unchecked(int i, int j) { return matrix_[i * C + j]; }
+  constexpr const T& at_unchecked(int i, int j) const {
+    return matrix_[i * C + j];
+  }
+
+  constexpr bool EqMatrix(const S21FixedMatrix& other) const {
+    bool equal = true;
+    s21_fixed_internal::For<R * C>([&](auto k) {
+      if (s21_fixed_internal::Abs(matrix_[k] - other.matrix_[k]) >
+          S21MatrixTraits<T>::kEpsilon)
+        equal = false;
+    });
+    return equal;
+  }
+
+  constexpr void SumMatrix(const S21FixedMatrix& other) {
+    s21_fixed_internal::For<R * C>(
+        [&](auto k) { matrix_[k] += other.matrix_[k]; });
+  }
+
+  constexpr void SubMatrix(const S21FixedMatrix& other) {
+    s21_fixed_internal::For<R * C>(
+        [&](auto k) { matrix_[k] -= other.matrix_[k]; });
+  }
+
+  constexpr void MulNumber(const T multiplier) {
+    s21_fixed_internal::For<R * C>([&](auto k) { matrix_[k] *= multiplier; });
+  }
+
+  // Only a C x C factor keeps the dimensions, as MulMatrix requires.
+  constexpr void MulMatrix(const S21FixedMatrix<C, C, T>& other) {
+    *this = *this * other;
+  }
+
+  constexpr S21FixedMatrix<C, R, T> Transpose() const {
+    S21FixedMatrix<C, R, T> result;
+    s21_fixed_internal::For<R>([&](auto i) {
+      s21_fixed_internal::For<C>(
+          [&](auto j) { result.at_unchecked(j, i) = at_unchecked(i, j); });
+    });
+    return result;
+  }
+
+  constexpr S21FixedMatrix CalcComplements() const;
+  constexpr T Determinant() const;
+  constexpr S21FixedMatrix InverseMatrix() const;
+
+  constexpr bool operator==(const S21FixedMatrix& other) const {
+    return EqMatrix(other);
+  }
+  constexpr bool operator!=(const S21FixedMatrix& other) const {
+    return !EqMatrix(other);
+  }
+  constexpr S21FixedMatrix& operator+=(const S21FixedMatrix& other) {
+    SumMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator-=(const S21FixedMatrix& other) {
+    SubMatrix(other);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(const T multiplier) {
+    MulNumber(multiplier);
+    return *this;
+  }
+  constexpr S21FixedMatrix& operator*=(const S21FixedMatrix<C, C, T>& other) {
+    MulMatrix(other);
+    return *this;
+  }
+
+ private:
+  T matrix_[R * C];
+};
+
+template <int R, int C, typename T>
+constexpr S21FixedMatrix<R, C, T> operator+(
+    S21FixedMatrix<R, C, T> lhs, const S21FixedMatrix<R, C, T>& rhs) {
+  lhs.SumMatrix(rhs);
+  return lhs;
+}
+
+template <int R, int C, typename T>
+constexpr S21FixedMatrix<R, C, T> operator-(
+    S21FixedMatrix<R, C, T> lhs, const S21FixedMatrix<R, C, T>& rhs) {
+  lhs.SubMatrix(rhs);
+  return lhs;
+}
+
+template <int R, int C, typename T>
+constexpr S21FixedMatrix<R, C, T> operator*(
+    S21FixedMatrix<R, C, T> matrix,
+    typename S21FixedMatrix<R, C, T>::value_type multiplier) {
+  matrix.MulNumber(multiplier);
+  return matrix;
+}
+
+template <int R, int C, typename T>
+constexpr S21FixedMatrix<R, C, T> operator*(
+    typename S21FixedMatrix<R, C, T>::value_type multiplier,
+    S21FixedMatrix<R, C, T> matrix) {
+  matrix.MulNumber(multiplier);
+  return matrix;
+}
+
+// (R x K) * (K x C); any other pair of shapes does not compile.
+template <int R, int K, int C, typename T>
+constexpr S21FixedMatrix<R, C, T> operator*(
+    const S21FixedMatrix<R, K, T>& lhs, const S21FixedMatrix<K, C, T>& rhs) {
+  S21FixedMatrix<R, C, T> result;
+  s21_fixed_internal::For<R>([&](auto i) {
+    s21_fixed_internal::For<C>([&](auto j) {
+      T sum = 0;
+      s21_fixed_internal::For<K>([&](auto k) {
+        sum += lhs.at_unchecked(i, k) * rhs.at_unchecked(k, j);
+      });
+      result.at_unchecked(i, j) = sum;
+    });
+  });
+  return result;
+}
+
+namespace s21_fixed_internal {
+
+// The matrix without row `row` and column `col`.
+template <int N, typename T>
+constexpr S21FixedMatrix<N - 1, N - 1, T> Minor(
+    const S21FixedMatrix<N, N, T>& a, int row, int col) {
+  S21FixedMatrix<N - 1, N - 1, T> result;
+  For<N>([&](auto i) {
+    For<N>([&](auto j) {
+      if (i != row && j != col)
+        result.at_unchecked(i - (i > row), j - (j > col)) =
+            a.at_unchecked(i, j);
+    });
+  });
+  return result;
+}
+
+// Gaussian elimination with partial pivoting on a copy, for N > 4.
+template <int N, typename T>
+constexpr T EliminationDeterminant(S21FixedMatrix<N, N, T> a) {
+  T determinant = 1;
+  for (int k = 0; k < N; k++) {
+    int pivot = k;
+    for (int i = k + 1; i < N; i++)
+      if (Abs(a.at_unchecked(i, k)) > Abs(a.at_unchecked(pivot, k))) pivot = i;
+    if (a.at_unchecked(pivot, k) == T(0)) return T(0);
+    if (pivot != k) {
+      for (int j = k; j < N; j++) {
+        T swapped = a.at_unchecked(k, j);
+        a.at_unchecked(k, j) = a.at_unchecked(pivot, j);
+        a.at_unchecked(pivot, j) = swapped;
+      }
+      determinant = -determinant;
+    }
+    determinant *= a.at_unchecked(k, k);
+    for (int i = k + 1; i < N; i++) {
+      T factor = a.at_unchecked(i, k) / a.at_unchecked(k, k);
+      for (int j = k + 1; j < N; j++)
+        a.at_unchecked(i, j) -= factor * a.at_unchecked(k, j);
+    }
+  }
+  return determinant;
+}
+
+// Gauss-Jordan with partial pivoting, for N > 4; the caller has already
+// rejected singular matrices.
+template <int N, typename T>
+constexpr S21FixedMatrix<N, N, T> EliminationInverse(
+    S21FixedMatrix<N, N, T> a) {
+  S21FixedMatrix<N, N, T> x = S21FixedMatrix<N, N, T>::Identity();
+  for (int k = 0; k < N; k++) {
+    int pivot = k;
+    for (int i = k + 1; i < N; i++)
+      if (Abs(a.at_unchecked(i, k)) > Abs(a.at_unchecked(pivot, k))) pivot = i;
+    for (int j = 0; j < N; j++) {
+      T swapped = a.at_unchecked(k, j);
+      a.at_unchecked(k, j) = a.at_unchecked(pivot, j);
+      a.at_unchecked(pivot, j) = swapped;
+      swapped = x.at_unchecked(k, j);
+      x.at_unchecked(k, j) = x.at_unchecked(pivot, j);
+      x.at_unchecked(pivot, j) = swapped;
+    }
+    T diagonal = a.at_unchecked(k, k);
+    for (int j = 0; j < N; j++) {
+      a.at_unchecked(k, j) /= diagonal;
+      x.at_unchecked(k, j) /= diagonal;
+    }
+    for (int i = 0; i < N; i++) {
+      T factor = a.at_unchecked(i, k);
+      if (i == k || factor == T(0)) continue;
+      for (int j = 0; j < N; j++) {
+        a.at_unchecked(i, j) -= factor * a.at_unchecked(k, j);
+        x.at_unchecked(i, j) -= factor * x.at_unchecked(k, j);
+      }
+    }
+  }
+  return x;
+}
+
+// 2x2 minors of the top (s) and bottom (c) row pairs of a 4x4 matrix; the
+// determinant and the adjugate are both sums of their products.
+template <typename T>
+struct Minors4 {
+  T s0, s1, s2, s3, s4, s5;
+  T c0, c1, c2, c3, c4, c5;
+
+  constexpr explicit Minors4(const S21FixedMatrix<4, 4, T>& m)
+      : s0(m.at_unchecked(0, 0) * m.at_unchecked(1, 1) -
+           m.at_unchecked(1, 0) * m.at_unchecked(0, 1)),
+        s1(m.at_unchecked(0, 0) * m.at_unchecked(1, 2) -
+           m.at_unchecked(1, 0) * m.at_unchecked(0, 2)),
+        s2(m.at_unchecked(0, 0) * m.at_unchecked(1, 3) -
+           m.at_unchecked(1, 0) * m.at_unchecked(0, 3)),
+        s3(m.at_unchecked(0, 1) * m.at_unchecked(1, 2) -
+           m.at_unchecked(1, 1) * m.at_unchecked(0, 2)),
+        s4(m.at_unchecked(0, 1) * m.at_unchecked(1, 3) -
+           m.at_unchecked(1, 1) * m.at_unchecked(0, 3)),
+        s5(m.at_unchecked(0, 2) * m.at_unchecked(1, 3) -
+           m.at_unchecked(1, 2) * m.at_unchecked(0, 3)),
+        c0(m.at_unchecked(2, 0) * m.at_unchecked(3, 1) -
+           m.at_unchecked(3, 0) * m.at_unchecked(2, 1)),
+        c1(m.at_unchecked(2, 0) * m.at_unchecked(3, 2) -
+           m.at_unchecked(3, 0) * m.at_unchecked(2, 2)),
+        c2(m.at_unchecked(2, 0) * m.at_unchecked(3, 3) -
+           m.at_unchecked(3, 0) * m.at_unchecked(2, 3)),
+        c3(m.at_unchecked(2, 1) * m.at_unchecked(3, 2) -
+           m.at_unchecked(3, 1) * m.at_unchecked(2, 2)),
+        c4(m.at_unchecked(2, 1) * m.at_unchecked(3, 3) -
+           m.at_unchecked(3, 1) * m.at_unchecked(2, 3)),
+        c5(m.at_unchecked(2, 2) * m.at_unchecked(3, 3) -
+           m.at_unchecked(3, 2) * m.at_unchecked(2, 3)) {}
+
+  constexpr T Determinant() const {
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+  }
+};
+
+}  // namespace s21_fixed_internal
+
+template <int R, int C, typename T>
+constexpr T S21FixedMatrix<R, C, T>::Determinant() const {
+  static_assert(R == C, "The matrix is not square");
+  const S21FixedMatrix& a = *this;
+  if constexpr (R == 1) {
+    return a.at_unchecked(0, 0);
+  } else if constexpr (R == 2) {
+    return a.at_unchecked(0, 0) * a.at_unchecked(1, 1) -
+           a.at_unchecked(0, 1) * a.at_unchecked(1, 0);
+  } else if constexpr (R == 3) {
+    auto at = [&](int i, int j) { return a.at_unchecked(i, j); };
+    return at(0, 0) * (at(1, 1) * at(2, 2) - at(1, 2) * at(2, 1)) -
+           at(0, 1) * (at(1, 0) * at(2, 2) - at(1, 2) * at(2, 0)) +
+           at(0, 2) * (at(1, 0) * at(2, 1) - at(1, 1) * at(2, 0));
+  } else if constexpr (R == 4) {
+    return s21_fixed_internal::Minors4<T>(a).Determinant();
+  } else {
+    return s21_fixed_internal::EliminationDeterminant(a);
+  }
+}
+
+template <int R, int C, typename T>
+constexpr S21FixedMatrix<R, C, T> S21FixedMatrix<R, C, T>::CalcComplements()
+    const {
+  static_assert(R == C, "The matrix is not square");
+  S21FixedMatrix result;
+  if constexpr (R == 1) {
+    if (s21_fixed_internal::Abs(at_unchecked(0, 0)) <
+        S21MatrixTraits<T>::kEpsilon)
+      throw std::logic_error(
+          "A first-order null matrix does not have an algebraic complement "
+          "matrix");
+    result.at_unchecked(0, 0) = 1;
+  } else {
+    s21_fixed_internal::For<R>([&](auto i) {
+      s21_fixed_internal::For<C>([&](auto j) {
+        T determinant = s21_fixed_internal::Minor(*this, i, j).Determinant();
+        result.at_unchecked(i, j) = (i + j) % 2 ? -determinant : determinant;
+      });
+    });
+  }
+  return result;
+}
+
+template <int R, int C, typename T>
+constexpr S21FixedMatrix<R, C, T> S21FixedMatrix<R, C, T>::InverseMatrix()
+    const {
+  static_assert(R == C, "The matrix is not square");
+  const S21FixedMatrix& a = *this;
+  S21FixedMatrix result;
+  T determinant = 0;
+  if constexpr (R == 4) {
+    s21_fixed_internal::Minors4<T> m(a);
+    determinant = m.Determinant();
+    if (s21_fixed_internal::Abs(determinant) < S21MatrixTraits<T>::kEpsilon)
+      throw std::invalid_argument("The determinant of the matrix is 0");
+    auto at = [&](int i, int j) { return a.at_unchecked(i, j); };
+    result = S21FixedMatrix(
+        at(1, 1) * m.c5 - at(1, 2) * m.c4 + at(1, 3) * m.c3,
+        -at(0, 1) * m.c5 + at(0, 2) * m.c4 - at(0, 3) * m.c3,
+        at(3, 1) * m.s5 - at(3, 2) * m.s4 + at(3, 3) * m.s3,
+        -at(2, 1) * m.s5 + at(2, 2) * m.s4 - at(2, 3) * m.s3,
+        -at(1, 0) * m.c5 + at(1, 2) * m.c2 - at(1, 3) * m.c1,
+        at(0, 0) * m.c5 - at(0, 2) * m.c2 + at(0, 3) * m.c1,
+        -at(3, 0) * m.s5 + at(3, 2) * m.s2 - at(3, 3) * m.s1,
+        at(2, 0) * m.s5 - at(2, 2) * m.s2 + at(2, 3) * m.s1,
+        at(1, 0) * m.c4 - at(1, 1) * m.c2 + at(1, 3) * m.c0,
+        -at(0, 0) * m.c4 + at(0, 1) * m.c2 - at(0, 3) * m.c0,
+        at(3, 0) * m.s4 - at(3, 1) * m.s2 + at(3, 3) * m.s0,
+        -at(2, 0) * m.s4 + at(2, 1) * m.s2 - at(2, 3) * m.s0,
+        -at(1, 0) * m.c3 + at(1, 1) * m.c1 - at(1, 2) * m.c0,
+        at(0, 0) * m.c3 - at(0, 1) * m.c1 + at(0, 2) * m.c0,
+        -at(3, 0) * m.s3 + at(3, 1) * m.s1 - at(3, 2) * m.s0,
+        at(2, 0) * m.s3 - at(2, 1) * m.s1 + at(2, 2) * m.s0);
+  } else {
+    determinant = Determinant();
+    if (s21_fixed_internal::Abs(determinant) < S21MatrixTraits<T>::kEpsilon)
+      throw std::invalid_argument("The determinant of the matrix is 0");
+    if constexpr (R == 1) {
+      result.at_unchecked(0, 0) = 1;
+    } else if constexpr (R <= 3) {
+      // Adjugate: the transposed matrix of complements.
+      result = CalcComplements().Transpose();
+    } else {
+      return s21_fixed_internal::EliminationInverse(a);
+    }
+  }
+  result.MulNumber(T(1) / determinant);
+  return result;
+}
+
+using S21Matrix3 = S21FixedMatrix<3, 3>;
+using S21Matrix4 = S21FixedMatrix<4, 4>;
+
+#endif  // SRC_S21_FIXED_MATRIX_H_
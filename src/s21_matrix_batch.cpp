@@ -0,0 +1,380 @@
+#include "s21_matrix_batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+#include "s21_matrix_simd.h"
+#include "s21_thread_pool.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_BATCH_X86 1
+#else
+#define S21_BATCH_X86 0
+#endif
+
+// Kernels and their helpers are inlined into each instruction set wrapper
+// below, so the loops over the lanes get compiled once per level.
+#define S21_BATCH_INLINE __attribute__((always_inline)) inline
+
+namespace {
+
+// Matrices handled together: a block of 8x8 double scratch stays in L2 and
+// the runs are long enough for any vector width.
+constexpr int kBlock = 64;
+
+// Cell (r, c) of a block of scratch matrices that are width columns wide;
+// each cell holds kBlock lanes.
+template <typename T>
+S21_BATCH_INLINE T* Cell(T* work, int width, int r, int c) {
+  return work + ((std::size_t)r * width + c) * kBlock;
+}
+
+// Partial pivoting, lane by lane: pivot[l] becomes the row (as T) of the
+// largest |value| in column k of lane l, at or below row k.
+template <typename T>
+S21_BATCH_INLINE void SelectPivots(T* work, int width, int n, int k, int lanes,
+                                   T* best, T* pivot) {
+  const T* column = Cell(work, width, k, k);
+  for (int l = 0; l < lanes; l++) {
+    best[l] = std::abs(column[l]);
+    pivot[l] = T(k);
+  }
+  for (int r = k + 1; r < n; r++) {
+    const T* value = Cell(work, width, r, k);
+    for (int l = 0; l < lanes; l++) {
+      T magnitude = std::abs(value[l]);
+      bool larger = magnitude > best[l];
+      best[l] = larger ? magnitude : best[l];
+      pivot[l] = larger ? T(r) : pivot[l];
+    }
+  }
+}
+
+// Swaps row k with row pivot[l] in every lane, from column k on. Written
+// as selects over all candidate rows so that it stays branch-free.
+template <typename T>
+S21_BATCH_INLINE void SwapPivotRows(T* work, int width, int n, int k,
+                                    int lanes, const T* pivot) {
+  for (int r = k + 1; r < n; r++) {
+    for (int j = k; j < width; j++) {
+      T* x = Cell(work, width, k, j);
+      T* y = Cell(work, width, r, j);
+      for (int l = 0; l < lanes; l++) {
+        bool swap = pivot[l] == T(r);
+        T a = x[l];
+        T b = y[l];
+        x[l] = swap ? b : a;
+        y[l] = swap ? a : b;
+      }
+    }
+  }
+}
+
+template <typename T>
+struct MulKernel {
+  const T* a;
+  int a_stride;
+  const T* b;
+  int b_stride;
+  T* c;
+  int c_stride;
+  int rows;
+  int inner;
+  int cols;
+
+  S21_BATCH_INLINE void Run(long first, long last) const {
+    for (long b0 = first; b0 < last; b0 += kBlock) {
+      int lanes = (int)std::min<long>(kBlock, last - b0);
+      for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+          T sum[kBlock] = {};
+          for (int p = 0; p < inner; p++) {
+            const T* x = a + (std::size_t)(i * inner + p) * a_stride + b0;
+            const T* y = b + (std::size_t)(p * cols + j) * b_stride + b0;
+            for (int l = 0; l < lanes; l++) sum[l] += x[l] * y[l];
+          }
+          std::memcpy(c + (std::size_t)(i * cols + j) * c_stride + b0, sum,
+                      lanes * sizeof(T));
+        }
+      }
+    }
+  }
+};
+
+template <typename T>
+struct TransposeKernel {
+  const T* a;
+  int a_stride;
+  T* c;
+  int c_stride;
+  int rows;
+  int cols;
+
+  S21_BATCH_INLINE void Run(long first, long last) const {
+    for (int i = 0; i < rows; i++)
+      for (int j = 0; j < cols; j++)
+        std::memcpy(c + (std::size_t)(j * rows + i) * c_stride + first,
+                    a + (std::size_t)(i * cols + j) * a_stride + first,
+                    (last - first) * sizeof(T));
+  }
+};
+
+// Gaussian elimination with partial pivoting in every lane.
+template <typename T>
+struct DeterminantKernel {
+  const T* a;
+  int a_stride;
+  T* result;
+  int n;
+
+  S21_BATCH_INLINE void Run(long first, long last) const {
+    std::vector<T> scratch(((std::size_t)n * n + 4) * kBlock);
+    T* work = scratch.data();
+    T* best = work + (std::size_t)n * n * kBlock;
+    T* pivot = best + kBlock;
+    T* factor = pivot + kBlock;
+    T* det = factor + kBlock;
+    for (long b0 = first; b0 < last; b0 += kBlock) {
+      int lanes = (int)std::min<long>(kBlock, last - b0);
+      for (int e = 0; e < n * n; e++)
+        std::memcpy(work + (std::size_t)e * kBlock,
+                    a + (std::size_t)e * a_stride + b0, lanes * sizeof(T));
+      for (int l = 0; l < lanes; l++) det[l] = T(1);
+
+      for (int k = 0; k < n; k++) {
+        SelectPivots(work, n, n, k, lanes, best, pivot);
+        SwapPivotRows(work, n, n, k, lanes, pivot);
+        const T* diagonal = Cell(work, n, k, k);
+        for (int l = 0; l < lanes; l++) {
+          T value = diagonal[l];
+          det[l] *= pivot[l] == T(k) ? value : -value;
+          factor[l] = value != T(0) ? T(1) / value : T(0);
+        }
+        for (int r = k + 1; r < n; r++) {
+          T* row_k = Cell(work, n, k, 0);
+          T* row_r = Cell(work, n, r, 0);
+          for (int l = 0; l < lanes; l++)
+            best[l] = row_r[k * kBlock + l] * factor[l];
+          for (int j = k + 1; j < n; j++)
+            for (int l = 0; l < lanes; l++)
+              row_r[j * kBlock + l] -= best[l] * row_k[j * kBlock + l];
+        }
+      }
+      std::memcpy(result + b0, det, lanes * sizeof(T));
+    }
+  }
+};
+
+// Gauss-Jordan elimination of [A | I] with partial pivoting in every lane.
+// The product of the pivots is the determinant, and a lane is singular by
+// the test of S21Matrix::InverseMatrix, |det| < kEpsilon.
+template <typename T>
+struct InverseKernel {
+  const T* a;
+  int a_stride;
+  T* c;
+  int c_stride;
+  int n;
+  std::atomic<bool>* singular;
+
+  S21_BATCH_INLINE void Run(long first, long last) const {
+    int width = 2 * n;
+    std::vector<T> scratch(((std::size_t)n * width + 4) * kBlock);
+    T* work = scratch.data();
+    T* best = work + (std::size_t)n * width * kBlock;
+    T* pivot = best + kBlock;
+    T* factor = pivot + kBlock;
+    T* det = factor + kBlock;
+    for (long b0 = first; b0 < last; b0 += kBlock) {
+      int lanes = (int)std::min<long>(kBlock, last - b0);
+      for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+          std::memcpy(Cell(work, width, i, j),
+                      a + (std::size_t)(i * n + j) * a_stride + b0,
+                      lanes * sizeof(T));
+          T* identity = Cell(work, width, i, n + j);
+          for (int l = 0; l < lanes; l++) identity[l] = T(i == j);
+        }
+      }
+      for (int l = 0; l < lanes; l++) det[l] = T(1);
+
+      for (int k = 0; k < n; k++) {
+        SelectPivots(work, width, n, k, lanes, best, pivot);
+        SwapPivotRows(work, width, n, k, lanes, pivot);
+        T* row_k = Cell(work, width, k, 0);
+        for (int l = 0; l < lanes; l++) {
+          T value = row_k[k * kBlock + l];
+          det[l] *= pivot[l] == T(k) ? value : -value;
+          factor[l] = value != T(0) ? T(1) / value : T(0);
+        }
+        for (int j = k; j < width; j++)
+          for (int l = 0; l < lanes; l++) row_k[j * kBlock + l] *= factor[l];
+        for (int r = 0; r < n; r++) {
+          if (r == k) continue;
+          T* row_r = Cell(work, width, r, 0);
+          for (int l = 0; l < lanes; l++) best[l] = row_r[k * kBlock + l];
+          for (int j = k; j < width; j++)
+            for (int l = 0; l < lanes; l++)
+              row_r[j * kBlock + l] -= best[l] * row_k[j * kBlock + l];
+        }
+      }
+
+      T smallest = std::abs(det[0]);
+      for (int l = 1; l < lanes; l++)
+        smallest = std::min(smallest, std::abs(det[l]));
+      if (smallest < S21MatrixTraits<T>::kEpsilon)
+        singular->store(true, std::memory_order_relaxed);
+      for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+          std::memcpy(c + (std::size_t)(i * n + j) * c_stride + b0,
+                      Cell(work, width, i, n + j), lanes * sizeof(T));
+    }
+  }
+};
+
+template <typename Kernel>
+void RunPortable(const Kernel& kernel, long first, long last) {
+  kernel.Run(first, last);
+}
+
+#if S21_BATCH_X86
+template <typename Kernel>
+__attribute__((target("avx2,fma"))) void RunAvx2(const Kernel& kernel,
+                                                 long first, long last) {
+  kernel.Run(first, last);
+}
+#endif
+
+// Runs kernel over the count matrices, in ranges spread across the thread
+// pool once count * work (scalar operations per matrix) is large enough,
+// with the AVX2 build of the kernel when the active SIMD level allows it.
+template <typename T, typename Kernel>
+void RunBatch(int count, long work, const Kernel& kernel) {
+  auto body = [&kernel](long first, long last) {
+#if S21_BATCH_X86
+    if (!std::is_same<T, long double>::value &&
+        S21GetSimdLevel() >= S21SimdLevel::kAvx2) {
+      RunAvx2(kernel, first, last);
+      return;
+    }
+#endif
+    RunPortable(kernel, first, last);
+  };
+  if ((long)count * work < kS21SerialCutoff) {
+    body(0, count);
+  } else {
+    long grain = std::max<long>(kBlock, kS21SerialCutoff / 4 / work);
+    S21ThreadPool::Instance().ParallelFor(0, count, grain, body);
+  }
+}
+
+}  // namespace
+
+template <typename T>
+S21BasicMatrixBatch<T>::S21BasicMatrixBatch(int count, int rows, int cols)
+    : rows_(rows),
+      cols_(cols),
+      lanes_(rows > 0 && cols > 0 ? rows * cols : 0, count) {}
+
+template <typename T>
+void S21BasicMatrixBatch<T>::checkIndex(int index, int i, int j) const {
+  if (index < 0 || index >= getCount() || i < 0 || i >= rows_ || j < 0 ||
+      j >= cols_)
+    throw std::invalid_argument("Index out of range");
+}
+
+template <typename T>
+T& S21BasicMatrixBatch<T>::operator()(int index, int i, int j) {
+  checkIndex(index, i, j);
+  return Lanes(i, j)[index];
+}
+
+template <typename T>
+const T& S21BasicMatrixBatch<T>::operator()(int index, int i, int j) const {
+  checkIndex(index, i, j);
+  return Lanes(i, j)[index];
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrixBatch<T>::Get(int index) const {
+  checkIndex(index, 0, 0);
+  S21BasicMatrix<T> matrix(rows_, cols_);
+  for (int i = 0; i < rows_; i++)
+    for (int j = 0; j < cols_; j++)
+      matrix.at_unchecked(i, j) = Lanes(i, j)[index];
+  return matrix;
+}
+
+template <typename T>
+void S21BasicMatrixBatch<T>::Set(int index, const S21BasicMatrix<T>& matrix) {
+  checkIndex(index, 0, 0);
+  if (matrix.getRows() != rows_ || matrix.getCols() != cols_)
+    throw std::invalid_argument("Different dimension of matrices");
+  for (int i = 0; i < rows_; i++)
+    for (int j = 0; j < cols_; j++)
+      Lanes(i, j)[index] = matrix.at_unchecked(i, j);
+}
+
+template <typename T>
+bool S21BasicMatrixBatch<T>::EqMatrix(const S21BasicMatrixBatch& other) const {
+  return rows_ == other.rows_ && cols_ == other.cols_ &&
+         lanes_.EqMatrix(other.lanes_);
+}
+
+template <typename T>
+void S21BasicMatrixBatch<T>::MulMatrix(const S21BasicMatrixBatch& other) {
+  if (cols_ != other.rows_)
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the number "
+        "of rows of the second matrix");
+  if (getCount() != other.getCount())
+    throw std::invalid_argument("Different number of matrices");
+  S21BasicMatrixBatch result(getCount(), rows_, other.cols_);
+  MulKernel<T> kernel{lanes_.data(),          lanes_.stride(),
+                      other.lanes_.data(),    other.lanes_.stride(),
+                      result.lanes_.data(),   result.lanes_.stride(),
+                      rows_,                  cols_,
+                      other.cols_};
+  RunBatch<T>(getCount(), 2L * rows_ * cols_ * other.cols_, kernel);
+  *this = std::move(result);
+}
+
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::Transpose() const {
+  S21BasicMatrixBatch result(getCount(), cols_, rows_);
+  TransposeKernel<T> kernel{lanes_.data(),        lanes_.stride(),
+                            result.lanes_.data(), result.lanes_.stride(),
+                            rows_,                cols_};
+  RunBatch<T>(getCount(), (long)rows_ * cols_, kernel);
+  return result;
+}
+
+template <typename T>
+std::vector<T> S21BasicMatrixBatch<T>::Determinant() const {
+  if (rows_ != cols_) throw std::invalid_argument("The matrix is not square");
+  std::vector<T> result(getCount());
+  DeterminantKernel<T> kernel{lanes_.data(), lanes_.stride(), result.data(),
+                              rows_};
+  RunBatch<T>(getCount(), 2L * rows_ * rows_ * rows_, kernel);
+  return result;
+}
+
+template <typename T>
+S21BasicMatrixBatch<T> S21BasicMatrixBatch<T>::InverseMatrix() const {
+  if (rows_ != cols_) throw std::invalid_argument("The matrix is not square");
+  S21BasicMatrixBatch result(getCount(), rows_, cols_);
+  std::atomic<bool> singular(false);
+  InverseKernel<T> kernel{lanes_.data(),        lanes_.stride(),
+                          result.lanes_.data(), result.lanes_.stride(),
+                          rows_,                &singular};
+  RunBatch<T>(getCount(), 6L * rows_ * rows_ * rows_, kernel);
+  if (singular.load()) throw std::invalid_argument("The matrix is singular");
+  return result;
+}
+
+template class S21BasicMatrixBatch<float>;
+template class S21BasicMatrixBatch<double>;
+template class S21BasicMatrixBatch<long double>;
@@ -0,0 +1,63 @@
+#ifndef SRC_S21_MATRIX_BATCH_H_
+#define SRC_S21_MATRIX_BATCH_H_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// count matrices of one shape stored interleaved (structure of arrays):
+// element (i, j) of all of them is one contiguous run of count values. The
+// batched operations therefore handle one matrix per vector lane and split
+// the batch across the thread pool, which is what many tiny matrices (2x2
+// to 8x8) need instead of one S21Matrix call each.
+template <typename T>
+class S21BasicMatrixBatch {
+ public:
+  using value_type = T;
+
+  // count zero matrices of rows x cols.
+  S21BasicMatrixBatch(int count, int rows, int cols);
+
+  int getCount() const noexcept { return lanes_.getCols(); }
+  int getRows() const noexcept { return rows_; }
+  int getCols() const noexcept { return cols_; }
+
+  // Element (i, j) of matrix index.
+  T& operator()(int index, int i, int j);
+  const T& operator()(int index, int i, int j) const;
+  S21BasicMatrix<T> Get(int index) const;
+  void Set(int index, const S21BasicMatrix<T>& matrix);
+
+  // The count values of element (i, j), matrix by matrix.
+  T* Lanes(int i, int j) noexcept {
+    return lanes_.data() + (std::size_t)(i * cols_ + j) * lanes_.stride();
+  }
+  const T* Lanes(int i, int j) const noexcept {
+    return lanes_.data() + (std::size_t)(i * cols_ + j) * lanes_.stride();
+  }
+
+  bool EqMatrix(const S21BasicMatrixBatch& other) const;
+  // Matrix k becomes matrix k times matrix k of other.
+  void MulMatrix(const S21BasicMatrixBatch& other);
+  S21BasicMatrixBatch Transpose() const;
+  std::vector<T> Determinant() const;
+  // Throws if any of the matrices is singular.
+  S21BasicMatrixBatch InverseMatrix() const;
+
+ private:
+  void checkIndex(int index, int i, int j) const;
+
+  int rows_;
+  int cols_;
+  // Row i * cols_ + j holds element (i, j) of every matrix.
+  S21BasicMatrix<T> lanes_;
+};
+
+extern template class S21BasicMatrixBatch<float>;
+extern template class S21BasicMatrixBatch<double>;
+extern template class S21BasicMatrixBatch<long double>;
+
+using S21MatrixBatch = S21BasicMatrixBatch<double>;
+using S21MatrixBatchF = S21BasicMatrixBatch<float>;
+
+#endif  // SRC_S21_MATRIX_BATCH_H_
@@ -0,0 +1,268 @@
+#include "s21_matrix_blas.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <stdexcept>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_stats.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+template <typename T>
+using View = S21BasicMatrixView<T>;
+
+// Boundaries of the runs of [0, n) that map to consecutive elements: a
+// skipped index s (-1 for none) starts a new run at s. Run r is
+// [bounds[r], bounds[r + 1]) for r + 1 < size.
+struct Runs {
+  std::array<int, 4> bounds;
+  int size;
+
+  Runs(int n, int skip, int other_skip) : bounds(), size(0) {
+    int low = std::min(skip, other_skip), high = std::max(skip, other_skip);
+    bounds[size++] = 0;
+    if (low > 0 && low < n) bounds[size++] = low;
+    if (high > 0 && high < n && high != low) bounds[size++] = high;
+    bounds[size++] = n;
+  }
+};
+
+// Runs body(first_row, last_row) over [0, rows) like S21ParallelRows, but
+// without copying body into a std::function: below kS21SerialCutoff
+// elements nothing is allocated.
+template <typename Body>
+void ParallelRows(int rows, int cols, const Body& body) {
+  if ((long)rows * cols < kS21SerialCutoff) {
+    body(0L, (long)rows);
+  } else {
+    long grain = std::max(1L, kS21SerialCutoff / 4 / cols);
+    S21ThreadPool::Instance().ParallelFor(0, rows, grain, std::cref(body));
+  }
+}
+
+template <typename T>
+bool HasSkips(const View<T>& view) {
+  return view.getSkippedRow() >= 0 || view.getSkippedCol() >= 0;
+}
+
+// Throws if any element of out lies between the first and the last element
+// of in. Views are rectangles of a buffer, so this is cheap and only errs on
+// the safe side for interleaved views such as two different columns.
+template <typename T>
+void CheckDisjoint(const View<T>& out, const View<const T>& in) {
+  auto bounds = [](const auto& view) {
+    const void* corners[] = {
+        &view.at_unchecked(0, 0),
+        &view.at_unchecked(view.getRows() - 1, 0),
+        &view.at_unchecked(0, view.getCols() - 1),
+        &view.at_unchecked(view.getRows() - 1, view.getCols() - 1)};
+    auto less = std::less<const void*>();
+    return std::make_pair(*std::min_element(corners, corners + 4, less),
+                          *std::max_element(corners, corners + 4, less));
+  };
+  auto out_bounds = bounds(out);
+  auto in_bounds = bounds(in);
+  auto less = std::less<const void*>();
+  if (!less(out_bounds.second, in_bounds.first) &&
+      !less(in_bounds.second, out_bounds.first))
+    throw std::invalid_argument("The result overlaps an operand");
+}
+
+// A view with one row or one column as a 1 x n row.
+template <typename T>
+View<T> AsRow(const View<T>& vector, int length) {
+  if (vector.getRows() == 1 && vector.getCols() == length) return vector;
+  if (vector.getCols() == 1 && vector.getRows() == length)
+    return vector.Transpose();
+  throw std::invalid_argument("Different dimension of matrices");
+}
+
+template <typename T>
+T Dot(int n, const T* x, const T* y, std::ptrdiff_t y_stride) {
+  if (y_stride != 1) {
+    T sum = 0;
+    for (int p = 0; p < n; p++) sum += x[p] * y[p * y_stride];
+    return sum;
+  }
+  // Independent partial sums, since the compiler may not reorder a single
+  // floating-point reduction.
+  T sums[4] = {0, 0, 0, 0};
+  int p = 0;
+  for (; p + 4 <= n; p += 4)
+    for (int q = 0; q < 4; q++) sums[q] += x[p + q] * y[p + q];
+  for (; p < n; p++) sums[0] += x[p] * y[p];
+  return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+// out = alpha * lhs * rhs + beta * out for an out with rows of unit stride,
+// as up to eight pieces of consecutive elements when views skip a row or a
+// column.
+template <typename T>
+void GemmPieces(T alpha, const View<const T>& lhs, const View<const T>& rhs,
+                T beta, const View<T>& out) {
+  Runs row_runs(out.getRows(), lhs.getSkippedRow(), out.getSkippedRow());
+  Runs inner_runs(lhs.getCols(), lhs.getSkippedCol(), rhs.getSkippedRow());
+  Runs col_runs(out.getCols(), rhs.getSkippedCol(), out.getSkippedCol());
+  const std::array<int, 4>& rows = row_runs.bounds;
+  const std::array<int, 4>& inner = inner_runs.bounds;
+  const std::array<int, 4>& cols = col_runs.bounds;
+  S21MulAlgorithm algorithm = S21GetMulAlgorithm();
+  for (int r = 0; r + 1 < row_runs.size; r++) {
+    for (int q = 0; q + 1 < col_runs.size; q++) {
+      for (int p = 0; p + 1 < inner_runs.size; p++) {
+        S21GemmWith(algorithm, rows[r + 1] - rows[r], cols[q + 1] - cols[q],
+                    inner[p + 1] - inner[p], alpha,
+                    &lhs.at_unchecked(rows[r], inner[p]), lhs.getRowStride(),
+                    lhs.getColStride(), &rhs.at_unchecked(inner[p], cols[q]),
+                    rhs.getRowStride(), rhs.getColStride(),
+                    p == 0 ? beta : T(1), &out.at_unchecked(rows[r], cols[q]),
+                    out.getRowStride());
+      }
+    }
+  }
+}
+
+}  // namespace
+
+template <typename T>
+void S21GemmViews(T alpha, const View<const T>& a, S21Op op_a,
+                  const View<const T>& b, S21Op op_b, T beta,
+                  const View<T>& c) {
+  View<const T> lhs = op_a == S21Op::kTrans ? a.Transpose() : a;
+  View<const T> rhs = op_b == S21Op::kTrans ? b.Transpose() : b;
+  if (lhs.getCols() != rhs.getRows())
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the number "
+        "of rows of the second matrix");
+  if (c.getRows() != lhs.getRows() || c.getCols() != rhs.getCols())
+    throw std::invalid_argument("Different dimension of matrices");
+  CheckDisjoint(c, lhs);
+  CheckDisjoint(c, rhs);
+  S21_STAT_SCOPE(S21StatOp::kGemm,
+                 2 * (std::uint64_t)c.getRows() * c.getCols() * lhs.getCols(),
+                 0);
+  if (c.getColStride() == 1) {
+    GemmPieces(alpha, lhs, rhs, beta, c);
+  } else if (c.getRowStride() == 1) {
+    // A transposed result: C^T = op(B)^T * op(A)^T has unit-stride rows.
+    GemmPieces(alpha, rhs.Transpose(), lhs.Transpose(), beta, c.Transpose());
+  } else {
+    throw std::invalid_argument("The result has no unit stride");
+  }
+}
+
+template <typename T>
+void S21GemvViews(T alpha, const View<const T>& a, S21Op op_a,
+                  const View<const T>& x, T beta, const View<T>& y) {
+  View<const T> matrix = op_a == S21Op::kTrans ? a.Transpose() : a;
+  int m = matrix.getRows(), k = matrix.getCols();
+  View<const T> x_row = AsRow(x, k);
+  View<T> y_row = AsRow(y, m);
+  CheckDisjoint(y_row, matrix);
+  CheckDisjoint(y_row, x_row);
+  S21_STAT_SCOPE(S21StatOp::kGemv, 2 * (std::uint64_t)m * k, 0);
+  auto start = [beta](T& element) {
+    element = beta == T(0) ? T(0) : beta * element;
+  };
+
+  if (HasSkips(matrix) || HasSkips(x_row) || HasSkips(y_row)) {
+    ParallelRows(m, k, [&](long first, long last) {
+      for (long i = first; i < last; i++) {
+        T sum = 0;
+        for (int p = 0; p < k; p++)
+          sum += matrix.at_unchecked((int)i, p) * x_row.at_unchecked(0, p);
+        T& element = y_row.at_unchecked(0, (int)i);
+        start(element);
+        element += alpha * sum;
+      }
+    });
+    return;
+  }
+  const T* data = matrix.data();
+  std::ptrdiff_t rs = matrix.getRowStride(), cs = matrix.getColStride();
+  const T* xd = x_row.data();
+  std::ptrdiff_t xs = x_row.getColStride();
+  T* yd = y_row.data();
+  std::ptrdiff_t ys = y_row.getColStride();
+  if (cs == 1) {
+    // Rows of op(A) are contiguous: a dot product per element of y.
+    ParallelRows(m, k, [&](long first, long last) {
+      for (long i = first; i < last; i++) {
+        T& element = yd[i * ys];
+        start(element);
+        element += alpha * Dot(k, data + i * rs, xd, xs);
+      }
+    });
+  } else {
+    // Columns of op(A) are the contiguous ones (A transposed): each range of
+    // y accumulates alpha * x[p] times the matching part of column p.
+    ParallelRows(m, k, [&](long first, long last) {
+      for (long i = first; i < last; i++) start(yd[i * ys]);
+      for (int p = 0; p < k; p++) {
+        T factor = alpha * xd[p * xs];
+        const T* column = data + p * cs;
+        for (long i = first; i < last; i++)
+          yd[i * ys] += factor * column[i * rs];
+      }
+    });
+  }
+}
+
+template <typename T>
+void S21GerViews(T alpha, const View<const T>& x, const View<const T>& y,
+                 const View<T>& a) {
+  int m = a.getRows(), n = a.getCols();
+  View<const T> x_row = AsRow(x, m);
+  View<const T> y_row = AsRow(y, n);
+  CheckDisjoint(a, x_row);
+  CheckDisjoint(a, y_row);
+  S21_STAT_SCOPE(S21StatOp::kGer, 2 * (std::uint64_t)m * n, 0);
+  if (HasSkips(a) || HasSkips(y_row) || a.getColStride() != 1 ||
+      y_row.getColStride() != 1) {
+    ParallelRows(m, n, [&](long first, long last) {
+      for (long i = first; i < last; i++) {
+        T factor = alpha * x_row.at_unchecked(0, (int)i);
+        for (int j = 0; j < n; j++)
+          a.at_unchecked((int)i, j) += factor * y_row.at_unchecked(0, j);
+      }
+    });
+    return;
+  }
+  const T* yd = y_row.data();
+  ParallelRows(m, n, [&](long first, long last) {
+    for (long i = first; i < last; i++) {
+      T factor = alpha * x_row.at_unchecked(0, (int)i);
+      T* row = a.data() + i * a.getRowStride();
+      for (int j = 0; j < n; j++) row[j] += factor * yd[j];
+    }
+  });
+}
+
+template void S21GemmViews(float, const View<const float>&, S21Op,
+                           const View<const float>&, S21Op, float,
+                           const View<float>&);
+template void S21GemmViews(double, const View<const double>&, S21Op,
+                           const View<const double>&, S21Op, double,
+                           const View<double>&);
+template void S21GemmViews(long double, const View<const long double>&,
+                           S21Op, const View<const long double>&, S21Op,
+                           long double, const View<long double>&);
+template void S21GemvViews(float, const View<const float>&, S21Op,
+                           const View<const float>&, float,
+                           const View<float>&);
+template void S21GemvViews(double, const View<const double>&, S21Op,
+                           const View<const double>&, double,
+                           const View<double>&);
+template void S21GemvViews(long double, const View<const long double>&,
+                           S21Op, const View<const long double>&,
+                           long double, const View<long double>&);
+template void S21GerViews(float, const View<const float>&,
+                          const View<const float>&, const View<float>&);
+template void S21GerViews(double, const View<const double>&,
+                          const View<const double>&, const View<double>&);
+template void S21GerViews(long double, const View<const long double>&,
+                          const View<const long double>&,
+                          const View<long double>&);
@@ -0,0 +1,76 @@
+#ifndef SRC_S21_MATRIX_BLAS_H_
+#define SRC_S21_MATRIX_BLAS_H_
+
+#include <type_traits>
+
+#include "s21_matrix_oop.h"
+
+// Whether an operand is used as it is or transposed.
+enum class S21Op { kNoTrans, kTrans };
+
+// BLAS-style updates that write into an existing matrix or view instead of
+// returning a new matrix, so loops built from them allocate nothing past the
+// first calls, which size the packing buffers of each thread and the thread
+// pool's task queues. The exception is the kStrassen algorithm above
+// S21GetStrassenCrossover(), which allocates scratch space on every call.
+// Operands are matrices or views (s21_matrix_view.h), vectors are ones with
+// a single row or column. The result must not share elements with the
+// operands; dimension mismatches and overlaps throw std::invalid_argument.
+// As in BLAS, beta == 0 ignores the previous contents of the result, NaNs
+// included.
+
+// C = alpha * op(A) * op(B) + beta * C, through S21GemmWith with the
+// S21GetMulAlgorithm() algorithm.
+template <typename T>
+void S21GemmViews(T alpha, const S21BasicMatrixView<const T>& a, S21Op op_a,
+                  const S21BasicMatrixView<const T>& b, S21Op op_b, T beta,
+                  const S21BasicMatrixView<T>& c);
+// y = alpha * op(A) * x + beta * y, one pass over A.
+template <typename T>
+void S21GemvViews(T alpha, const S21BasicMatrixView<const T>& a, S21Op op_a,
+                  const S21BasicMatrixView<const T>& x, T beta,
+                  const S21BasicMatrixView<T>& y);
+// A = A + alpha * x * y^T.
+template <typename T>
+void S21GerViews(T alpha, const S21BasicMatrixView<const T>& x,
+                 const S21BasicMatrixView<const T>& y,
+                 const S21BasicMatrixView<T>& a);
+
+// Writable view of a result.
+template <typename T>
+S21BasicMatrixView<T> S21MutableViewOf(S21BasicMatrix<T>& matrix) {
+  return matrix.view();
+}
+
+template <typename T>
+S21BasicMatrixView<T> S21MutableViewOf(const S21BasicMatrixView<T>& view) {
+  return view;
+}
+
+template <typename Result>
+using S21ElementOf = typename std::remove_reference_t<Result>::value_type;
+
+// The same for any mix of matrices and views, e.g.
+//   S21Gemm(1.0, A, S21Op::kTrans, B.block(0, 0, k, n), S21Op::kNoTrans,
+//           0.0, C);
+template <typename A, typename B, typename C>
+void S21Gemm(S21ElementOf<C> alpha, const A& a, S21Op op_a, const B& b,
+             S21Op op_b, S21ElementOf<C> beta, C&& c) {
+  S21GemmViews<S21ElementOf<C>>(alpha, S21ViewOf(a), op_a, S21ViewOf(b),
+                                op_b, beta, S21MutableViewOf(c));
+}
+
+template <typename A, typename X, typename Y>
+void S21Gemv(S21ElementOf<Y> alpha, const A& a, S21Op op_a, const X& x,
+             S21ElementOf<Y> beta, Y&& y) {
+  S21GemvViews<S21ElementOf<Y>>(alpha, S21ViewOf(a), op_a, S21ViewOf(x),
+                                beta, S21MutableViewOf(y));
+}
+
+template <typename X, typename Y, typename A>
+void S21Ger(S21ElementOf<A> alpha, const X& x, const Y& y, A&& a) {
+  S21GerViews<S21ElementOf<A>>(alpha, S21ViewOf(x), S21ViewOf(y),
+                               S21MutableViewOf(a));
+}
+
+#endif  // SRC_S21_MATRIX_BLAS_H_
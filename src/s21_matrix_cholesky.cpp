@@ -0,0 +1,120 @@
+#include "s21_matrix_oop.h"
+
+#include <cmath>
+
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Same split as the LU solves: right-hand side columns are independent.
+template <typename Body>
+void ForColumnRanges(int n, int columns, Body body) {
+  if ((long)n * n * columns < kS21SerialCutoff) {
+    body(0L, (long)columns);
+  } else {
+    S21ThreadPool::Instance().ParallelFor(0, columns, 8, body);
+  }
+}
+
+// Dot product with four partial sums, which lets the loop vectorize.
+template <typename T>
+T Dot(int n, const T* a, const T* b) {
+  T sums[4] = {};
+  int k = 0;
+  for (; k + 4 <= n; k += 4)
+    for (int s = 0; s < 4; s++) sums[s] += a[k + s] * b[k + s];
+  for (; k < n; k++) sums[0] += a[k] * b[k];
+  return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+}  // namespace
+
+// Row by row: L(i, j) = (A(i, j) - L(i, :j) . L(j, :j)) / L(j, j), so every
+// inner product runs over two contiguous row prefixes.
+template <typename T>
+S21BasicMatrixCholesky<T>::S21BasicMatrixCholesky(
+    const S21BasicMatrix<T>& matrix)
+    : l_(matrix.getRows(), matrix.getCols()) {
+  if (matrix.getRows() != matrix.getCols())
+    throw std::invalid_argument("The matrix is not square");
+
+  int n = getSize();
+  int stride = l_.stride();
+  T* l = l_.data();
+  for (int i = 0; i < n; i++) {
+    T* l_i = l + (std::size_t)i * stride;
+    for (int j = 0; j < i; j++) {
+      const T* l_j = l + (std::size_t)j * stride;
+      l_i[j] = (matrix.at_unchecked(i, j) - Dot(j, l_i, l_j)) / l_j[j];
+    }
+    T diagonal = matrix.at_unchecked(i, i) - Dot(i, l_i, l_i);
+    if (!(diagonal > T(0)))
+      throw std::invalid_argument("The matrix is not positive definite");
+    l_i[i] = std::sqrt(diagonal);
+  }
+}
+
+template <typename T>
+int S21BasicMatrixCholesky<T>::getSize() const {
+  return l_.getRows();
+}
+
+template <typename T>
+T S21BasicMatrixCholesky<T>::Determinant() const {
+  T determinant = 1;
+  for (int i = 0; i < getSize(); i++) {
+    T diagonal = l_.at_unchecked(i, i);
+    determinant *= diagonal * diagonal;
+  }
+  return determinant;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrixCholesky<T>::Solve(
+    const S21BasicMatrix<T>& b) const {
+  if (b.getRows() != getSize())
+    throw std::invalid_argument(
+        "The number of rows of the right-hand side is not equal to the size "
+        "of the matrix");
+
+  int n = getSize();
+  S21BasicMatrix<T> x(b);
+  T* xd = x.data();
+  int xs = x.stride();
+  const T* l = l_.data();
+  int ls = l_.stride();
+
+  // L * y = b row by row, then L^T * x = y: row i of L holds column i of
+  // L^T, so the back substitution scatters x_i into the rows above it.
+  ForColumnRanges(n, b.getCols(), [&](long first, long last) {
+    for (int i = 0; i < n; i++) {
+      T* x_i = xd + (std::size_t)i * xs;
+      const T* l_i = l + (std::size_t)i * ls;
+      for (int k = 0; k < i; k++) {
+        const T* x_k = xd + (std::size_t)k * xs;
+        for (long j = first; j < last; j++) x_i[j] -= l_i[k] * x_k[j];
+      }
+      for (long j = first; j < last; j++) x_i[j] /= l_i[i];
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+      T* x_i = xd + (std::size_t)i * xs;
+      const T* l_i = l + (std::size_t)i * ls;
+      for (long j = first; j < last; j++) x_i[j] /= l_i[i];
+      for (int k = 0; k < i; k++) {
+        T* x_k = xd + (std::size_t)k * xs;
+        for (long j = first; j < last; j++) x_k[j] -= l_i[k] * x_i[j];
+      }
+    }
+  });
+  return x;
+}
+
+template <typename T>
+const S21BasicMatrix<T>& S21BasicMatrixCholesky<T>::getL() const {
+  return l_;
+}
+
+template class S21BasicMatrixCholesky<float>;
+template class S21BasicMatrixCholesky<double>;
+template class S21BasicMatrixCholesky<long double>;
@@ -0,0 +1,216 @@
+#ifndef SRC_S21_MATRIX_EXPR_H_
+#define SRC_S21_MATRIX_EXPR_H_
+
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+// Lazy element-wise arithmetic. operator+, operator-, scalar * and / and
+// S21MulElements build a tree of lightweight nodes instead of matrices; the
+// tree is evaluated element by element in a single pass when it is assigned
+// to (or used to construct) a matrix, so `D = A + B - C * 2.0` allocates
+// nothing besides D itself. Dimension mismatches still throw eagerly, at the
+// operator that combines the mismatched operands.
+//
+// Nodes refer to matrices by pointer: an expression must be consumed within
+// the full-expression that created it when any operand is a temporary (do
+// not store `auto e = A * B + C;` for later).
+
+template <typename T>
+class S21BasicMatrix;
+
+// CRTP base of every expression, S21BasicMatrix included. Every node also
+// names its element type as value_type; operands of one node must agree on
+// it (there are no implicit float <-> double promotions).
+template <typename Derived>
+class S21MatrixExpr {
+ public:
+  const Derived& derived() const { return static_cast<const Derived&>(*this); }
+};
+
+// Leaf node: a read-only view of a matrix buffer.
+template <typename T>
+class S21MatrixLeaf : public S21MatrixExpr<S21MatrixLeaf<T>> {
+ public:
+  using value_type = T;
+
+  template <typename Matrix>
+  explicit S21MatrixLeaf(const Matrix& matrix)
+      : data_(matrix.data()),
+        stride_(matrix.stride()),
+        rows_(matrix.getRows()),
+        cols_(matrix.getCols()) {}
+
+  int getRows() const { return rows_; }
+  int getCols() const { return cols_; }
+  T Coeff(int i, int j) const { return data_[(std::size_t)i * stride_ + j]; }
+  // Whether assigning to target element by element could change what this
+  // node reads later (see S21BasicMatrixView::Conflicts).
+  template <typename View>
+  bool Conflicts(const View& target) const {
+    return View(data_, rows_, cols_, stride_).Conflicts(target);
+  }
+
+ private:
+  const T* data_;
+  int stride_;
+  int rows_;
+  int cols_;
+};
+
+// How a node holds an operand: matrices through a leaf, nodes by value.
+template <typename T>
+struct S21ExprOperand {
+  using type = T;
+};
+
+template <typename T>
+struct S21ExprOperand<S21BasicMatrix<T>> {
+  using type = S21MatrixLeaf<T>;
+};
+
+struct S21ExprPlus {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return lhs + rhs;
+  }
+};
+
+struct S21ExprMinus {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return lhs - rhs;
+  }
+};
+
+struct S21ExprTimes {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return lhs * rhs;
+  }
+};
+
+struct S21ExprDivide {
+  template <typename T>
+  static T Apply(T lhs, T rhs) {
+    return lhs / rhs;
+  }
+};
+
+// Op for assignments that discards the old value.
+struct S21ExprAssign {
+  template <typename T>
+  static T Apply(T, T rhs) {
+    return rhs;
+  }
+};
+
+template <typename Op, typename Lhs, typename Rhs>
+class S21MatrixBinaryExpr
+    : public S21MatrixExpr<S21MatrixBinaryExpr<Op, Lhs, Rhs>> {
+ public:
+  using value_type = typename Lhs::value_type;
+  static_assert(std::is_same<value_type, typename Rhs::value_type>::value,
+                "Operands of different element types");
+
+  S21MatrixBinaryExpr(const Lhs& lhs, const Rhs& rhs) : lhs_(lhs), rhs_(rhs) {
+    if (lhs_.getRows() != rhs_.getRows() || lhs_.getCols() != rhs_.getCols())
+      throw std::invalid_argument("Different dimension of matrices");
+  }
+
+  int getRows() const { return lhs_.getRows(); }
+  int getCols() const { return lhs_.getCols(); }
+  value_type Coeff(int i, int j) const {
+    return Op::Apply(lhs_.Coeff(i, j), rhs_.Coeff(i, j));
+  }
+  template <typename View>
+  bool Conflicts(const View& target) const {
+    return lhs_.Conflicts(target) || rhs_.Conflicts(target);
+  }
+
+ private:
+  typename S21ExprOperand<Lhs>::type lhs_;
+  typename S21ExprOperand<Rhs>::type rhs_;
+};
+
+// Element-wise op between an expression and a scalar (expr op scalar).
+template <typename Op, typename Expr>
+class S21MatrixScalarExpr
+    : public S21MatrixExpr<S21MatrixScalarExpr<Op, Expr>> {
+ public:
+  using value_type = typename Expr::value_type;
+
+  S21MatrixScalarExpr(const Expr& expr, value_type scalar)
+      : expr_(expr), scalar_(scalar) {}
+
+  int getRows() const { return expr_.getRows(); }
+  int getCols() const { return expr_.getCols(); }
+  value_type Coeff(int i, int j) const {
+    return Op::Apply(expr_.Coeff(i, j), scalar_);
+  }
+  template <typename View>
+  bool Conflicts(const View& target) const {
+    return expr_.Conflicts(target);
+  }
+
+ private:
+  typename S21ExprOperand<Expr>::type expr_;
+  value_type scalar_;
+};
+
+template <typename Lhs, typename Rhs>
+S21MatrixBinaryExpr<S21ExprPlus, Lhs, Rhs> operator+(
+    const S21MatrixExpr<Lhs>& lhs, const S21MatrixExpr<Rhs>& rhs) {
+  return S21MatrixBinaryExpr<S21ExprPlus, Lhs, Rhs>(lhs.derived(),
+                                                    rhs.derived());
+}
+
+template <typename Lhs, typename Rhs>
+S21MatrixBinaryExpr<S21ExprMinus, Lhs, Rhs> operator-(
+    const S21MatrixExpr<Lhs>& lhs, const S21MatrixExpr<Rhs>& rhs) {
+  return S21MatrixBinaryExpr<S21ExprMinus, Lhs, Rhs>(lhs.derived(),
+                                                     rhs.derived());
+}
+
+// Hadamard (element-wise) product.
+template <typename Lhs, typename Rhs>
+S21MatrixBinaryExpr<S21ExprTimes, Lhs, Rhs> S21MulElements(
+    const S21MatrixExpr<Lhs>& lhs, const S21MatrixExpr<Rhs>& rhs) {
+  return S21MatrixBinaryExpr<S21ExprTimes, Lhs, Rhs>(lhs.derived(),
+                                                     rhs.derived());
+}
+
+// The scalar takes the element type of the expression, so `A * 2` works
+// for every element type.
+template <typename Expr>
+S21MatrixScalarExpr<S21ExprTimes, Expr> operator*(
+    const S21MatrixExpr<Expr>& expr, typename Expr::value_type multiplier) {
+  return S21MatrixScalarExpr<S21ExprTimes, Expr>(expr.derived(), multiplier);
+}
+
+template <typename Expr>
+S21MatrixScalarExpr<S21ExprTimes, Expr> operator*(
+    typename Expr::value_type multiplier, const S21MatrixExpr<Expr>& expr) {
+  return S21MatrixScalarExpr<S21ExprTimes, Expr>(expr.derived(), multiplier);
+}
+
+template <typename Expr>
+S21MatrixScalarExpr<S21ExprDivide, Expr> operator/(
+    const S21MatrixExpr<Expr>& expr, typename Expr::value_type divisor) {
+  return S21MatrixScalarExpr<S21ExprDivide, Expr>(expr.derived(), divisor);
+}
+
+template <typename Expr>
+S21MatrixScalarExpr<S21ExprTimes, Expr> operator-(
+    const S21MatrixExpr<Expr>& expr) {
+  using T = typename Expr::value_type;
+  return S21MatrixScalarExpr<S21ExprTimes, Expr>(expr.derived(), T(-1));
+}
+
+// Runs body(first_row, last_row) over [0, rows), on the library thread pool
+// when the matrix is large enough. Used to evaluate expressions.
+void S21ParallelRows(int rows, int cols,
+                     const std::function<void(long, long)>& body);
+
+#endif  // SRC_S21_MATRIX_EXPR_H_
@@ -0,0 +1,370 @@
+#include "s21_matrix_gemm.h"
+
+#include <algorithm>
+#include <climits>
+#include <deque>
+#include <functional>
+#include <new>
+#include <stdexcept>
+
+#include "s21_matrix_simd.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+constexpr std::size_t kPackAlignment = 64;
+
+// Products below this volume are not worth splitting across threads.
+constexpr long long kParallelVolume = 96LL * 96 * 96;
+
+// Sizes are picked so that the packed A block (mc * kc doubles) fits in a
+// 256 KiB L2 and a kc x nr sliver of B (kc * nr doubles) stays well inside a
+// 32 KiB L1. AVX-512 parts ship with at least 1 MiB of L2, hence the larger
+// mc there, while its 16-wide sliver needs a shallower kc.
+const S21GemmTuning kGemmTuningNarrow[] = {
+    {128, {64, 128, 256}},
+    {1024, {96, 256, 2048}},
+    {INT_MAX, {96, 256, 4096}},
+};
+
+const S21GemmTuning kGemmTuningAvx2[] = {
+    {128, {72, 128, 256}},
+    {1024, {96, 256, 2048}},
+    {INT_MAX, {120, 256, 4096}},
+};
+
+const S21GemmTuning kGemmTuningAvx512[] = {
+    {128, {64, 128, 256}},
+    {1024, {128, 192, 2048}},
+    {INT_MAX, {256, 192, 4096}},
+};
+
+bool blocking_overridden = false;
+S21GemmBlocking blocking_override = {0, 0, 0};
+
+// Grow-only aligned scratch space for packed panels, kept per thread.
+template <typename T>
+class PackBuffer {
+ public:
+  PackBuffer() : data_(nullptr), size_(0) {}
+  PackBuffer(const PackBuffer&) = delete;
+  PackBuffer& operator=(const PackBuffer&) = delete;
+  ~PackBuffer() { release(); }
+
+  T* reserve(std::size_t size) {
+    if (size > size_) {
+      release();
+      data_ = static_cast<T*>(::operator new(
+          size * sizeof(T), std::align_val_t(kPackAlignment)));
+      size_ = size;
+    }
+    return data_;
+  }
+
+ private:
+  void release() {
+    if (data_ != nullptr)
+      ::operator delete(data_, std::align_val_t(kPackAlignment));
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  T* data_;
+  std::size_t size_;
+};
+
+// Function-local rather than variable templates: GCC does not run the
+// destructors of thread_local variable templates at thread exit.
+template <typename T>
+PackBuffer<T>& PackedA() {
+  thread_local PackBuffer<T> buffer;
+  return buffer;
+}
+
+// Packed B panels of the GEMMs running on this thread, by nesting depth: a
+// parallel call waiting for its tasks may run a task that starts another
+// GEMM, which must not overwrite the panel the waiting call's tasks read.
+// std::deque keeps the buffers in place as it grows.
+template <typename T>
+PackBuffer<T>& PackedB(int depth) {
+  thread_local std::deque<PackBuffer<T>> buffers;
+  while ((int)buffers.size() <= depth) buffers.emplace_back();
+  return buffers[depth];
+}
+
+// Parallel GEMMs in progress on this thread.
+thread_local int gemm_depth = 0;
+
+// Marks a parallel GEMM in progress for as long as it is alive.
+class GemmDepthScope {
+ public:
+  GemmDepthScope() { gemm_depth++; }
+  GemmDepthScope(const GemmDepthScope&) = delete;
+  GemmDepthScope& operator=(const GemmDepthScope&) = delete;
+  ~GemmDepthScope() { gemm_depth--; }
+};
+
+int RoundUp(int value, int multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+// Packs an mc x kc block of A into row panels of mr rows. Inside a panel the
+// mr values of one column are adjacent, which is the order the micro-kernel
+// consumes them. alpha is folded in here so the kernel does not have to
+// multiply by it. Rows past mc are padded with zeros.
+template <typename T>
+void PackA(int mc, int kc, int mr, T alpha, const T* a, std::ptrdiff_t rs,
+           std::ptrdiff_t cs, T* packed) {
+  for (int ir = 0; ir < mc; ir += mr) {
+    int rows = std::min(mr, mc - ir);
+    for (int p = 0; p < kc; p++) {
+      const T* src = a + ir * rs + p * cs;
+      int i = 0;
+      for (; i < rows; i++) packed[i] = alpha * src[i * rs];
+      for (; i < mr; i++) packed[i] = 0.0;
+      packed += mr;
+    }
+  }
+}
+
+// Packs a kc x nc panel of B into column slivers of nr columns with the nr
+// values of one row adjacent. Columns past nc are zero.
+template <typename T>
+void PackB(int kc, int nc, int nr, const T* b, std::ptrdiff_t rs,
+           std::ptrdiff_t cs, T* packed) {
+  for (int jr = 0; jr < nc; jr += nr) {
+    int cols = std::min(nr, nc - jr);
+    for (int p = 0; p < kc; p++) {
+      const T* src = b + p * rs + jr * cs;
+      int j = 0;
+      if (cs == 1) {
+        std::copy(src, src + cols, packed);
+        j = cols;
+      }
+      for (; j < cols; j++) packed[j] = src[j * cs];
+      for (; j < nr; j++) packed[j] = 0.0;
+      packed += nr;
+    }
+  }
+}
+
+// Runs the dispatched micro-kernel on one mr x nr tile and merges the
+// rows x cols part that lies inside C.
+template <typename T>
+void MicroTile(const S21SimdKernels<T>& kernels, int kc, const T* a,
+               const T* b, int rows, int cols, T beta, T* c,
+               std::ptrdiff_t c_rs) {
+  alignas(64) T ab[kS21GemmMaxTile];
+  kernels.gemm_kernel(kc, a, b, ab);
+
+  int nr = kernels.gemm_nr;
+  for (int i = 0; i < rows; i++) {
+    T* c_i = c + i * c_rs;
+    const T* ab_i = ab + i * nr;
+    if (beta == 0.0) {
+      for (int j = 0; j < cols; j++) c_i[j] = ab_i[j];
+    } else if (beta == 1.0) {
+      for (int j = 0; j < cols; j++) c_i[j] += ab_i[j];
+    } else {
+      for (int j = 0; j < cols; j++) c_i[j] = beta * c_i[j] + ab_i[j];
+    }
+  }
+}
+
+// One packed kc x nc panel of B together with the matching column slab of
+// A (starting at column pc) and row slab of C (starting at column jc).
+template <typename T>
+struct PanelJob {
+  const S21SimdKernels<T>* kernels;
+  int kc;
+  int nc;
+  T alpha;
+  const T* a;
+  std::ptrdiff_t a_row_stride;
+  std::ptrdiff_t a_col_stride;
+  const T* b_panel;
+  T beta;
+  T* c;
+  std::ptrdiff_t c_row_stride;
+};
+
+// Packs rows [ic, ic + mc) of the A slab and multiplies them with the
+// slivers of the panel covering columns [j_begin, j_end).
+template <typename T>
+void MacroKernel(const PanelJob<T>& job, int ic, int mc, int j_begin,
+                 int j_end) {
+  int mr = job.kernels->gemm_mr;
+  int nr = job.kernels->gemm_nr;
+  int kc = job.kc;
+  T* a_panel = PackedA<T>().reserve((std::size_t)RoundUp(mc, mr) * kc);
+  PackA(mc, kc, mr, job.alpha, job.a + ic * job.a_row_stride,
+        job.a_row_stride, job.a_col_stride, a_panel);
+
+  for (int jr = j_begin; jr < j_end; jr += nr) {
+    int cols = std::min(nr, j_end - jr);
+    const T* b_sliver = job.b_panel + (std::size_t)jr * kc;
+    for (int ir = 0; ir < mc; ir += mr) {
+      int rows = std::min(mr, mc - ir);
+      MicroTile(*job.kernels, kc, a_panel + (std::size_t)ir * kc, b_sliver,
+                rows, cols, job.beta,
+                job.c + (ic + ir) * job.c_row_stride + jr, job.c_row_stride);
+    }
+  }
+}
+
+template <typename T>
+void ScaleC(int m, int n, T beta, T* c, std::ptrdiff_t c_rs) {
+  for (int i = 0; i < m; i++) {
+    T* c_i = c + i * c_rs;
+    if (beta == 0.0) {
+      std::fill(c_i, c_i + n, T(0));
+    } else if (beta != 1.0) {
+      for (int j = 0; j < n; j++) c_i[j] *= beta;
+    }
+  }
+}
+
+// Unpacked i-k-j loop for products too small to amortize packing.
+template <typename T>
+void SmallGemm(int m, int n, int k, T alpha, const T* a, std::ptrdiff_t a_rs,
+               std::ptrdiff_t a_cs, const T* b, std::ptrdiff_t b_rs,
+               std::ptrdiff_t b_cs, T beta, T* c, std::ptrdiff_t c_rs) {
+  ScaleC(m, n, beta, c, c_rs);
+  for (int i = 0; i < m; i++) {
+    T* c_i = c + i * c_rs;
+    for (int p = 0; p < k; p++) {
+      T a_ip = alpha * a[i * a_rs + p * a_cs];
+      const T* b_p = b + p * b_rs;
+      if (b_cs == 1) {
+        for (int j = 0; j < n; j++) c_i[j] += a_ip * b_p[j];
+      } else {
+        for (int j = 0; j < n; j++) c_i[j] += a_ip * b_p[j * b_cs];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+S21GemmBlocking S21GetGemmBlocking(int m, int n, int k) {
+  if (blocking_overridden) return blocking_override;
+
+  const S21GemmTuning* table = kGemmTuningNarrow;
+  switch (S21GetSimdLevel()) {
+    case S21SimdLevel::kAvx512:
+      table = kGemmTuningAvx512;
+      break;
+    case S21SimdLevel::kAvx2:
+      table = kGemmTuningAvx2;
+      break;
+    default:
+      break;
+  }
+
+  int max_dim = std::max(m, std::max(n, k));
+  while (max_dim > table->max_dim) table++;
+  return table->blocking;
+}
+
+void S21SetGemmBlocking(const S21GemmBlocking& blocking) {
+  if (blocking.mc <= 0 || blocking.kc <= 0 || blocking.nc <= 0)
+    throw std::invalid_argument("GEMM block sizes must be positive");
+  blocking_override = blocking;
+  blocking_overridden = true;
+}
+
+void S21ResetGemmBlocking() { blocking_overridden = false; }
+
+template <typename T>
+void S21GemmStrided(int m, int n, int k, T alpha, const T* a,
+                    std::ptrdiff_t a_row_stride, std::ptrdiff_t a_col_stride,
+                    const T* b, std::ptrdiff_t b_row_stride,
+                    std::ptrdiff_t b_col_stride, T beta, T* c,
+                    std::ptrdiff_t c_row_stride) {
+  if (m <= 0 || n <= 0) return;
+  if (k <= 0 || alpha == 0.0) {
+    ScaleC(m, n, beta, c, c_row_stride);
+    return;
+  }
+  if ((long long)m * n * k < kS21GemmSmallVolume) {
+    SmallGemm(m, n, k, alpha, a, a_row_stride, a_col_stride, b, b_row_stride,
+              b_col_stride, beta, c, c_row_stride);
+    return;
+  }
+
+  const S21SimdKernels<T>& kernels = S21GetSimdKernels<T>();
+  int mr = kernels.gemm_mr;
+  int nr = kernels.gemm_nr;
+  S21GemmBlocking blocking = S21GetGemmBlocking(m, n, k);
+  int mc_max = RoundUp(std::min(blocking.mc, m), mr);
+  // The table is sized for doubles; keep the panels at the same bytes.
+  int kc_max = std::min(
+      std::max(1, (int)(blocking.kc * sizeof(double) / sizeof(T))), k);
+  int nc_max = RoundUp(std::min(blocking.nc, n), nr);
+
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  bool parallel = pool.getThreadCount() > 1 &&
+                  (long long)m * n * k >= kParallelVolume;
+  T* b_panel = PackedB<T>(gemm_depth).reserve((std::size_t)kc_max * nc_max);
+  GemmDepthScope depth_scope;
+
+  for (int jc = 0; jc < n; jc += nc_max) {
+    int nc = std::min(nc_max, n - jc);
+    for (int pc = 0; pc < k; pc += kc_max) {
+      int kc = std::min(kc_max, k - pc);
+      PackB(kc, nc, nr, b + pc * b_row_stride + jc * b_col_stride, b_row_stride,
+            b_col_stride, b_panel);
+      PanelJob<T> job = {&kernels,
+                      kc,
+                      nc,
+                      alpha,
+                      a + pc * a_col_stride,
+                      a_row_stride,
+                      a_col_stride,
+                      b_panel,
+                      pc == 0 ? beta : T(1),
+                      c + jc,
+                      c_row_stride};
+
+      int row_blocks = (m + mc_max - 1) / mc_max;
+      if (!parallel) {
+        for (int block = 0; block < row_blocks; block++) {
+          int ic = block * mc_max;
+          MacroKernel(job, ic, std::min(mc_max, m - ic), 0, nc);
+        }
+      } else {
+        // Row blocks alone may not keep every thread busy, so each of them
+        // is also split into column ranges made of whole nr slivers.
+        int slivers = (nc + nr - 1) / nr;
+        int splits = (2 * pool.getThreadCount() + row_blocks - 1) / row_blocks;
+        splits = std::max(1, std::min(splits, slivers));
+        auto body = [&](long first, long last) {
+          for (long task = first; task < last; task++) {
+            int ic = (int)(task / splits) * mc_max;
+            int split = (int)(task % splits);
+            int j_begin = (int)((long)slivers * split / splits) * nr;
+            int j_end =
+                std::min(nc, (int)((long)slivers * (split + 1) / splits) * nr);
+            MacroKernel(job, ic, std::min(mc_max, m - ic), j_begin, j_end);
+          }
+        };
+        pool.ParallelFor(0, (long)row_blocks * splits, 1, std::cref(body));
+      }
+    }
+  }
+}
+
+template void S21GemmStrided<float>(int, int, int, float, const float*,
+                                    std::ptrdiff_t, std::ptrdiff_t,
+                                    const float*, std::ptrdiff_t,
+                                    std::ptrdiff_t, float, float*,
+                                    std::ptrdiff_t);
+template void S21GemmStrided<double>(int, int, int, double, const double*,
+                                     std::ptrdiff_t, std::ptrdiff_t,
+                                     const double*, std::ptrdiff_t,
+                                     std::ptrdiff_t, double, double*,
+                                     std::ptrdiff_t);
+template void S21GemmStrided<long double>(
+    int, int, int, long double, const long double*, std::ptrdiff_t,
+    std::ptrdiff_t, const long double*, std::ptrdiff_t, std::ptrdiff_t,
+    long double, long double*, std::ptrdiff_t);
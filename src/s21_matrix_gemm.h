@@ -0,0 +1,102 @@
+#ifndef SRC_S21_MATRIX_GEMM_H_
+#define SRC_S21_MATRIX_GEMM_H_
+
+#include <cstddef>
+
+// Block sizes of the packed GEMM. An mc x kc block of A is packed to stay
+// resident in L2, kc x nr slivers of the packed kc x nc panel of B stream
+// through L1, and the micro-kernel keeps an mr x nr tile of C in registers.
+struct S21GemmBlocking {
+  int mc;
+  int kc;
+  int nc;
+};
+
+// One row of the tuning table: problems whose largest dimension does not
+// exceed max_dim use this blocking. Each SIMD level has its own table since
+// the register tile (mr x nr) of its micro-kernel differs; mc and nc are
+// rounded up to multiples of mr and nr when used.
+struct S21GemmTuning {
+  int max_dim;
+  S21GemmBlocking blocking;
+};
+
+// Products with m * n * k below this use a plain loop instead of packing.
+constexpr long long kS21GemmSmallVolume = 32 * 32 * 32;
+
+S21GemmBlocking S21GetGemmBlocking(int m, int n, int k);
+// Overrides the tuning table for every following call (not thread-safe with
+// respect to multiplications running concurrently).
+void S21SetGemmBlocking(const S21GemmBlocking& blocking);
+void S21ResetGemmBlocking();
+
+// C = alpha * A * B + beta * C where A is m x k, B is k x n and C is m x n.
+// Element (i, j) of each operand lives at base[i * row_stride + j *
+// col_stride], so transposed and strided operands need no copies. C must
+// not alias A or B. With beta == 0 the previous contents of C are ignored.
+// Instantiated for float, double and long double.
+template <typename T>
+void S21GemmStrided(int m, int n, int k, T alpha, const T* a,
+                    std::ptrdiff_t a_row_stride, std::ptrdiff_t a_col_stride,
+                    const T* b, std::ptrdiff_t b_row_stride,
+                    std::ptrdiff_t b_col_stride, T beta, T* c,
+                    std::ptrdiff_t c_row_stride);
+
+// Algorithm of a matrix product.
+enum class S21MulAlgorithm {
+  // The packed GEMM of S21GemmStrided: O(m * n * k).
+  kClassic,
+  // Strassen-Winograd recursion on top of it, see S21GemmStrassen.
+  kStrassen
+};
+
+constexpr int kS21DefaultStrassenCrossover = 1024;
+
+// Algorithm of the products that do not name one (operator*, MulMatrix
+// without an algorithm, products of views), kClassic unless changed, and
+// the crossover S21GemmWith hands to S21GemmStrassen. Both are atomic, but
+// a product already running keeps the values it started with.
+void S21SetMulAlgorithm(S21MulAlgorithm algorithm);
+S21MulAlgorithm S21GetMulAlgorithm();
+void S21SetStrassenCrossover(int crossover);
+int S21GetStrassenCrossover();
+
+// Same contract as S21GemmStrided, computed with the Winograd variant of
+// Strassen's algorithm: each level splits the operands in half along every
+// dimension and forms the product from 7 half-size products and 15
+// additions instead of 8 products, for O(n^2.81) operations. Products whose
+// smallest dimension is below crossover go to S21GemmStrided, odd rows and
+// columns are peeled off and finished by it as well. With more than one
+// thread the first level runs its 7 products as parallel tasks, holding all
+// of their operand sums: scratch of about the size of A, B and 3/4 of C.
+// Deeper levels, and every level on one thread, run the products one after
+// another (each one parallel inside) with two quarter-size scratch
+// operands, for scratch of about a third of A and B in total.
+//
+// The error is bounded normwise, not per element: with u the unit roundoff
+// and the max norm |X| = max |x_ij|, for n x n operands and l levels down
+// to size n0 = n / 2^l (Higham, Accuracy and Stability of Numerical
+// Algorithms, 2nd ed., section 23.2.2)
+//   |C - fl(C)| <= ((n0^2 + 6 * n0) * 18^l - 6 * n) * u * |A| * |B|
+// to first order, against n * u * |A| * |B| for the classic product (whose
+// bound even holds elementwise with |A| * |B| taken elementwise). Halving
+// the crossover multiplies the bound by about 18 / 4 = 4.5: with n = 8192
+// and n0 = 1024 a product of doubles stays within about 1e-6 * |A| * |B|,
+// fine for well-scaled data, but elements much smaller than |A| * |B| lose
+// their relative accuracy.
+template <typename T>
+void S21GemmStrassen(int m, int n, int k, T alpha, const T* a,
+                     std::ptrdiff_t a_row_stride, std::ptrdiff_t a_col_stride,
+                     const T* b, std::ptrdiff_t b_row_stride,
+                     std::ptrdiff_t b_col_stride, T beta, T* c,
+                     std::ptrdiff_t c_row_stride, int crossover);
+
+// S21GemmStrided or S21GemmStrassen with S21GetStrassenCrossover().
+template <typename T>
+void S21GemmWith(S21MulAlgorithm algorithm, int m, int n, int k, T alpha,
+                 const T* a, std::ptrdiff_t a_row_stride,
+                 std::ptrdiff_t a_col_stride, const T* b,
+                 std::ptrdiff_t b_row_stride, std::ptrdiff_t b_col_stride,
+                 T beta, T* c, std::ptrdiff_t c_row_stride);
+
+#endif  // SRC_S21_MATRIX_GEMM_H_
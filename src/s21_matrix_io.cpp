@@ -0,0 +1,339 @@
+#include "s21_matrix_io.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+namespace {
+
+constexpr std::uint64_t kPrime1 = 11400714785074694791ULL;
+constexpr std::uint64_t kPrime2 = 14029467366897019727ULL;
+constexpr std::uint64_t kPrime3 = 1609587929392839161ULL;
+constexpr std::uint64_t kPrime4 = 9650029242287828579ULL;
+constexpr std::uint64_t kPrime5 = 2870177450012600261ULL;
+
+std::uint64_t Rotate(std::uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+std::uint64_t Round(std::uint64_t lane, std::uint64_t input) {
+  return Rotate(lane + input * kPrime2, 31) * kPrime1;
+}
+
+std::uint64_t Load64(const unsigned char* bytes) {
+  std::uint64_t value;
+  std::memcpy(&value, bytes, sizeof(value));
+  return value;
+}
+
+// Size of an element type on this host, 0 for unknown types.
+std::uint32_t ElementSize(S21ElementType type) {
+  switch (type) {
+    case S21ElementType::kFloat:
+      return sizeof(float);
+    case S21ElementType::kDouble:
+      return sizeof(double);
+    case S21ElementType::kLongDouble:
+      return sizeof(long double);
+  }
+  return 0;
+}
+
+void Fail(const std::string& what, const std::string& path) {
+  throw std::runtime_error(what + ": " + path);
+}
+
+// Everything a reader relies on, including that the payload fits in a file
+// of file_size bytes.
+void ValidateHeader(const S21BinaryHeader& header, std::uint64_t file_size,
+                    const std::string& path) {
+  if (std::memcmp(header.magic, S21BinaryHeader::kMagic, 8) != 0)
+    Fail("Not a matrix file", path);
+  if (header.version != S21BinaryHeader::kVersion)
+    Fail("Unsupported matrix file version", path);
+  if (header.byte_order != S21BinaryHeader::kByteOrder)
+    Fail("Matrix file has a different byte order", path);
+  std::uint32_t element_size = ElementSize(header.element_type);
+  if (element_size == 0 || element_size != header.element_size)
+    Fail("Unsupported element type in matrix file", path);
+  if (header.layout != S21MatrixLayout::kRowMajor &&
+      header.layout != S21MatrixLayout::kColMajor)
+    Fail("Unknown layout in matrix file", path);
+  if (header.rows == 0 || header.cols == 0 || header.rows > INT_MAX ||
+      header.cols > INT_MAX)
+    Fail("Unsupported matrix size in matrix file", path);
+  if (header.payload_offset < sizeof(S21BinaryHeader) ||
+      header.payload_offset % S21BasicMatrix<double>::kAlignment != 0 ||
+      header.payload_offset > file_size ||
+      (file_size - header.payload_offset) / element_size / header.rows <
+          header.cols)
+    Fail("Truncated matrix file", path);
+}
+
+S21BinaryHeader ReadHeader(std::ifstream& file, const std::string& path) {
+  if (!file) Fail("Cannot open", path);
+  file.seekg(0, std::ios::end);
+  std::uint64_t file_size = (std::uint64_t)file.tellg();
+  file.seekg(0);
+  S21BinaryHeader header;
+  if (file_size < sizeof(header) ||
+      !file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    Fail("Truncated matrix file", path);
+  ValidateHeader(header, file_size, path);
+  return header;
+}
+
+// Reads matrix.getRows() rows of elements stored as From.
+template <typename From, typename T>
+void ReadRows(std::ifstream& file, S21BasicMatrix<T>& matrix,
+              S21Checksum& checksum) {
+  int cols = matrix.getCols();
+  std::size_t bytes = (std::size_t)cols * sizeof(From);
+  std::vector<From> buffer(std::is_same<From, T>::value ? 0 : cols);
+  for (int i = 0; i < matrix.getRows(); i++) {
+    T* row = matrix.data() + (std::size_t)i * matrix.stride();
+    char* target = std::is_same<From, T>::value
+                       ? reinterpret_cast<char*>(row)
+                       : reinterpret_cast<char*>(buffer.data());
+    if (!file.read(target, bytes))
+      throw std::runtime_error("Truncated matrix file");
+    checksum.Update(target, bytes);
+    if (!std::is_same<From, T>::value)
+      for (int j = 0; j < cols; j++) row[j] = static_cast<T>(buffer[j]);
+  }
+}
+
+// Owns the buffers of mapped matrices: deallocating one unmaps its file.
+// A mapped matrix that gets resized by assignment allocates its new buffer
+// here as well, and those requests go to the heap.
+class MappedFileResource : public std::pmr::memory_resource {
+ public:
+  void Register(void* payload, void* base, std::size_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    mappings_[payload] = {base, length};
+  }
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    return S21HeapResource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* block, std::size_t bytes,
+                     std::size_t alignment) override {
+    std::pair<void*, std::size_t> mapping(nullptr, 0);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto found = mappings_.find(block);
+      if (found != mappings_.end()) {
+        mapping = found->second;
+        mappings_.erase(found);
+      }
+    }
+    if (mapping.first != nullptr)
+      munmap(mapping.first, mapping.second);
+    else
+      S21HeapResource()->deallocate(block, bytes, alignment);
+  }
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::mutex mutex_;
+  std::map<void*, std::pair<void*, std::size_t>> mappings_;
+};
+
+MappedFileResource& MappedFiles() {
+  static MappedFileResource resource;
+  return resource;
+}
+
+}  // namespace
+
+S21Checksum::S21Checksum()
+    : lanes_{kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1},
+      pending_(),
+      pending_size_(0),
+      total_(0) {}
+
+void S21Checksum::Stripe(const unsigned char* stripe) {
+  for (int lane = 0; lane < 4; lane++)
+    lanes_[lane] = Round(lanes_[lane], Load64(stripe + 8 * lane));
+}
+
+void S21Checksum::Update(const void* data, std::size_t size) {
+  const unsigned char* bytes = static_cast<const unsigned char*>(data);
+  total_ += size;
+  if (pending_size_ > 0) {
+    std::size_t take = std::min(size, sizeof(pending_) - pending_size_);
+    std::memcpy(pending_ + pending_size_, bytes, take);
+    pending_size_ += take;
+    bytes += take;
+    size -= take;
+    if (pending_size_ < sizeof(pending_)) return;
+    Stripe(pending_);
+    pending_size_ = 0;
+  }
+  for (; size >= sizeof(pending_); size -= sizeof(pending_)) {
+    Stripe(bytes);
+    bytes += sizeof(pending_);
+  }
+  std::memcpy(pending_, bytes, size);
+  pending_size_ = size;
+}
+
+std::uint64_t S21Checksum::Finish() const {
+  std::uint64_t hash = Rotate(lanes_[0], 1) + Rotate(lanes_[1], 7) +
+                       Rotate(lanes_[2], 12) + Rotate(lanes_[3], 18);
+  for (int lane = 0; lane < 4; lane++)
+    hash = (hash ^ Round(0, lanes_[lane])) * kPrime1 + kPrime4;
+  hash += total_;
+  std::size_t p = 0;
+  for (; p + 8 <= pending_size_; p += 8)
+    hash = Rotate(hash ^ Round(0, Load64(pending_ + p)), 27) * kPrime1 +
+           kPrime4;
+  for (; p < pending_size_; p++)
+    hash = Rotate(hash ^ (pending_[p] * kPrime5), 11) * kPrime1;
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  return hash ^ (hash >> 32);
+}
+
+S21BinaryHeader S21ReadBinaryHeader(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return ReadHeader(file, path);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::SaveBinary(const std::string& path) const {
+  S21BinaryHeader header = {};
+  std::memcpy(header.magic, S21BinaryHeader::kMagic, 8);
+  header.version = S21BinaryHeader::kVersion;
+  header.byte_order = S21BinaryHeader::kByteOrder;
+  header.rows = rows_;
+  header.cols = cols_;
+  header.element_type = S21ElementTypeOf<T>();
+  header.element_size = sizeof(T);
+  header.layout = S21MatrixLayout::kRowMajor;
+  header.payload_offset = sizeof(header);
+  std::size_t row_bytes = (std::size_t)cols_ * sizeof(T);
+  S21Checksum checksum;
+  for (int i = 0; i < rows_; i++)
+    checksum.Update(matrix_ + (std::size_t)i * stride(), row_bytes);
+  header.checksum = checksum.Finish();
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) Fail("Cannot open", path);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  for (int i = 0; i < rows_; i++) {
+    const T* row = matrix_ + (std::size_t)i * stride();
+    file.write(reinterpret_cast<const char*>(row), row_bytes);
+  }
+  file.close();
+  if (!file) Fail("Cannot write", path);
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::LoadBinary(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  S21BinaryHeader header = ReadHeader(file, path);
+  bool row_major = header.layout == S21MatrixLayout::kRowMajor;
+  // A column-major file is read as its transpose and transposed back.
+  S21BasicMatrix result(row_major ? (int)header.rows : (int)header.cols,
+                        row_major ? (int)header.cols : (int)header.rows);
+  file.seekg(header.payload_offset);
+  S21Checksum checksum;
+  try {
+    switch (header.element_type) {
+      case S21ElementType::kFloat:
+        ReadRows<float>(file, result, checksum);
+        break;
+      case S21ElementType::kDouble:
+        ReadRows<double>(file, result, checksum);
+        break;
+      case S21ElementType::kLongDouble:
+        ReadRows<long double>(file, result, checksum);
+        break;
+    }
+  } catch (const std::runtime_error&) {
+    Fail("Truncated matrix file", path);
+  }
+  if (checksum.Finish() != header.checksum)
+    Fail("Checksum mismatch in matrix file", path);
+  if (!row_major) result.TransposeInPlace();
+  return result;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::MapBinary(const std::string& path,
+                                               bool verify) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) Fail("Cannot open", path);
+  struct stat info;
+  if (fstat(fd, &info) != 0 || (std::uint64_t)info.st_size <
+                                   sizeof(S21BinaryHeader)) {
+    close(fd);
+    Fail("Truncated matrix file", path);
+  }
+  std::size_t length = (std::size_t)info.st_size;
+  void* base =
+      mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (base == MAP_FAILED) Fail("Cannot map", path);
+
+  S21BinaryHeader header;
+  std::memcpy(&header, base, sizeof(header));
+  char* payload = static_cast<char*>(base) + header.payload_offset;
+  try {
+    ValidateHeader(header, length, path);
+    if (header.element_type != S21ElementTypeOf<T>())
+      Fail("Element type of the matrix file does not match", path);
+    if (header.layout != S21MatrixLayout::kRowMajor)
+      Fail("Only row-major matrix files can be mapped", path);
+    if (verify) {
+      S21Checksum checksum;
+      checksum.Update(payload, header.rows * header.cols * sizeof(T));
+      if (checksum.Finish() != header.checksum)
+        Fail("Checksum mismatch in matrix file", path);
+    }
+  } catch (...) {
+    munmap(base, length);
+    throw;
+  }
+  MappedFiles().Register(payload, base, length);
+  return S21BasicMatrix((int)header.rows, (int)header.cols,
+                        reinterpret_cast<T*>(payload), &MappedFiles());
+}
+
+template void S21BasicMatrix<float>::SaveBinary(const std::string&) const;
+template void S21BasicMatrix<double>::SaveBinary(const std::string&) const;
+template void S21BasicMatrix<long double>::SaveBinary(
+    const std::string&) const;
+template S21BasicMatrix<float> S21BasicMatrix<float>::LoadBinary(
+    const std::string&);
+template S21BasicMatrix<double> S21BasicMatrix<double>::LoadBinary(
+    const std::string&);
+template S21BasicMatrix<long double> S21BasicMatrix<long double>::LoadBinary(
+    const std::string&);
+template S21BasicMatrix<float> S21BasicMatrix<float>::MapBinary(
+    const std::string&, bool);
+template S21BasicMatrix<double> S21BasicMatrix<double>::MapBinary(
+    const std::string&, bool);
+template S21BasicMatrix<long double> S21BasicMatrix<long double>::MapBinary(
+    const std::string&, bool);
@@ -0,0 +1,73 @@
+#ifndef SRC_S21_MATRIX_IO_H_
+#define SRC_S21_MATRIX_IO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+// Binary matrix files written by S21BasicMatrix::SaveBinary: a 64-byte
+// header, then the elements with no padding between rows, starting at
+// payload_offset (64, so a mapped payload keeps the alignment of the
+// mapping). Fields are in host byte order; byte_order tells readers on a
+// different host to give up.
+
+enum class S21ElementType : std::uint32_t {
+  kFloat = 1,
+  kDouble = 2,
+  kLongDouble = 3
+};
+
+template <typename T>
+constexpr S21ElementType S21ElementTypeOf() {
+  if (std::is_same<T, float>::value) return S21ElementType::kFloat;
+  if (std::is_same<T, double>::value) return S21ElementType::kDouble;
+  return S21ElementType::kLongDouble;
+}
+
+enum class S21MatrixLayout : std::uint32_t { kRowMajor = 0, kColMajor = 1 };
+
+struct S21BinaryHeader {
+  static constexpr char kMagic[8] = {'S', '2', '1', 'M', 'A', 'T', 'R', 'X'};
+  static constexpr std::uint32_t kVersion = 1;
+  static constexpr std::uint32_t kByteOrder = 0x01020304;
+
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t rows;
+  std::uint64_t cols;
+  S21ElementType element_type;
+  std::uint32_t element_size;
+  S21MatrixLayout layout;
+  std::uint32_t reserved;
+  std::uint64_t payload_offset;
+  // S21Checksum of the payload bytes.
+  std::uint64_t checksum;
+};
+
+static_assert(sizeof(S21BinaryHeader) == 64, "the header is 64 bytes");
+
+// Reads and validates the header alone; throws std::runtime_error for
+// files that are missing, truncated or not in this format.
+S21BinaryHeader S21ReadBinaryHeader(const std::string& path);
+
+// 64-bit checksum of a byte stream fed in arbitrary pieces: four
+// independent multiply-rotate lanes over 32-byte stripes (the round of
+// xxHash64), so it runs at memory speed on multi-GB payloads.
+class S21Checksum {
+ public:
+  S21Checksum();
+  void Update(const void* data, std::size_t size);
+  std::uint64_t Finish() const;
+
+ private:
+  void Stripe(const unsigned char* stripe);
+
+  std::uint64_t lanes_[4];
+  unsigned char pending_[32];
+  std::size_t pending_size_;
+  std::uint64_t total_;
+};
+
+#endif  // SRC_S21_MATRIX_IO_H_
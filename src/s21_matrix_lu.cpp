@@ -0,0 +1,215 @@
+#include "s21_matrix_oop.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Columns of a right-hand side are independent triangular solves of n^2
+// work each, so they are what gets spread across the pool.
+template <typename Body>
+void ForColumnRanges(int n, int columns, Body body) {
+  if ((long)n * n * columns < kS21SerialCutoff) {
+    body(0L, (long)columns);
+  } else {
+    S21ThreadPool::Instance().ParallelFor(0, columns, 8, body);
+  }
+}
+
+}  // namespace
+
+template <typename T>
+S21BasicMatrixLU<T>::S21BasicMatrixLU(const S21BasicMatrix<T>& matrix)
+    : lu_(matrix), pivots_(), sign_(1), singular_(false) {
+  if (matrix.getRows() != matrix.getCols())
+    throw std::invalid_argument("The matrix is not square");
+
+  int n = lu_.getRows();
+  int stride = lu_.stride();
+  T* a = lu_.data();
+  pivots_.resize(n);
+
+  for (int k = 0; k < n; k++) {
+    int pivot = k;
+    T pivot_value = std::abs(a[(std::size_t)k * stride + k]);
+    for (int i = k + 1; i < n; i++) {
+      T value = std::abs(a[(std::size_t)i * stride + k]);
+      if (value > pivot_value) {
+        pivot = i;
+        pivot_value = value;
+      }
+    }
+    pivots_[k] = pivot;
+
+    T* row_k = a + (std::size_t)k * stride;
+    if (pivot != k) {
+      std::swap_ranges(row_k, row_k + n, a + (std::size_t)pivot * stride);
+      sign_ = -sign_;
+    }
+    if (pivot_value == T(0)) {
+      singular_ = true;
+      continue;
+    }
+
+    auto update = [&](long first, long last) {
+      for (long i = first; i < last; i++) {
+        T* row_i = a + i * stride;
+        T factor = row_i[k] / row_k[k];
+        row_i[k] = factor;
+        if (factor != T(0))
+          for (int j = k + 1; j < n; j++) row_i[j] -= factor * row_k[j];
+      }
+    };
+    long remaining = n - k - 1;
+    if (remaining * remaining < kS21SerialCutoff) {
+      update(k + 1, n);
+    } else {
+      long grain = std::max(1L, kS21SerialCutoff / 4 / remaining);
+      S21ThreadPool::Instance().ParallelFor(k + 1, n, grain, update);
+    }
+  }
+}
+
+template <typename T>
+int S21BasicMatrixLU<T>::getSize() const { return lu_.getRows(); }
+
+template <typename T>
+bool S21BasicMatrixLU<T>::IsSingular() const { return singular_; }
+
+template <typename T>
+T S21BasicMatrixLU<T>::Determinant() const {
+  T determinant = 0;
+  if (!singular_) {
+    determinant = sign_;
+    const T* a = lu_.data();
+    for (int i = 0; i < getSize(); i++)
+      determinant *= a[(std::size_t)i * lu_.stride() + i];
+  }
+  return determinant;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrixLU<T>::Solve(const S21BasicMatrix<T>& b) const {
+  if (b.getRows() != getSize())
+    throw std::invalid_argument(
+        "The number of rows of the right-hand side is not equal to the size "
+        "of the matrix");
+  if (singular_) throw std::invalid_argument("The matrix is singular");
+
+  int n = getSize();
+  int m = b.getCols();
+  S21BasicMatrix<T> x(b);
+  T* xd = x.data();
+  int xs = x.stride();
+  const T* a = lu_.data();
+  int as = lu_.stride();
+
+  for (int k = 0; k < n; k++) {
+    if (pivots_[k] != k) {
+      T* row = xd + (std::size_t)k * xs;
+      std::swap_ranges(row, row + m, xd + (std::size_t)pivots_[k] * xs);
+    }
+  }
+
+  // Forward substitution with the unit lower triangle, then back
+  // substitution with U, one row at a time so that the inner loops run over
+  // contiguous right-hand side columns [first, last).
+  ForColumnRanges(n, m, [&](long first, long last) {
+    for (int i = 1; i < n; i++) {
+      T* x_i = xd + (std::size_t)i * xs;
+      const T* l_i = a + (std::size_t)i * as;
+      for (int k = 0; k < i; k++) {
+        T factor = l_i[k];
+        if (factor != T(0)) {
+          const T* x_k = xd + (std::size_t)k * xs;
+          for (long j = first; j < last; j++) x_i[j] -= factor * x_k[j];
+        }
+      }
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+      T* x_i = xd + (std::size_t)i * xs;
+      const T* u_i = a + (std::size_t)i * as;
+      for (int k = i + 1; k < n; k++) {
+        T factor = u_i[k];
+        if (factor != T(0)) {
+          const T* x_k = xd + (std::size_t)k * xs;
+          for (long j = first; j < last; j++) x_i[j] -= factor * x_k[j];
+        }
+      }
+      T diagonal = u_i[i];
+      for (long j = first; j < last; j++) x_i[j] /= diagonal;
+    }
+  });
+  return x;
+}
+
+// A^-1 = U^-1 * L^-1 * P. Inverting the unit lower triangle first keeps the
+// forward pass inside the lower triangle (row i of L^-1 has no entries past
+// column i), which saves a third of the work of solving against I.
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrixLU<T>::InverseMatrix() const {
+  if (singular_) throw std::invalid_argument("The matrix is singular");
+
+  int n = getSize();
+  S21BasicMatrix<T> x(n, n);
+  T* xd = x.data();
+  int xs = x.stride();
+  const T* a = lu_.data();
+  int as = lu_.stride();
+
+  for (int i = 0; i < n; i++) xd[(std::size_t)i * xs + i] = 1;
+
+  ForColumnRanges(n, n, [&](long first, long last) {
+    for (int i = (int)first + 1; i < n; i++) {
+      T* x_i = xd + (std::size_t)i * xs;
+      const T* l_i = a + (std::size_t)i * as;
+      for (int k = (int)first; k < i; k++) {
+        T factor = l_i[k];
+        if (factor != T(0)) {
+          const T* x_k = xd + (std::size_t)k * xs;
+          long end = std::min(last, (long)k + 1);
+          for (long j = first; j < end; j++) x_i[j] -= factor * x_k[j];
+        }
+      }
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+      T* x_i = xd + (std::size_t)i * xs;
+      const T* u_i = a + (std::size_t)i * as;
+      for (int k = i + 1; k < n; k++) {
+        T factor = u_i[k];
+        if (factor != T(0)) {
+          const T* x_k = xd + (std::size_t)k * xs;
+          for (long j = first; j < last; j++) x_i[j] -= factor * x_k[j];
+        }
+      }
+      T diagonal = u_i[i];
+      for (long j = first; j < last; j++) x_i[j] /= diagonal;
+    }
+  });
+
+  for (int k = n - 1; k >= 0; k--) {
+    if (pivots_[k] != k) {
+      for (int i = 0; i < n; i++) {
+        T* x_i = xd + (std::size_t)i * xs;
+        std::swap(x_i[k], x_i[pivots_[k]]);
+      }
+    }
+  }
+  return x;
+}
+
+template <typename T>
+const S21BasicMatrix<T>& S21BasicMatrixLU<T>::getLU() const { return lu_; }
+
+template <typename T>
+const std::vector<int>& S21BasicMatrixLU<T>::getPivots() const {
+  return pivots_;
+}
+
+template class S21BasicMatrixLU<float>;
+template class S21BasicMatrixLU<double>;
+template class S21BasicMatrixLU<long double>;
@@ -0,0 +1,151 @@
+#include "s21_matrix_memory.h"
+
+#include <new>
+
+namespace {
+
+// Aligned operator new/delete, the allocator matrices used before
+// resources existed.
+class HeapResource : public std::pmr::memory_resource {
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    return ::operator new(bytes, std::align_val_t(alignment));
+  }
+  void do_deallocate(void* block, std::size_t,
+                     std::size_t alignment) override {
+    ::operator delete(block, std::align_val_t(alignment));
+  }
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+std::atomic<std::pmr::memory_resource*> default_resource{nullptr};
+thread_local std::pmr::memory_resource* scoped_resource = nullptr;
+
+// Index of the smallest power-of-two class holding bytes.
+int SizeClass(std::size_t bytes) {
+  int index = 0;
+  std::size_t block = S21PoolResource::kMinBlock;
+  while (block < bytes) {
+    block <<= 1;
+    index++;
+  }
+  return index;
+}
+
+}  // namespace
+
+std::pmr::memory_resource* S21HeapResource() {
+  static HeapResource heap;
+  return &heap;
+}
+
+std::pmr::memory_resource* S21GetMatrixResource() {
+  std::pmr::memory_resource* resource = scoped_resource;
+  if (resource == nullptr)
+    resource = default_resource.load(std::memory_order_relaxed);
+  return resource != nullptr ? resource : S21HeapResource();
+}
+
+void S21SetMatrixResource(std::pmr::memory_resource* resource) {
+  default_resource.store(resource);
+}
+
+S21ScopedResource::S21ScopedResource(std::pmr::memory_resource* resource)
+    : previous_(scoped_resource) {
+  scoped_resource = resource;
+}
+
+S21ScopedResource::~S21ScopedResource() { scoped_resource = previous_; }
+
+S21PoolResource::S21PoolResource(std::pmr::memory_resource* upstream)
+    : upstream_(upstream),
+      free_lists_(),
+      cached_bytes_(0),
+      hits_(0),
+      misses_(0),
+      oversized_(0) {}
+
+S21PoolResource::~S21PoolResource() { Release(); }
+
+S21PoolStats S21PoolResource::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return {hits_.load(), misses_.load(), oversized_.load(), cached_bytes_};
+}
+
+void S21PoolResource::Release() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int index = 0; index < kClasses; index++) {
+    std::size_t block_size = kMinBlock << index;
+    while (free_lists_[index] != nullptr) {
+      FreeBlock* block = free_lists_[index];
+      free_lists_[index] = block->next;
+      upstream_->deallocate(block, block_size, kBlockAlignment);
+    }
+  }
+  cached_bytes_ = 0;
+}
+
+void* S21PoolResource::do_allocate(std::size_t bytes, std::size_t alignment) {
+  if (bytes > kMaxBlock || alignment > kBlockAlignment) {
+    oversized_++;
+    return upstream_->allocate(bytes, alignment);
+  }
+  int index = SizeClass(bytes);
+  std::size_t block_size = kMinBlock << index;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    FreeBlock* block = free_lists_[index];
+    if (block != nullptr) {
+      free_lists_[index] = block->next;
+      cached_bytes_ -= block_size;
+      hits_++;
+      return block;
+    }
+  }
+  misses_++;
+  return upstream_->allocate(block_size, kBlockAlignment);
+}
+
+void S21PoolResource::do_deallocate(void* block, std::size_t bytes,
+                                    std::size_t alignment) {
+  if (bytes > kMaxBlock || alignment > kBlockAlignment) {
+    upstream_->deallocate(block, bytes, alignment);
+    return;
+  }
+  int index = SizeClass(bytes);
+  std::lock_guard<std::mutex> lock(mutex_);
+  FreeBlock* freed = static_cast<FreeBlock*>(block);
+  freed->next = free_lists_[index];
+  free_lists_[index] = freed;
+  cached_bytes_ += kMinBlock << index;
+}
+
+bool S21PoolResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+S21ScopedArena::S21ScopedArena(std::size_t initial_size,
+                               std::pmr::memory_resource* upstream)
+    : arena_(initial_size, upstream),
+      previous_(scoped_resource),
+      allocations_(0),
+      bytes_(0) {
+  scoped_resource = this;
+}
+
+S21ScopedArena::~S21ScopedArena() { scoped_resource = previous_; }
+
+void* S21ScopedArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  allocations_++;
+  bytes_ += bytes;
+  return arena_.allocate(bytes, alignment);
+}
+
+bool S21ScopedArena::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
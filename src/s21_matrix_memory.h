@@ -0,0 +1,126 @@
+#ifndef SRC_S21_MATRIX_MEMORY_H_
+#define SRC_S21_MATRIX_MEMORY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+// Where matrix buffers come from. Every matrix holds the
+// std::pmr::memory_resource it was allocated from and returns its buffer
+// there. A matrix created without an explicit resource takes the current
+// one of its thread: the innermost S21ScopedResource (or S21ScopedArena),
+// else the process-wide default, else the heap (aligned operator new).
+//
+// As with std::pmr containers, move construction takes the buffer together
+// with its resource, copies allocate from the current resource, and move
+// assignment steals the buffer only between equal resources (it copies
+// otherwise, so the target keeps its own resource).
+
+std::pmr::memory_resource* S21HeapResource();
+std::pmr::memory_resource* S21GetMatrixResource();
+// Process-wide default for threads without a scoped resource; nullptr
+// restores the heap. Must not be called while other threads allocate
+// matrices.
+void S21SetMatrixResource(std::pmr::memory_resource* resource);
+
+// Makes resource the current one of this thread until destruction. Scopes
+// nest. The resource has to outlive every matrix allocated from it.
+class S21ScopedResource {
+ public:
+  explicit S21ScopedResource(std::pmr::memory_resource* resource);
+  S21ScopedResource(const S21ScopedResource&) = delete;
+  S21ScopedResource& operator=(const S21ScopedResource&) = delete;
+  ~S21ScopedResource();
+
+ private:
+  std::pmr::memory_resource* previous_;
+};
+
+struct S21PoolStats {
+  std::size_t hits;       // served from a free list
+  std::size_t misses;     // served by the upstream resource
+  std::size_t oversized;  // too large for the pool, passed through
+  std::size_t cached_bytes;
+
+  double HitRate() const {
+    std::size_t total = hits + misses;
+    return total == 0 ? 0.0 : (double)hits / total;
+  }
+};
+
+// Size-class pool: requests are rounded up to a power of two between
+// kMinBlock and kMaxBlock, and freed blocks are kept on per-class free lists
+// for the next request of the same class instead of going back upstream.
+// Good for the many same-sized temporaries of a computation (minors, LU
+// copies, intermediate products). Thread-safe.
+class S21PoolResource : public std::pmr::memory_resource {
+ public:
+  static constexpr std::size_t kMinBlock = 64;
+  static constexpr std::size_t kMaxBlock = std::size_t(1) << 26;
+  static constexpr std::size_t kBlockAlignment = 64;
+
+  explicit S21PoolResource(
+      std::pmr::memory_resource* upstream = S21HeapResource());
+  S21PoolResource(const S21PoolResource&) = delete;
+  S21PoolResource& operator=(const S21PoolResource&) = delete;
+  ~S21PoolResource() override;
+
+  S21PoolStats getStats() const;
+  // Returns every cached block to the upstream resource.
+  void Release();
+
+ private:
+  static constexpr int kClasses = 21;  // 64 B .. 64 MiB
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* block, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+
+  std::pmr::memory_resource* upstream_;
+  mutable std::mutex mutex_;
+  FreeBlock* free_lists_[kClasses];
+  std::size_t cached_bytes_;
+  std::atomic<std::size_t> hits_;
+  std::atomic<std::size_t> misses_;
+  std::atomic<std::size_t> oversized_;
+};
+
+// Bump allocator installed as the current resource of its thread for its
+// lifetime: every matrix created inside the scope is carved out of a few
+// large chunks, deallocation is free, and all of it is released at once
+// when the scope ends. Results that outlive the scope belong in matrices
+// created before it: assigning a temporary to them copies it into their own
+// buffer. A matrix still holding arena memory when the arena dies is left
+// dangling. Not thread-safe: matrices from it belong to its thread.
+class S21ScopedArena : public std::pmr::memory_resource {
+ public:
+  explicit S21ScopedArena(
+      std::size_t initial_size = 1 << 20,
+      std::pmr::memory_resource* upstream = S21HeapResource());
+  S21ScopedArena(const S21ScopedArena&) = delete;
+  S21ScopedArena& operator=(const S21ScopedArena&) = delete;
+  ~S21ScopedArena() override;
+
+  std::size_t getAllocations() const { return allocations_; }
+  std::size_t getBytesAllocated() const { return bytes_; }
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+
+  std::pmr::monotonic_buffer_resource arena_;
+  std::pmr::memory_resource* previous_;
+  std::size_t allocations_;
+  std::size_t bytes_;
+};
+
+#endif  // SRC_S21_MATRIX_MEMORY_H_
@@ -1,289 +1,595 @@
 #include "s21_matrix_oop.h"
 
-S21Matrix::S21Matrix() : rows_(1), cols_(1), matrix_(nullptr) {}
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <limits>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_simd.h"
+#include "s21_matrix_stats.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Runs body(first_row, last_row) over [0, rows), spread across the thread
+// pool when rows * cols elements are enough to be worth it.
+template <typename Body>
+void ParallelRows(int rows, int cols, Body body) {
+  if ((long)rows * cols < kS21SerialCutoff) {
+    body(0L, (long)rows);
+  } else {
+    long grain = std::max(1L, kS21SerialCutoff / 4 / cols);
+    S21ThreadPool::Instance().ParallelFor(0, rows, grain, body);
+  }
+}
+
+// Same over a flat range of count elements.
+template <typename Body>
+void ParallelElements(std::size_t count, Body body) {
+  if ((long)count < kS21SerialCutoff) {
+    body(0L, (long)count);
+  } else {
+    S21ThreadPool::Instance().ParallelFor(0, (long)count,
+                                          kS21SerialCutoff / 4, body);
+  }
+}
+
+// Calls kernel(count, lhs_row, rhs_row) for every row of two equally sized
+// matrices, over flat ranges when neither of them has padding between rows.
+template <typename T, typename Kernel>
+void ForEachRowPair(int rows, int cols, T* lhs, int lhs_stride, const T* rhs,
+                    int rhs_stride, Kernel kernel) {
+  if (lhs_stride == cols && rhs_stride == cols) {
+    ParallelElements((std::size_t)rows * cols, [&](long first, long last) {
+      kernel(last - first, lhs + first, rhs + first);
+    });
+  } else {
+    ParallelRows(rows, cols, [&](long first, long last) {
+      for (long i = first; i < last; i++)
+        kernel(cols, lhs + i * lhs_stride, rhs + i * rhs_stride);
+    });
+  }
+}
+
+// Capacity for size elements when capacity is not enough: at least double,
+// as std::vector grows.
+int Grown(int size, int capacity) {
+  return (int)std::min<long>(INT_MAX, std::max<long>(size, 2L * capacity));
+}
+
+// Bytes of the elements of a rows x cols matrix.
+template <typename T>
+std::uint64_t Bytes(long rows, long cols) {
+  return (std::uint64_t)rows * cols * sizeof(T);
+}
+
+}  // namespace
+
+void S21ParallelRows(int rows, int cols,
+                     const std::function<void(long, long)>& body) {
+  ParallelRows(rows, cols, body);
+}
 
-S21Matrix::S21Matrix(int rows, int cols) : rows_(rows), cols_(cols) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix()
+    : rows_(1),
+      cols_(1),
+      matrix_(nullptr),
+      resource_(S21GetMatrixResource()) {
+  allocateMatrix();
+}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols)
+    : S21BasicMatrix(rows, cols, S21GetMatrixResource()) {}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols,
+                                  std::pmr::memory_resource* resource)
+    : rows_(rows), cols_(cols), matrix_(nullptr), resource_(resource) {
   if (rows <= 0 || cols <= 0) {
     throw std::invalid_argument("Invalid size of matrix");
   }
   allocateMatrix();
 }
 
-S21Matrix::S21Matrix(const S21Matrix& other)
-    : rows_(other.rows_), cols_(other.cols_) {
-  allocateMatrix();
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols, bool zero)
+    : rows_(rows),
+      cols_(cols),
+      matrix_(nullptr),
+      resource_(S21GetMatrixResource()) {
+  allocateMatrix(zero);
+}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(int rows, int cols, T* buffer,
+                                  std::pmr::memory_resource* resource)
+    : rows_(rows),
+      cols_(cols),
+      matrix_(buffer),
+      resource_(resource),
+      stride_(cols),
+      capacity_((std::size_t)rows * cols) {}
+
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(const S21BasicMatrix& other)
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      matrix_(nullptr),
+      resource_(S21GetMatrixResource()) {
+  S21_STAT_SCOPE(S21StatOp::kCopyConstruct, 0,
+                 Bytes<T>(other.rows_, other.cols_));
+  allocateMatrix(false);
   copyMatrix(other);
 }
 
-S21Matrix::S21Matrix(S21Matrix&& other) noexcept
-    : rows_(other.rows_), cols_(other.cols_), matrix_(other.matrix_) {
+template <typename T>
+S21BasicMatrix<T>::S21BasicMatrix(S21BasicMatrix&& other) noexcept
+    : rows_(other.rows_),
+      cols_(other.cols_),
+      matrix_(other.matrix_),
+      resource_(other.resource_),
+      stride_(other.stride_),
+      capacity_(other.capacity_) {
   other.matrix_ = nullptr;
   other.rows_ = 0;
   other.cols_ = 0;
+  other.stride_ = 0;
+  other.capacity_ = 0;
 }
 
-S21Matrix::~S21Matrix() { clearMatrix(); }
+template <typename T>
+S21BasicMatrix<T>::~S21BasicMatrix() { clearMatrix(); }
 
-bool S21Matrix::EqMatrix(const S21Matrix& other) const {
+template <typename T>
+bool S21BasicMatrix<T>::EqMatrix(const S21BasicMatrix& other) const {
   bool result = true;
   if ((*this).getRows() != other.getRows() ||
       (*this).getCols() != other.getCols()) {
     result = false;
   } else {
-    for (int i = 0; result != false && i < (*this).getRows(); i++)
-      for (int j = 0; result != false && j < (*this).getCols(); j++)
-        if (fabs((*this)(i, j) - other(i, j)) > EPS) result = false;
+    auto near_equal = S21GetSimdKernels<T>().near_equal;
+    std::atomic<bool> equal(true);
+    ForEachRowPair(rows_, cols_, matrix_, stride(), other.matrix_,
+                   other.stride(),
+                   [&](std::size_t count, const T* lhs, const T* rhs) {
+                     if (equal.load(std::memory_order_relaxed) &&
+                         !near_equal(count, lhs, rhs,
+                                     S21MatrixTraits<T>::kEpsilon))
+                       equal.store(false, std::memory_order_relaxed);
+                   });
+    result = equal.load();
   }
   return result;
 }
 
-void S21Matrix::SumMatrix(const S21Matrix& other) {
+template <typename T>
+void S21BasicMatrix<T>::SumMatrix(const S21BasicMatrix& other) {
   if ((*this).getRows() != other.getRows() ||
       (*this).getCols() != other.getCols()) {
     throw std::invalid_argument("Different dimension of matrices");
   }
+  S21_STAT_SCOPE(S21StatOp::kSumMatrix, (std::uint64_t)rows_ * cols_, 0);
 
-  for (int i = 0; i < (*this).getRows(); i++)
-    for (int j = 0; j < (*this).getCols(); j++) (*this)(i, j) += other(i, j);
+  ForEachRowPair(rows_, cols_, matrix_, stride(), other.matrix_,
+                 other.stride(), S21GetSimdKernels<T>().add);
 }
 
-void S21Matrix::SubMatrix(const S21Matrix& other) {
+template <typename T>
+void S21BasicMatrix<T>::SubMatrix(const S21BasicMatrix& other) {
   if ((*this).getRows() != other.getRows() ||
       (*this).getCols() != other.getCols()) {
     throw std::invalid_argument("Different dimension of matrices");
   }
+  S21_STAT_SCOPE(S21StatOp::kSubMatrix, (std::uint64_t)rows_ * cols_, 0);
+
+  ForEachRowPair(rows_, cols_, matrix_, stride(), other.matrix_,
+                 other.stride(), S21GetSimdKernels<T>().sub);
+}
 
-  for (int i = 0; i < (*this).getRows(); i++)
-    for (int j = 0; j < (*this).getCols(); j++) (*this)(i, j) -= other(i, j);
+template <typename T>
+void S21BasicMatrix<T>::MulNumber(const T multiplier) {
+  S21_STAT_SCOPE(S21StatOp::kMulNumber, (std::uint64_t)rows_ * cols_, 0);
+  auto scale = S21GetSimdKernels<T>().scale;
+  ForEachRowPair(rows_, cols_, matrix_, stride(), matrix_, stride(),
+                 [&](std::size_t count, T* row, const T*) {
+                   scale(count, row, multiplier);
+                 });
 }
 
-void S21Matrix::MulNumber(const double multiplier) {
-  for (int i = 0; i < (*this).getRows(); i++)
-    for (int j = 0; j < (*this).getCols(); j++) (*this)(i, j) *= multiplier;
+template <typename T>
+void S21BasicMatrix<T>::MulMatrix(const S21BasicMatrix& other) {
+  MulMatrix(other, S21GetMulAlgorithm());
 }
 
-void S21Matrix::MulMatrix(const S21Matrix& other) {
+template <typename T>
+void S21BasicMatrix<T>::MulMatrix(const S21BasicMatrix& other,
+                                  S21MulAlgorithm algorithm) {
   if ((*this).getCols() != other.getRows()) {
     throw std::invalid_argument(
         "The number of columns of the first matrix is not equal to the number "
         "of rows of the second matrix");
   }
-  int new_rows = (*this).getRows();
-  int new_cols = other.getCols();
-  S21Matrix result_matrix = S21Matrix(new_rows, new_cols);
-  for (int i = 0; i < new_rows; i++)
-    for (int j = 0; j < new_cols; j++)
-      for (int k = 0; k < (*this).getCols(); k++)
-        result_matrix(i, j) += (*this)(i, k) * other(k, j);
-  (*this) = result_matrix;
-}
-
-S21Matrix S21Matrix::Transpose() const {
-  S21Matrix result_matrix = S21Matrix((*this).getCols(), (*this).getRows());
-  for (int i = 0; i < (*this).getRows(); i++)
-    for (int j = 0; j < (*this).getCols(); j++)
-      result_matrix(j, i) = (*this)(i, j);
-  return result_matrix;
+  S21_STAT_SCOPE(S21StatOp::kMulMatrix,
+                 2 * (std::uint64_t)rows_ * other.getCols() * cols_, 0);
+  S21BasicMatrix result_matrix = S21BasicMatrix(rows_, other.getCols());
+  S21GemmWith(algorithm, rows_, other.getCols(), cols_, T(1), matrix_,
+              stride(), 1, other.matrix_, other.stride(), 1, T(0),
+              result_matrix.matrix_, result_matrix.stride());
+  (*this) = std::move(result_matrix);
 }
 
-S21Matrix S21Matrix::CalcComplements() const {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::CalcComplements() const {
   if (getRows() != getCols())
     throw std::invalid_argument("The matrix is not square");
+  S21_STAT_SCOPE(S21StatOp::kCalcComplements,
+                 2 * (std::uint64_t)rows_ * rows_ * rows_, 0);
 
   if ((*this).getRows() == 1 && (*this).getCols() == 1) {
-    if (fabs((*this)(0, 0)) < EPS) {
+    if (std::abs(at_unchecked(0, 0)) < S21MatrixTraits<T>::kEpsilon) {
       throw std::logic_error(
           "A first-order null matrix does not have an algebraic complement "
           "matrix");
     }
   }
-  S21Matrix result_matrix = S21Matrix((*this).getRows(), (*this).getCols());
-  if ((*this).getRows() == 1 && fabs((*this)(0, 0)) > EPS) {
-    result_matrix(0, 0) = 1.;
-  } else {
-    for (int i = 0; i < (*this).getRows(); i++) {
-      for (int j = 0; j < (*this).getCols(); j++) {
-        S21Matrix minor_matrix = Minor(*this, i, j);
-        result_matrix(i, j) = minor_matrix.Determinant() * pow(-1, i + j);
-      }
+  if ((*this).getRows() == 1) {
+    S21BasicMatrix result_matrix(1, 1);
+    result_matrix.at_unchecked(0, 0) = 1;
+    return result_matrix;
+  }
+
+  // The complements are the transposed adjugate, det(A) * A^-T, so a single
+  // LU factorization gives all of them. It is only trusted while its
+  // pivots stay well away from zero; otherwise the rank-revealing QR takes
+  // over.
+  S21BasicMatrixLU<T> lu = LU();
+  if (!lu.IsSingular()) {
+    const S21BasicMatrix& factors = lu.getLU();
+    T smallest = std::abs(factors.at_unchecked(0, 0));
+    T largest = smallest;
+    for (int k = 1; k < rows_; k++) {
+      T pivot = std::abs(factors.at_unchecked(k, k));
+      smallest = std::min(smallest, pivot);
+      largest = std::max(largest, pivot);
+    }
+    if (smallest > std::sqrt(std::numeric_limits<T>::epsilon()) * largest) {
+      S21BasicMatrix result_matrix = lu.InverseMatrix().Transpose();
+      result_matrix.MulNumber(lu.Determinant());
+      return result_matrix;
     }
   }
+  return RankDeficientComplements();
+}
+
+// With A * P = Q * R, adj(A) = det(P) * det(Q) * P * adj(R) * Q^T. A full
+// rank that LU could not vouch for (a badly scaled A such as diag(1e9, 1))
+// keeps det(A) * A^-T, from the QR factors. At rank n - 1, R = [R11 r; 0 0]
+// with its last diagonal entry (numerically) zero and
+// adj(R) = z * e_n^T with z = det(R11) * [-R11^-1 * r; 1], so the
+// complements are the rank-one matrix sign * q_n * (P * z)^T, q_n being the
+// last column of Q. A rank below n - 1 makes every minor of order n - 1
+// vanish. For a nearly singular A the dropped part of adj(R) is of relative
+// size |R(n-1, n-1)| / |R(n-2, n-2)|, below the rank tolerance.
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::RankDeficientComplements() const {
+  int n = rows_;
+  S21BasicMatrix result_matrix(n, n);
+  S21BasicMatrixQR<T> qr = QR();
+  if (qr.getRank() < n - 1) return result_matrix;
+
+  const S21BasicMatrix& r = qr.getQR();
+  if (qr.getRank() == n) {
+    T determinant = qr.getSign();
+    for (int k = 0; k < n; k++) determinant *= r.at_unchecked(k, k);
+    for (int k = 0; k < n; k++) result_matrix.at_unchecked(k, k) = 1;
+    result_matrix = qr.Solve(result_matrix).Transpose();
+    result_matrix.MulNumber(determinant);
+    return result_matrix;
+  }
+  std::vector<T> z(n);
+  T determinant = 1;
+  for (int k = 0; k < n - 1; k++) determinant *= r.at_unchecked(k, k);
+  z[n - 1] = determinant;
+  for (int i = n - 2; i >= 0; i--) {
+    T sum = determinant * r.at_unchecked(i, n - 1);
+    for (int k = i + 1; k < n - 1; k++) sum += r.at_unchecked(i, k) * z[k];
+    z[i] = -sum / r.at_unchecked(i, i);
+  }
+
+  S21BasicMatrix last_column(n, 1);
+  last_column.at_unchecked(n - 1, 0) = 1;
+  S21BasicMatrix q = qr.MultiplyQ(last_column);
+  std::vector<T> row(n);
+  for (int k = 0; k < n; k++) row[qr.getPermutation()[k]] = z[k];
+  T sign = qr.getSign();
+  for (int i = 0; i < n; i++) {
+    T factor = sign * q.at_unchecked(i, 0);
+    for (int j = 0; j < n; j++)
+      result_matrix.at_unchecked(i, j) = factor * row[j];
+  }
   return result_matrix;
 }
 
-double S21Matrix::Determinant() const {
+template <typename T>
+T S21BasicMatrix<T>::Determinant() const {
   if (getRows() != getCols())
     throw std::invalid_argument("The matrix is not square");
+  S21_STAT_SCOPE(S21StatOp::kDeterminant,
+                 2 * (std::uint64_t)rows_ * rows_ * rows_ / 3, 0);
 
-  double determinant = 0.0;
-  if (getRows() == 1) {
-    determinant = (*this)(0, 0);
-  } else if (getRows() == 2) {
-    determinant = (*this)(0, 0) * (*this)(1, 1) - (*this)(1, 0) * (*this)(0, 1);
-  } else {
-    for (int i = 0; i < getCols(); i++) {
-      S21Matrix temp_matrix = Minor(*this, 0, i);
-      determinant += (*this)(0, i) * pow(-1, i) * temp_matrix.Determinant();
-    }
-  }
-  return determinant;
+  return LU().Determinant();
 }
 
-S21Matrix S21Matrix::InverseMatrix() const {
-  double determinant = Determinant();
-  if (fabs(determinant) < EPS)
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::InverseMatrix() const {
+  S21_STAT_SCOPE(S21StatOp::kInverseMatrix,
+                 2 * (std::uint64_t)rows_ * rows_ * rows_, 0);
+  S21BasicMatrixLU<T> lu = LU();
+  if (std::abs(lu.Determinant()) < S21MatrixTraits<T>::kEpsilon)
     throw std::invalid_argument("The determinant of the matrix is 0");
 
-  S21Matrix result_matrix = S21Matrix((*this).getRows(), (*this).getCols());
+  return lu.InverseMatrix();
+}
 
-  S21Matrix complements_matrix = CalcComplements();
-  S21Matrix transpose_complements_matrix = complements_matrix.Transpose();
-  transpose_complements_matrix.MulNumber(1. / determinant);
-  result_matrix = transpose_complements_matrix;
+template <typename T>
+S21BasicMatrixLU<T> S21BasicMatrix<T>::LU() const {
+  return S21BasicMatrixLU<T>(*this);
+}
 
-  return result_matrix;
+template <typename T>
+S21BasicMatrixQR<T> S21BasicMatrix<T>::QR() const {
+  return S21BasicMatrixQR<T>(*this);
 }
 
-S21Matrix S21Matrix::Minor(const S21Matrix& other, int row, int col) const {
-  S21Matrix result_matrix(other.getRows() - 1, other.getCols() - 1);
-  int minor_row = 0;
-  int minor_col = 0;
-  for (int i = 0; i < other.getRows(); i++) {
-    if (i != row) {
-      for (int j = 0; j < other.getCols(); j++) {
-        if (j != col) {
-          result_matrix(minor_row, minor_col) = other(i, j);
-          minor_col++;
-        }
-      }
-      minor_row++;
-      minor_col = 0;
-    }
-  }
-  return result_matrix;
+template <typename T>
+S21BasicMatrixCholesky<T> S21BasicMatrix<T>::Cholesky() const {
+  return S21BasicMatrixCholesky<T>(*this);
 }
 
-void S21Matrix::setRows(int rows) {
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Solve(const S21BasicMatrix& b) const {
+  S21_STAT_SCOPE(S21StatOp::kSolve,
+                 2 * (std::uint64_t)rows_ * rows_ * rows_ / 3 +
+                     2 * (std::uint64_t)rows_ * rows_ * b.getCols(),
+                 0);
+  return LU().Solve(b);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::setRows(int rows) {
   if (rows < 1) {
-    std::invalid_argument("The number of rows cannot be less than 1");
+    throw std::invalid_argument("The number of rows cannot be less than 1");
+  }
+  if (rows > getRowCapacity()) {
+    reallocate(Grown(rows, getRowCapacity()), stride_);
+  } else {
+    for (int i = rows_; i < rows; i++) {
+      T* row = matrix_ + (std::size_t)i * stride_;
+      std::fill(row, row + cols_, T(0));
+    }
   }
-  S21Matrix result_matrix = S21Matrix(rows, (*this).getCols());
-  result_matrix.copyMatrix(*this);
-  *this = result_matrix;
+  rows_ = rows;
 }
 
-int S21Matrix::getRows() const { return rows_; }
+template <typename T>
+int S21BasicMatrix<T>::getRows() const { return rows_; }
 
-void S21Matrix::setCols(int cols) {
+template <typename T>
+void S21BasicMatrix<T>::setCols(int cols) {
   if (cols < 1) {
-    std::invalid_argument("The number of cols cannot be less than 1");
+    throw std::invalid_argument("The number of cols cannot be less than 1");
+  }
+  if (cols > stride_) {
+    reallocate(std::max(rows_, getRowCapacity()), Grown(cols, stride_));
+  } else {
+    for (int i = 0; i < rows_; i++) {
+      T* row = matrix_ + (std::size_t)i * stride_;
+      std::fill(row + cols_, row + std::max(cols_, cols), T(0));
+    }
   }
-  S21Matrix result_matrix = S21Matrix((*this).getRows(), cols);
-  result_matrix.copyMatrix(*this);
-  *this = result_matrix;
+  cols_ = cols;
 }
 
-int S21Matrix::getCols() const { return cols_; }
+template <typename T>
+int S21BasicMatrix<T>::getCols() const { return cols_; }
+
+template <typename T>
+void S21BasicMatrix<T>::reserve(int rows, int cols) {
+  if (rows < 1 || cols < 1)
+    throw std::invalid_argument("Invalid size of matrix");
+  if (rows > getRowCapacity() || cols > stride_)
+    reallocate(std::max(rows, getRowCapacity()), std::max(cols, stride_));
+}
 
-double& S21Matrix::operator()(int rows, int cols) {
+template <typename T>
+void S21BasicMatrix<T>::shrink_to_fit() {
+  if (capacity_ != (std::size_t)rows_ * cols_) reallocate(rows_, cols_);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::AppendRow(const std::vector<T>& values) {
+  if (values.size() != (std::size_t)cols_)
+    throw std::invalid_argument("Different dimension of matrices");
+  setRows(rows_ + 1);
+  std::copy(values.begin(), values.end(),
+            matrix_ + (std::size_t)(rows_ - 1) * stride_);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::AppendCol(const std::vector<T>& values) {
+  if (values.size() != (std::size_t)rows_)
+    throw std::invalid_argument("Different dimension of matrices");
+  setCols(cols_ + 1);
+  for (int i = 0; i < rows_; i++)
+    matrix_[(std::size_t)i * stride_ + cols_ - 1] = values[i];
+}
+
+template <typename T>
+T& S21BasicMatrix<T>::operator()(int rows, int cols) {
   if (rows >= (*this).getRows() || cols >= (*this).getCols() || rows < 0 ||
       cols < 0) {
     throw std::invalid_argument("Index out of range");
   }
-  return matrix_[rows][cols];
+  return matrix_[(std::size_t)rows * stride() + cols];
 }
 
-const double& S21Matrix::operator()(int rows, int cols) const {
+template <typename T>
+const T& S21BasicMatrix<T>::operator()(int rows, int cols) const {
   if (rows >= (*this).getRows() || cols >= (*this).getCols() || rows < 0 ||
       cols < 0) {
     throw std::invalid_argument("Index out of range");
   }
-  return matrix_[rows][cols];
+  return matrix_[(std::size_t)rows * stride() + cols];
+}
+
+template <typename T>
+void S21BasicMatrix<T>::checkRow(int i) const {
+  if (i < 0 || i >= rows_) throw std::invalid_argument("Index out of range");
 }
 
-S21Matrix& S21Matrix::operator=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(const S21BasicMatrix& other) {
   if (!(this == &other)) {
-    clearMatrix();
-    rows_ = other.getRows();
-    cols_ = other.getCols();
-    allocateMatrix();
+    S21_STAT_SCOPE(S21StatOp::kCopyAssign, 0,
+                   Bytes<T>(other.rows_, other.cols_));
+    if (other.getRows() > getRowCapacity() || other.getCols() > stride_) {
+      clearMatrix();
+      rows_ = other.getRows();
+      cols_ = other.getCols();
+      allocateMatrix(false);
+    } else {
+      rows_ = other.getRows();
+      cols_ = other.getCols();
+    }
     copyMatrix(other);
   }
   return *this;
 }
 
-bool S21Matrix::operator==(const S21Matrix& other) const {
-  return EqMatrix(other);
-}
-
-S21Matrix S21Matrix::operator+(const S21Matrix& other) const {
-  S21Matrix result_matrix(*this);
-  result_matrix.SumMatrix(other);
-  return result_matrix;
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(S21BasicMatrix&& other) {
+  if (*resource_ != *other.resource_) {
+    // A buffer cannot change hands between resources: this keeps its own.
+    *this = static_cast<const S21BasicMatrix&>(other);
+  } else if (this != &other) {
+    clearMatrix();
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    matrix_ = other.matrix_;
+    stride_ = other.stride_;
+    capacity_ = other.capacity_;
+    other.matrix_ = nullptr;
+    other.rows_ = 0;
+    other.cols_ = 0;
+    other.stride_ = 0;
+    other.capacity_ = 0;
+  }
+  return *this;
 }
 
-S21Matrix S21Matrix::operator-(const S21Matrix& other) const {
-  S21Matrix result_matrix(*this);
-  result_matrix.SubMatrix(other);
-  return result_matrix;
+template <typename T>
+bool S21BasicMatrix<T>::operator==(const S21BasicMatrix& other) const {
+  return EqMatrix(other);
 }
 
-S21Matrix S21Matrix::operator+=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator+=(const S21BasicMatrix& other) {
   SumMatrix(other);
   return (*this);
 }
 
-S21Matrix S21Matrix::operator-=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator-=(const S21BasicMatrix& other) {
   SubMatrix(other);
   return (*this);
 }
 
-S21Matrix S21Matrix::operator*(const double multiplier) const {
-  S21Matrix result_matrix(*this);
-  result_matrix.MulNumber(multiplier);
-  return result_matrix;
-}
-
-S21Matrix S21Matrix::operator*(const S21Matrix& other) {
-  S21Matrix result_matrix(*this);
-  result_matrix.MulMatrix(other);
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::operator*(
+    const S21BasicMatrix& other) const {
+  if (cols_ != other.getRows()) {
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the number "
+        "of rows of the second matrix");
+  }
+  S21_STAT_SCOPE(S21StatOp::kMulMatrix,
+                 2 * (std::uint64_t)rows_ * other.getCols() * cols_, 0);
+  S21BasicMatrix result_matrix(rows_, other.getCols());
+  S21GemmWith(S21GetMulAlgorithm(), rows_, other.getCols(), cols_, T(1),
+              matrix_, stride(), 1, other.matrix_, other.stride(), 1, T(0),
+              result_matrix.matrix_, result_matrix.stride());
   return result_matrix;
 }
 
-S21Matrix S21Matrix::operator*=(const double multiplier) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator*=(const T multiplier) {
   MulNumber(multiplier);
   return (*this);
 }
 
-S21Matrix S21Matrix::operator*=(const S21Matrix& other) {
+template <typename T>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator*=(const S21BasicMatrix& other) {
   MulMatrix(other);
   return (*this);
 }
 
-void S21Matrix::copyMatrix(const S21Matrix& other) {
-  int copy_rows = other.getRows();
-  int copy_cols = other.getCols();
-  if (copy_rows > (*this).getRows()) copy_rows = (*this).getRows();
-  if (copy_cols > (*this).getCols()) copy_cols = (*this).getCols();
-  for (int i = 0; i < copy_rows; i++)
-    for (int j = 0; j < copy_cols; j++) (*this)(i, j) = other(i, j);
+template <typename T>
+void S21BasicMatrix<T>::copyMatrix(const S21BasicMatrix& other) {
+  int copy_rows = std::min(rows_, other.getRows());
+  int copy_cols = std::min(cols_, other.getCols());
+  for (int i = 0; i < copy_rows; i++) {
+    const T* src = other.matrix_ + (std::size_t)i * other.stride();
+    std::copy(src, src + copy_cols, matrix_ + (std::size_t)i * stride());
+  }
 }
 
-void S21Matrix::allocateMatrix() {
-  matrix_ = new double*[(*this).getRows()]();
-  for (int i = 0; i < (*this).getRows(); i++) {
-    matrix_[i] = new double[(*this).getCols()]();
-  }
+template <typename T>
+void S21BasicMatrix<T>::allocateMatrix(bool zero) {
+  std::size_t count = (std::size_t)rows_ * cols_;
+  matrix_ = static_cast<T*>(resource_->allocate(count * sizeof(T), kAlignment));
+  S21_STAT_ALLOCATED(count * sizeof(T), 0);
+  stride_ = cols_;
+  capacity_ = count;
+  if (zero) std::fill(matrix_, matrix_ + count, T(0));
 }
 
-void S21Matrix::clearMatrix() {
+template <typename T>
+void S21BasicMatrix<T>::clearMatrix() {
   if (matrix_ != nullptr) {
-    for (int i = 0; i < (*this).getRows(); i++) {
-      delete[] matrix_[i];
-    }
-    delete[] matrix_;
+    resource_->deallocate(matrix_, capacity_ * sizeof(T), kAlignment);
     matrix_ = nullptr;
   }
   rows_ = 0;
   cols_ = 0;
+  stride_ = 0;
+  capacity_ = 0;
 }
+
+template <typename T>
+void S21BasicMatrix<T>::reallocate(int row_capacity, int stride) {
+  std::size_t capacity = (std::size_t)row_capacity * stride;
+  T* buffer =
+      static_cast<T*>(resource_->allocate(capacity * sizeof(T), kAlignment));
+  S21_STAT_ALLOCATED(capacity * sizeof(T), Bytes<T>(rows_, cols_));
+  for (int i = 0; i < rows_; i++) {
+    const T* src = matrix_ + (std::size_t)i * stride_;
+    T* dst = buffer + (std::size_t)i * stride;
+    std::copy(src, src + cols_, dst);
+    std::fill(dst + cols_, dst + stride, T(0));
+  }
+  std::fill(buffer + (std::size_t)rows_ * stride, buffer + capacity, T(0));
+  int rows = rows_, cols = cols_;
+  clearMatrix();
+  rows_ = rows;
+  cols_ = cols;
+  matrix_ = buffer;
+  stride_ = stride;
+  capacity_ = capacity;
+}
+
+template class S21BasicMatrix<float>;
+template class S21BasicMatrix<double>;
+template class S21BasicMatrix<long double>;
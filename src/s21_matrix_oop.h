@@ -1,59 +1,582 @@
 #ifndef SRC_S21_MATRIX_OOP_H_
 #define SRC_S21_MATRIX_OOP_H_
 
+#include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <iostream>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
-#define EPS 1e-6
+#include "s21_matrix_expr.h"
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_memory.h"
+#include "s21_matrix_view.h"
 
-class S21Matrix {
+// Tolerance of EqMatrix, operator== and the singularity checks, per
+// element type.
+template <typename T>
+struct S21MatrixTraits;
+
+template <>
+struct S21MatrixTraits<float> {
+  static constexpr float kEpsilon = 1e-4f;
+};
+
+template <>
+struct S21MatrixTraits<double> {
+  static constexpr double kEpsilon = 1e-6;
+};
+
+template <>
+struct S21MatrixTraits<long double> {
+  static constexpr long double kEpsilon = 1e-9L;
+};
+
+// Tolerance of S21Matrix, kept under its old name.
+inline constexpr double EPS = S21MatrixTraits<double>::kEpsilon;
+
+template <typename T>
+class S21BasicMatrixLU;
+template <typename T>
+class S21BasicMatrixQR;
+template <typename T>
+class S21BasicMatrixCholesky;
+
+// Contiguous view of one matrix row in the spirit of std::span: indexing
+// is unchecked (asserted in debug builds) and it supports range-for.
+template <typename T>
+class S21RowSpan {
  public:
-  S21Matrix();
-  S21Matrix(int rows, int cols);
-  S21Matrix(const S21Matrix& other);
-  S21Matrix(S21Matrix&& other) noexcept;
-  ~S21Matrix();
-
-  bool operator==(const S21Matrix& other) const;
-  S21Matrix& operator=(const S21Matrix& other);
-
-  double& operator()(int i, int j);
-  const double& operator()(int rows, int cols) const;
-
-  S21Matrix operator+(const S21Matrix& other) const;
-  S21Matrix operator-(const S21Matrix& other) const;
-  S21Matrix operator+=(const S21Matrix& other);
-  S21Matrix operator-=(const S21Matrix& other);
-
-  S21Matrix operator*(const double multiplier) const;
-  S21Matrix operator*(const S21Matrix& other);
-  S21Matrix operator*=(const double multiplier);
-  S21Matrix operator*=(const S21Matrix& other);
-
-  bool EqMatrix(const S21Matrix& other) const;
-  void SumMatrix(const S21Matrix& other);
-  void SubMatrix(const S21Matrix& other);
-  void MulNumber(const double multiplier);
-  void MulMatrix(const S21Matrix& other);
-  S21Matrix Transpose() const;
-  S21Matrix CalcComplements() const;
-  double Determinant() const;
-  S21Matrix InverseMatrix() const;
+  S21RowSpan(T* data, int size) noexcept : data_(data), size_(size) {}
+
+  T* data() const noexcept { return data_; }
+  int size() const noexcept { return size_; }
+  T& operator[](int j) const noexcept {
+    assert(j >= 0 && j < size_);
+    return data_[j];
+  }
+  T* begin() const noexcept { return data_; }
+  T* end() const noexcept { return data_ + size_; }
+
+ private:
+  T* data_;
+  int size_;
+};
+
+// Dense matrix of float, double or long double elements; S21Matrix is the
+// double one. Element-wise operators (+, -, unary -, scalar * and /,
+// S21MulElements) are the lazy ones from s21_matrix_expr.h; the matrix
+// product is eager.
+template <typename T>
+class S21BasicMatrix : public S21MatrixExpr<S21BasicMatrix<T>> {
+ public:
+  using value_type = T;
+
+  S21BasicMatrix();
+  S21BasicMatrix(int rows, int cols);
+  // Allocates from resource instead of the current one of this thread.
+  S21BasicMatrix(int rows, int cols, std::pmr::memory_resource* resource);
+  S21BasicMatrix(const S21BasicMatrix& other);
+  S21BasicMatrix(S21BasicMatrix&& other) noexcept;
+  // Evaluates an element-wise expression in a single pass.
+  template <typename Expr>
+  S21BasicMatrix(const S21MatrixExpr<Expr>& expr);
+  ~S21BasicMatrix();
+
+  bool operator==(const S21BasicMatrix& other) const;
+  S21BasicMatrix& operator=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator=(S21BasicMatrix&& other);
+  template <typename Expr>
+  S21BasicMatrix& operator=(const S21MatrixExpr<Expr>& expr);
+
+  T& operator()(int i, int j);
+  const T& operator()(int rows, int cols) const;
+
+  // Element access without bounds checks, for hot loops; out-of-range
+  // indices are only caught by assert in debug builds.
+  T& at_unchecked(int i, int j) noexcept {
+    assert(i >= 0 && i < rows_ && j >= 0 && j < cols_);
+    return matrix_[(std::size_t)i * stride() + j];
+  }
+  const T& at_unchecked(int i, int j) const noexcept {
+    assert(i >= 0 && i < rows_ && j >= 0 && j < cols_);
+    return matrix_[(std::size_t)i * stride() + j];
+  }
+
+  // Row i as a span; the row index is checked once, the elements are not.
+  S21RowSpan<T> row(int i) {
+    checkRow(i);
+    return S21RowSpan<T>(matrix_ + (std::size_t)i * stride(), cols_);
+  }
+  S21RowSpan<const T> row(int i) const {
+    checkRow(i);
+    return S21RowSpan<const T>(matrix_ + (std::size_t)i * stride(), cols_);
+  }
+
+  S21BasicMatrix& operator+=(const S21BasicMatrix& other);
+  S21BasicMatrix& operator-=(const S21BasicMatrix& other);
+  template <typename Expr>
+  S21BasicMatrix& operator+=(const S21MatrixExpr<Expr>& expr);
+  template <typename Expr>
+  S21BasicMatrix& operator-=(const S21MatrixExpr<Expr>& expr);
 
+  S21BasicMatrix operator*(const S21BasicMatrix& other) const;
+  S21BasicMatrix& operator*=(const T multiplier);
+  S21BasicMatrix& operator*=(const S21BasicMatrix& other);
+
+  bool EqMatrix(const S21BasicMatrix& other) const;
+  void SumMatrix(const S21BasicMatrix& other);
+  void SubMatrix(const S21BasicMatrix& other);
+  void MulNumber(const T multiplier);
+  void MulMatrix(const S21BasicMatrix& other);
+  // With a given algorithm instead of S21GetMulAlgorithm().
+  void MulMatrix(const S21BasicMatrix& other, S21MulAlgorithm algorithm);
+  S21BasicMatrix Transpose() const;
+  // Transposes without a second buffer: tile swaps for square matrices,
+  // cycle following (plus a one-bit-per-element bitmap) for the others.
+  void TransposeInPlace();
+  S21BasicMatrix CalcComplements() const;
+  T Determinant() const;
+  S21BasicMatrix InverseMatrix() const;
+  S21BasicMatrixLU<T> LU() const;
+  S21BasicMatrixQR<T> QR() const;
+  S21BasicMatrixCholesky<T> Cholesky() const;
+  S21BasicMatrix Solve(const S21BasicMatrix& b) const;
+
+  // Binary files (format in s21_matrix_io.h). LoadBinary converts from the
+  // element type stored in the file. MapBinary maps the file instead of
+  // reading it: opening is instant whatever the size, pages are read on
+  // first access, and the file itself is never modified (writes to the
+  // matrix go to private copies of the touched pages). It needs a
+  // row-major file of exactly this element type and checks the payload
+  // checksum only when asked to, since that reads the whole file.
+  void SaveBinary(const std::string& path) const;
+  static S21BasicMatrix LoadBinary(const std::string& path);
+  static S21BasicMatrix MapBinary(const std::string& path,
+                                  bool verify = false);
+  // Text files with one row per line and dimensions taken from the file;
+  // blank lines are skipped. FromCSV splits rows at delimiter, FromText at
+  // runs of spaces and tabs. The file is mapped and chunks of lines are
+  // parsed in parallel straight into the matrix. ToCSV and ToText write the
+  // shortest text that reads back as the same value. Both directions throw
+  // std::runtime_error on I/O errors and malformed files.
+  static S21BasicMatrix FromCSV(const std::string& path,
+                                char delimiter = ',');
+  static S21BasicMatrix FromText(const std::string& path);
+  void ToCSV(const std::string& path, char delimiter = ',') const;
+  void ToText(const std::string& path) const;
+
+  // Resizing keeps the elements that stay and zero-fills the new ones. Like
+  // std::vector, the buffer has room for more rows (getRowCapacity()) and
+  // more columns (getColCapacity(), the stride) than are in use: shrinking
+  // only changes the size, and growing past the capacity at least doubles
+  // it, so appending rows or columns one at a time is amortized linear.
   void setRows(int rows);
   int getRows() const;
   void setCols(int cols);
   int getCols() const;
+  // Makes room for rows x cols elements without further reallocation.
+  void reserve(int rows, int cols);
+  // Releases the unused capacity.
+  void shrink_to_fit();
+  int getRowCapacity() const noexcept {
+    return stride_ == 0 ? 0 : (int)(capacity_ / stride_);
+  }
+  int getColCapacity() const noexcept { return stride_; }
+  // Adds a row (column) of values at the end; values must have as many
+  // elements as the matrix has columns (rows).
+  void AppendRow(const std::vector<T>& values);
+  void AppendCol(const std::vector<T>& values);
+
+  // Views of the elements (s21_matrix_view.h), valid until the matrix is
+  // resized or destroyed. Minor(row, col) leaves out a row and a column.
+  S21BasicMatrixView<T> view() noexcept {
+    return S21BasicMatrixView<T>(matrix_, rows_, cols_, stride());
+  }
+  S21BasicMatrixView<const T> view() const noexcept {
+    return S21BasicMatrixView<const T>(matrix_, rows_, cols_, stride());
+  }
+  S21BasicMatrixView<T> block(int row, int col, int rows, int cols) {
+    return view().block(row, col, rows, cols);
+  }
+  S21BasicMatrixView<const T> block(int row, int col, int rows,
+                                    int cols) const {
+    return view().block(row, col, rows, cols);
+  }
+  S21BasicMatrixView<T> Minor(int row, int col) {
+    return view().Minor(row, col);
+  }
+  S21BasicMatrixView<const T> Minor(int row, int col) const {
+    return view().Minor(row, col);
+  }
+
+  // Row-major storage: element (i, j) lives at data()[i * stride() + j],
+  // where stride() >= getCols() is the column capacity. The buffer is a
+  // single block aligned to kAlignment bytes.
+  T* data() noexcept { return matrix_; }
+  const T* data() const noexcept { return matrix_; }
+  int stride() const noexcept { return stride_; }
+  std::pmr::memory_resource* getResource() const noexcept {
+    return resource_;
+  }
+
+  static constexpr std::size_t kAlignment = 64;
 
  private:
   int rows_, cols_;
-  double** matrix_;
+  T* matrix_;
+  std::pmr::memory_resource* resource_;
+  // Elements per row in the buffer, and elements in the whole buffer.
+  int stride_ = 0;
+  std::size_t capacity_ = 0;
 
-  void allocateMatrix();
+  // With zero == false the new buffer is left uninitialized for callers
+  // that overwrite every element anyway.
+  S21BasicMatrix(int rows, int cols, bool zero);
+  // Takes over buffer, which resource will be asked to deallocate.
+  S21BasicMatrix(int rows, int cols, T* buffer,
+                 std::pmr::memory_resource* resource);
+  // Allocates a buffer of exactly rows_ x cols_ elements.
+  void allocateMatrix(bool zero = true);
   void clearMatrix();
-  void copyMatrix(const S21Matrix& other);
-  S21Matrix Minor(const S21Matrix& other, int row, int col) const;
+  // Moves the elements to a buffer of row_capacity rows of stride elements,
+  // zero-filling the rest of it.
+  void reallocate(int row_capacity, int stride);
+  void checkRow(int i) const;
+  void copyMatrix(const S21BasicMatrix& other);
+  S21BasicMatrix RankDeficientComplements() const;
+
+  // this(i, j) = op(this(i, j), expr(i, j)) over all elements, in row ranges
+  // on the thread pool for large matrices. expr may read this(i, j) itself,
+  // which is read before it is written; when it reads this matrix through
+  // another mapping, as A.view().Transpose() does, it is evaluated into a
+  // temporary first.
+  template <typename Op, typename Expr>
+  void AssignExpr(const Expr& source);
+};
+
+// Member definitions live in the .cpp files, instantiated for these three.
+extern template class S21BasicMatrix<float>;
+extern template class S21BasicMatrix<double>;
+extern template class S21BasicMatrix<long double>;
+
+using S21MatrixF = S21BasicMatrix<float>;
+using S21Matrix = S21BasicMatrix<double>;
+using S21MatrixLD = S21BasicMatrix<long double>;
+
+template <typename T>
+template <typename Expr>
+S21BasicMatrix<T>::S21BasicMatrix(const S21MatrixExpr<Expr>& expr)
+    : rows_(expr.derived().getRows()),
+      cols_(expr.derived().getCols()),
+      matrix_(nullptr),
+      resource_(S21GetMatrixResource()) {
+  static_assert(std::is_same<T, typename Expr::value_type>::value,
+                "Expression of a different element type");
+  allocateMatrix(false);
+  AssignExpr<S21ExprAssign>(expr.derived());
+}
+
+template <typename T>
+template <typename Expr>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator=(
+    const S21MatrixExpr<Expr>& expr) {
+  const Expr& source = expr.derived();
+  if (rows_ != source.getRows() || cols_ != source.getCols()) {
+    // The expression may still read this matrix through a view, as in
+    // A = A.Minor(0, 0), so it is evaluated into a new buffer first.
+    return *this = S21BasicMatrix(source);
+  }
+  AssignExpr<S21ExprAssign>(source);
+  return *this;
+}
+
+template <typename T>
+template <typename Expr>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator+=(
+    const S21MatrixExpr<Expr>& expr) {
+  if (rows_ != expr.derived().getRows() || cols_ != expr.derived().getCols())
+    throw std::invalid_argument("Different dimension of matrices");
+  AssignExpr<S21ExprPlus>(expr.derived());
+  return *this;
+}
+
+template <typename T>
+template <typename Expr>
+S21BasicMatrix<T>& S21BasicMatrix<T>::operator-=(
+    const S21MatrixExpr<Expr>& expr) {
+  if (rows_ != expr.derived().getRows() || cols_ != expr.derived().getCols())
+    throw std::invalid_argument("Different dimension of matrices");
+  AssignExpr<S21ExprMinus>(expr.derived());
+  return *this;
+}
+
+template <typename T>
+template <typename Op, typename Expr>
+void S21BasicMatrix<T>::AssignExpr(const Expr& source) {
+  static_assert(std::is_same<T, typename Expr::value_type>::value,
+                "Expression of a different element type");
+  typename S21ExprOperand<Expr>::type expr(source);
+  if (expr.Conflicts(S21BasicMatrixView<const T>(matrix_, rows_, cols_,
+                                                 stride()))) {
+    S21BasicMatrix evaluated(source);
+    return AssignExpr<Op>(evaluated);
+  }
+  S21ParallelRows(rows_, cols_, [this, &expr](long first, long last) {
+    T* matrix = matrix_;
+    std::size_t row_stride = stride();
+    int cols = cols_;
+    for (long i = first; i < last; i++) {
+      T* row = matrix + i * row_stride;
+      for (int j = 0; j < cols; j++)
+        row[j] = Op::Apply(row[j], expr.Coeff((int)i, j));
+    }
+  });
+}
+
+// Materializes the operands of a matrix product: matrices are used as they
+// are, expressions are evaluated once.
+template <typename T>
+const S21BasicMatrix<T>& S21Evaluate(const S21BasicMatrix<T>& matrix) {
+  return matrix;
+}
+
+template <typename T>
+S21BasicMatrixView<const T> S21Evaluate(const S21BasicMatrixView<T>& view) {
+  return view;
+}
+
+template <typename Expr>
+S21BasicMatrix<typename Expr::value_type> S21Evaluate(
+    const S21MatrixExpr<Expr>& expr) {
+  return S21BasicMatrix<typename Expr::value_type>(expr);
+}
+
+// Read-only view of an evaluated operand.
+template <typename T>
+S21BasicMatrixView<const T> S21ViewOf(const S21BasicMatrix<T>& matrix) {
+  return matrix.view();
+}
+
+template <typename T>
+S21BasicMatrixView<const T> S21ViewOf(const S21BasicMatrixView<T>& view) {
+  return view;
+}
+
+template <typename Lhs, typename Rhs>
+S21BasicMatrix<typename Lhs::value_type> operator*(
+    const S21MatrixExpr<Lhs>& lhs, const S21MatrixExpr<Rhs>& rhs) {
+  return S21MulViews(S21ViewOf(S21Evaluate(lhs.derived())),
+                     S21ViewOf(S21Evaluate(rhs.derived())));
+}
+
+// Without this, matrix * expression would be ambiguous between the member
+// product (converting the expression) and the template above.
+template <typename T, typename Rhs>
+S21BasicMatrix<T> operator*(const S21BasicMatrix<T>& lhs,
+                            const S21MatrixExpr<Rhs>& rhs) {
+  return S21MulViews(lhs.view(), S21ViewOf(S21Evaluate(rhs.derived())));
+}
+
+// Operators taking a temporary matrix write the result into its buffer
+// instead of allocating a new one: in `A.Transpose() + B` or `A * B - C` the
+// only allocation is the one made by the temporary itself.
+template <typename T, typename Rhs>
+S21BasicMatrix<T> operator+(S21BasicMatrix<T>&& lhs,
+                            const S21MatrixExpr<Rhs>& rhs) {
+  lhs += rhs;
+  return std::move(lhs);
+}
+
+template <typename T, typename Lhs>
+S21BasicMatrix<T> operator+(const S21MatrixExpr<Lhs>& lhs,
+                            S21BasicMatrix<T>&& rhs) {
+  rhs += lhs;
+  return std::move(rhs);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator+(S21BasicMatrix<T>&& lhs, S21BasicMatrix<T>&& rhs) {
+  lhs += rhs;
+  return std::move(lhs);
+}
+
+template <typename T, typename Rhs>
+S21BasicMatrix<T> operator-(S21BasicMatrix<T>&& lhs,
+                            const S21MatrixExpr<Rhs>& rhs) {
+  lhs -= rhs;
+  return std::move(lhs);
+}
+
+template <typename T, typename Lhs>
+S21BasicMatrix<T> operator-(const S21MatrixExpr<Lhs>& lhs,
+                            S21BasicMatrix<T>&& rhs) {
+  const S21BasicMatrix<T>& right = rhs;
+  rhs = lhs - right;
+  return std::move(rhs);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator-(S21BasicMatrix<T>&& lhs, S21BasicMatrix<T>&& rhs) {
+  lhs -= rhs;
+  return std::move(lhs);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator-(S21BasicMatrix<T>&& matrix) {
+  matrix *= T(-1);
+  return std::move(matrix);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator*(S21BasicMatrix<T>&& matrix,
+                            typename S21BasicMatrix<T>::value_type multiplier) {
+  matrix *= multiplier;
+  return std::move(matrix);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator*(typename S21BasicMatrix<T>::value_type multiplier,
+                            S21BasicMatrix<T>&& matrix) {
+  matrix *= multiplier;
+  return std::move(matrix);
+}
+
+template <typename T>
+S21BasicMatrix<T> operator/(S21BasicMatrix<T>&& matrix,
+                            typename S21BasicMatrix<T>::value_type divisor) {
+  const S21BasicMatrix<T>& source = matrix;
+  matrix = source / divisor;
+  return std::move(matrix);
+}
+
+// Compares lazily, without materializing either side, with the EqMatrix
+// tolerance.
+template <typename Lhs, typename Rhs>
+bool S21ExprEqual(const Lhs& lhs, const Rhs& rhs) {
+  using T = typename Lhs::value_type;
+  if (lhs.getRows() != rhs.getRows() || lhs.getCols() != rhs.getCols())
+    return false;
+  typename S21ExprOperand<Lhs>::type left(lhs);
+  typename S21ExprOperand<Rhs>::type right(rhs);
+  for (int i = 0; i < lhs.getRows(); i++)
+    for (int j = 0; j < lhs.getCols(); j++)
+      if (std::abs(left.Coeff(i, j) - right.Coeff(i, j)) >
+          S21MatrixTraits<T>::kEpsilon)
+        return false;
+  return true;
+}
+
+template <typename Lhs, typename Rhs>
+bool operator==(const S21MatrixExpr<Lhs>& lhs, const S21MatrixExpr<Rhs>& rhs) {
+  return S21ExprEqual(lhs.derived(), rhs.derived());
+}
+
+template <typename T, typename Rhs>
+bool operator==(const S21BasicMatrix<T>& lhs, const S21MatrixExpr<Rhs>& rhs) {
+  return S21ExprEqual(lhs, rhs.derived());
+}
+
+// LU factorization with partial pivoting, P * A = L * U. L (unit diagonal)
+// and U are packed into a single matrix; the object can be kept around and
+// reused for any number of solves against the same A.
+template <typename T>
+class S21BasicMatrixLU {
+ public:
+  explicit S21BasicMatrixLU(const S21BasicMatrix<T>& matrix);
+
+  int getSize() const;
+  bool IsSingular() const;
+  T Determinant() const;
+  S21BasicMatrix<T> Solve(const S21BasicMatrix<T>& b) const;
+  S21BasicMatrix<T> InverseMatrix() const;
+
+  const S21BasicMatrix<T>& getLU() const;
+  const std::vector<int>& getPivots() const;
+
+ private:
+  S21BasicMatrix<T> lu_;
+  std::vector<int> pivots_;
+  int sign_;
+  bool singular_;
 };
 
+extern template class S21BasicMatrixLU<float>;
+extern template class S21BasicMatrixLU<double>;
+extern template class S21BasicMatrixLU<long double>;
+
+using S21MatrixLU = S21BasicMatrixLU<double>;
+
+// Householder QR with column pivoting, A * P = Q * R, for any m x n matrix.
+// Columns are chosen by largest remaining norm, so |R(k, k)| does not
+// increase along the diagonal and the factorization reveals the numerical
+// rank. R is kept in the upper triangle of getQR(), the Householder vectors
+// (unit leading entry implied) below it; Q is only ever applied, never
+// formed.
+template <typename T>
+class S21BasicMatrixQR {
+ public:
+  explicit S21BasicMatrixQR(const S21BasicMatrix<T>& matrix);
+
+  // Number of |R(k, k)| above max(m, n) * epsilon * |R(0, 0)|.
+  int getRank() const;
+  // Column k of A * P is column getPermutation()[k] of A.
+  const std::vector<int>& getPermutation() const;
+  const S21BasicMatrix<T>& getQR() const;
+  // det(P) * det(Q), each +1 or -1.
+  int getSign() const;
+
+  // Q * b and Q^T * b for b with m rows.
+  S21BasicMatrix<T> MultiplyQ(const S21BasicMatrix<T>& b) const;
+  S21BasicMatrix<T> MultiplyQTransposed(const S21BasicMatrix<T>& b) const;
+  // Least-squares solution of A * X = b (exact for consistent systems).
+  // With rank r < n only the first r columns of A * P are used, the other
+  // unknowns are set to zero.
+  S21BasicMatrix<T> Solve(const S21BasicMatrix<T>& b) const;
+
+ private:
+  S21BasicMatrix<T> qr_;
+  std::vector<T> tau_;
+  std::vector<int> permutation_;
+  int sign_;
+  int rank_;
+
+  // b = H_k * b for reflector k.
+  void ApplyReflector(int k, S21BasicMatrix<T>& b) const;
+};
+
+extern template class S21BasicMatrixQR<float>;
+extern template class S21BasicMatrixQR<double>;
+extern template class S21BasicMatrixQR<long double>;
+
+using S21MatrixQR = S21BasicMatrixQR<double>;
+
+// Cholesky factorization A = L * L^T of a symmetric positive definite
+// matrix, half the work of LU and stable without pivoting. Only the lower
+// triangle of A is read. Throws if A is not positive definite.
+template <typename T>
+class S21BasicMatrixCholesky {
+ public:
+  explicit S21BasicMatrixCholesky(const S21BasicMatrix<T>& matrix);
+
+  int getSize() const;
+  T Determinant() const;
+  S21BasicMatrix<T> Solve(const S21BasicMatrix<T>& b) const;
+  // L in the lower triangle, zeros above it.
+  const S21BasicMatrix<T>& getL() const;
+
+ private:
+  S21BasicMatrix<T> l_;
+};
+
+extern template class S21BasicMatrixCholesky<float>;
+extern template class S21BasicMatrixCholesky<double>;
+extern template class S21BasicMatrixCholesky<long double>;
+
+using S21MatrixCholesky = S21BasicMatrixCholesky<double>;
+
 #endif  // SRC_S21_MATRIX_OOP_H_
@@ -0,0 +1,190 @@
+#include "s21_matrix_oop.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+template <typename T>
+S21BasicMatrixQR<T>::S21BasicMatrixQR(const S21BasicMatrix<T>& matrix)
+    : qr_(matrix), tau_(), permutation_(), sign_(1), rank_(0) {
+  int m = qr_.getRows();
+  int n = qr_.getCols();
+  int steps = std::min(m, n);
+  std::size_t stride = qr_.stride();
+  T* a = qr_.data();
+  tau_.assign(steps, T(0));
+  permutation_.resize(n);
+  for (int j = 0; j < n; j++) permutation_[j] = j;
+
+  // Squared norms of the columns below the current row; recomputed in the
+  // same sweep that applies each reflector, so no downdating is needed.
+  std::vector<T> norms(n, T(0));
+  std::vector<T> w(n);
+  for (int i = 0; i < m; i++)
+    for (int j = 0; j < n; j++)
+      norms[j] += a[i * stride + j] * a[i * stride + j];
+
+  for (int k = 0; k < steps; k++) {
+    int pivot = (int)(std::max_element(norms.begin() + k, norms.end()) -
+                      norms.begin());
+    if (pivot != k) {
+      for (int i = 0; i < m; i++)
+        std::swap(a[i * stride + k], a[i * stride + pivot]);
+      std::swap(norms[k], norms[pivot]);
+      std::swap(permutation_[k], permutation_[pivot]);
+      sign_ = -sign_;
+    }
+
+    T* row_k = a + k * stride;
+    T alpha = row_k[k];
+    T below = 0;
+    for (int i = k + 1; i < m; i++)
+      below += a[i * stride + k] * a[i * stride + k];
+    if (below == T(0)) {
+      // Already zero below the diagonal: H = I, only row k leaves the norms.
+      for (int j = k + 1; j < n; j++)
+        norms[j] = std::max(T(0), norms[j] - row_k[j] * row_k[j]);
+      continue;
+    }
+
+    T beta = -std::copysign(std::sqrt(alpha * alpha + below), alpha);
+    T tau = (beta - alpha) / beta;
+    T scale = T(1) / (alpha - beta);
+    for (int i = k + 1; i < m; i++) a[i * stride + k] *= scale;
+    row_k[k] = beta;
+    tau_[k] = tau;
+    sign_ = -sign_;
+
+    // Trailing columns: w = v^T * A, then A -= tau * v * w, row by row so
+    // that every pass runs over contiguous memory.
+    std::copy(row_k + k + 1, row_k + n, w.begin() + k + 1);
+    for (int i = k + 1; i < m; i++) {
+      const T* row_i = a + i * stride;
+      T v = row_i[k];
+      for (int j = k + 1; j < n; j++) w[j] += v * row_i[j];
+    }
+    for (int j = k + 1; j < n; j++) {
+      row_k[j] -= tau * w[j];
+      norms[j] = 0;
+    }
+    for (int i = k + 1; i < m; i++) {
+      T* row_i = a + i * stride;
+      T v = tau * row_i[k];
+      for (int j = k + 1; j < n; j++) {
+        row_i[j] -= v * w[j];
+        norms[j] += row_i[j] * row_i[j];
+      }
+    }
+  }
+
+  if (steps > 0) {
+    T tolerance = std::max(m, n) * std::numeric_limits<T>::epsilon() *
+                  std::abs(a[0]);
+    while (rank_ < steps && std::abs(a[rank_ * stride + rank_]) > tolerance)
+      rank_++;
+  }
+}
+
+template <typename T>
+int S21BasicMatrixQR<T>::getRank() const {
+  return rank_;
+}
+
+template <typename T>
+const std::vector<int>& S21BasicMatrixQR<T>::getPermutation() const {
+  return permutation_;
+}
+
+template <typename T>
+const S21BasicMatrix<T>& S21BasicMatrixQR<T>::getQR() const {
+  return qr_;
+}
+
+template <typename T>
+int S21BasicMatrixQR<T>::getSign() const {
+  return sign_;
+}
+
+template <typename T>
+void S21BasicMatrixQR<T>::ApplyReflector(int k, S21BasicMatrix<T>& b) const {
+  T tau = tau_[k];
+  if (tau == T(0)) return;
+  int m = qr_.getRows();
+  int columns = b.getCols();
+  std::size_t stride = qr_.stride();
+  std::size_t b_stride = b.stride();
+  const T* v = qr_.data();
+  T* x = b.data();
+
+  std::vector<T> w(x + k * b_stride, x + k * b_stride + columns);
+  for (int i = k + 1; i < m; i++) {
+    T v_i = v[i * stride + k];
+    const T* row_i = x + i * b_stride;
+    for (int j = 0; j < columns; j++) w[j] += v_i * row_i[j];
+  }
+  T* row_k = x + k * b_stride;
+  for (int j = 0; j < columns; j++) row_k[j] -= tau * w[j];
+  for (int i = k + 1; i < m; i++) {
+    T v_i = tau * v[i * stride + k];
+    T* row_i = x + i * b_stride;
+    for (int j = 0; j < columns; j++) row_i[j] -= v_i * w[j];
+  }
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrixQR<T>::MultiplyQ(
+    const S21BasicMatrix<T>& b) const {
+  if (b.getRows() != qr_.getRows())
+    throw std::invalid_argument(
+        "The number of rows of the right-hand side is not equal to the size "
+        "of the matrix");
+  S21BasicMatrix<T> result(b);
+  for (int k = (int)tau_.size() - 1; k >= 0; k--) ApplyReflector(k, result);
+  return result;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrixQR<T>::MultiplyQTransposed(
+    const S21BasicMatrix<T>& b) const {
+  if (b.getRows() != qr_.getRows())
+    throw std::invalid_argument(
+        "The number of rows of the right-hand side is not equal to the size "
+        "of the matrix");
+  S21BasicMatrix<T> result(b);
+  for (int k = 0; k < (int)tau_.size(); k++) ApplyReflector(k, result);
+  return result;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrixQR<T>::Solve(const S21BasicMatrix<T>& b) const {
+  S21BasicMatrix<T> y = MultiplyQTransposed(b);
+  int n = qr_.getCols();
+  int columns = b.getCols();
+  std::size_t stride = qr_.stride();
+  std::size_t y_stride = y.stride();
+  const T* r = qr_.data();
+  T* yd = y.data();
+
+  // Back substitution with the leading rank x rank block of R, in place in
+  // the first rows of y.
+  for (int i = rank_ - 1; i >= 0; i--) {
+    T* y_i = yd + i * y_stride;
+    const T* r_i = r + i * stride;
+    for (int k = i + 1; k < rank_; k++) {
+      const T* y_k = yd + k * y_stride;
+      for (int j = 0; j < columns; j++) y_i[j] -= r_i[k] * y_k[j];
+    }
+    for (int j = 0; j < columns; j++) y_i[j] /= r_i[i];
+  }
+
+  S21BasicMatrix<T> x(n, columns);
+  for (int k = 0; k < rank_; k++)
+    std::copy(yd + k * y_stride, yd + k * y_stride + columns,
+              x.data() + (std::size_t)permutation_[k] * x.stride());
+  return x;
+}
+
+template class S21BasicMatrixQR<float>;
+template class S21BasicMatrixQR<double>;
+template class S21BasicMatrixQR<long double>;
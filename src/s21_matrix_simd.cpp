@@ -0,0 +1,799 @@
+#include "s21_matrix_simd.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define S21_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define S21_SIMD_X86 0
+#endif
+
+namespace {
+
+// ---------------------------------------------------------------- scalar ---
+
+template <typename T>
+void AddScalar(std::size_t n, T* dst, const T* src) {
+  for (std::size_t i = 0; i < n; i++) dst[i] += src[i];
+}
+
+template <typename T>
+void SubScalar(std::size_t n, T* dst, const T* src) {
+  for (std::size_t i = 0; i < n; i++) dst[i] -= src[i];
+}
+
+template <typename T>
+void ScaleScalar(std::size_t n, T* dst, T factor) {
+  for (std::size_t i = 0; i < n; i++) dst[i] *= factor;
+}
+
+template <typename T>
+bool NearEqualScalar(std::size_t n, const T* a, const T* b, T eps) {
+  bool result = true;
+  for (std::size_t i = 0; result && i < n; i++)
+    if (std::fabs(a[i] - b[i]) > eps) result = false;
+  return result;
+}
+
+template <typename T>
+void GemmKernelScalar(int kc, const T* a, const T* b, T* ab) {
+  T acc[4][4] = {};
+  for (int p = 0; p < kc; p++) {
+    for (int i = 0; i < 4; i++)
+      for (int j = 0; j < 4; j++) acc[i][j] += a[i] * b[j];
+    a += 4;
+    b += 4;
+  }
+  std::memcpy(ab, acc, sizeof(acc));
+}
+
+template <typename T>
+const S21SimdKernels<T> kScalarKernels = {
+    S21SimdLevel::kScalar, "scalar", AddScalar<T>, SubScalar<T>, ScaleScalar<T>,
+    NearEqualScalar<T>,    4,        4,            GemmKernelScalar<T>,
+};
+
+#if S21_SIMD_X86
+
+// ------------------------------------------------------------------ SSE2 ---
+
+__attribute__((target("sse2"))) void AddSse2(std::size_t n, double* dst,
+                                             const double* src) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_pd(dst + i,
+                  _mm_add_pd(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i)));
+    _mm_storeu_pd(dst + i + 2, _mm_add_pd(_mm_loadu_pd(dst + i + 2),
+                                          _mm_loadu_pd(src + i + 2)));
+  }
+  for (; i < n; i++) dst[i] += src[i];
+}
+
+__attribute__((target("sse2"))) void SubSse2(std::size_t n, double* dst,
+                                             const double* src) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_pd(dst + i,
+                  _mm_sub_pd(_mm_loadu_pd(dst + i), _mm_loadu_pd(src + i)));
+    _mm_storeu_pd(dst + i + 2, _mm_sub_pd(_mm_loadu_pd(dst + i + 2),
+                                          _mm_loadu_pd(src + i + 2)));
+  }
+  for (; i < n; i++) dst[i] -= src[i];
+}
+
+__attribute__((target("sse2"))) void ScaleSse2(std::size_t n, double* dst,
+                                               double factor) {
+  __m128d f = _mm_set1_pd(factor);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    _mm_storeu_pd(dst + i, _mm_mul_pd(_mm_loadu_pd(dst + i), f));
+    _mm_storeu_pd(dst + i + 2, _mm_mul_pd(_mm_loadu_pd(dst + i + 2), f));
+  }
+  for (; i < n; i++) dst[i] *= factor;
+}
+
+__attribute__((target("sse2"))) bool NearEqualSse2(std::size_t n,
+                                                   const double* a,
+                                                   const double* b,
+                                                   double eps) {
+  __m128d sign = _mm_set1_pd(-0.0);
+  __m128d limit = _mm_set1_pd(eps);
+  std::size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    __m128d diff = _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+    if (_mm_movemask_pd(_mm_cmpgt_pd(_mm_andnot_pd(sign, diff), limit)))
+      return false;
+  }
+  return NearEqualScalar(n - i, a + i, b + i, eps);
+}
+
+// 4 x 4 tile in eight 2-wide accumulators.
+__attribute__((target("sse2"))) void GemmKernelSse2(int kc, const double* a,
+                                                    const double* b,
+                                                    double* ab) {
+  __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd();
+  __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+  __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd();
+  __m128d c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+  for (int p = 0; p < kc; p++) {
+    __m128d b0 = _mm_loadu_pd(b);
+    __m128d b1 = _mm_loadu_pd(b + 2);
+    __m128d a0 = _mm_set1_pd(a[0]);
+    __m128d a1 = _mm_set1_pd(a[1]);
+    c00 = _mm_add_pd(c00, _mm_mul_pd(a0, b0));
+    c01 = _mm_add_pd(c01, _mm_mul_pd(a0, b1));
+    c10 = _mm_add_pd(c10, _mm_mul_pd(a1, b0));
+    c11 = _mm_add_pd(c11, _mm_mul_pd(a1, b1));
+    __m128d a2 = _mm_set1_pd(a[2]);
+    __m128d a3 = _mm_set1_pd(a[3]);
+    c20 = _mm_add_pd(c20, _mm_mul_pd(a2, b0));
+    c21 = _mm_add_pd(c21, _mm_mul_pd(a2, b1));
+    c30 = _mm_add_pd(c30, _mm_mul_pd(a3, b0));
+    c31 = _mm_add_pd(c31, _mm_mul_pd(a3, b1));
+    a += 4;
+    b += 4;
+  }
+  _mm_storeu_pd(ab + 0, c00);
+  _mm_storeu_pd(ab + 2, c01);
+  _mm_storeu_pd(ab + 4, c10);
+  _mm_storeu_pd(ab + 6, c11);
+  _mm_storeu_pd(ab + 8, c20);
+  _mm_storeu_pd(ab + 10, c21);
+  _mm_storeu_pd(ab + 12, c30);
+  _mm_storeu_pd(ab + 14, c31);
+}
+
+const S21SimdKernels<double> kSse2Kernels = {
+    S21SimdLevel::kSse2, "sse2", AddSse2, SubSse2,        ScaleSse2,
+    NearEqualSse2,       4,      4,       GemmKernelSse2,
+};
+
+__attribute__((target("sse2"))) void AddSse2F(std::size_t n, float* dst,
+                                              const float* src) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i,
+                  _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+  for (; i < n; i++) dst[i] += src[i];
+}
+
+__attribute__((target("sse2"))) void SubSse2F(std::size_t n, float* dst,
+                                              const float* src) {
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i,
+                  _mm_sub_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+  for (; i < n; i++) dst[i] -= src[i];
+}
+
+__attribute__((target("sse2"))) void ScaleSse2F(std::size_t n, float* dst,
+                                                float factor) {
+  __m128 f = _mm_set1_ps(factor);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(dst + i), f));
+  for (; i < n; i++) dst[i] *= factor;
+}
+
+__attribute__((target("sse2"))) bool NearEqualSse2F(std::size_t n,
+                                                    const float* a,
+                                                    const float* b,
+                                                    float eps) {
+  __m128 sign = _mm_set1_ps(-0.0f);
+  __m128 limit = _mm_set1_ps(eps);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m128 diff = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+    if (_mm_movemask_ps(_mm_cmpgt_ps(_mm_andnot_ps(sign, diff), limit)))
+      return false;
+  }
+  return NearEqualScalar(n - i, a + i, b + i, eps);
+}
+
+// 4 x 8 float tile in eight 4-wide accumulators.
+__attribute__((target("sse2"))) void GemmKernelSse2F(int kc, const float* a,
+                                                     const float* b,
+                                                     float* ab) {
+  __m128 c00 = _mm_setzero_ps(), c01 = _mm_setzero_ps();
+  __m128 c10 = _mm_setzero_ps(), c11 = _mm_setzero_ps();
+  __m128 c20 = _mm_setzero_ps(), c21 = _mm_setzero_ps();
+  __m128 c30 = _mm_setzero_ps(), c31 = _mm_setzero_ps();
+  for (int p = 0; p < kc; p++) {
+    __m128 b0 = _mm_loadu_ps(b);
+    __m128 b1 = _mm_loadu_ps(b + 4);
+    __m128 a0 = _mm_set1_ps(a[0]);
+    __m128 a1 = _mm_set1_ps(a[1]);
+    c00 = _mm_add_ps(c00, _mm_mul_ps(a0, b0));
+    c01 = _mm_add_ps(c01, _mm_mul_ps(a0, b1));
+    c10 = _mm_add_ps(c10, _mm_mul_ps(a1, b0));
+    c11 = _mm_add_ps(c11, _mm_mul_ps(a1, b1));
+    __m128 a2 = _mm_set1_ps(a[2]);
+    __m128 a3 = _mm_set1_ps(a[3]);
+    c20 = _mm_add_ps(c20, _mm_mul_ps(a2, b0));
+    c21 = _mm_add_ps(c21, _mm_mul_ps(a2, b1));
+    c30 = _mm_add_ps(c30, _mm_mul_ps(a3, b0));
+    c31 = _mm_add_ps(c31, _mm_mul_ps(a3, b1));
+    a += 4;
+    b += 8;
+  }
+  _mm_storeu_ps(ab + 0, c00);
+  _mm_storeu_ps(ab + 4, c01);
+  _mm_storeu_ps(ab + 8, c10);
+  _mm_storeu_ps(ab + 12, c11);
+  _mm_storeu_ps(ab + 16, c20);
+  _mm_storeu_ps(ab + 20, c21);
+  _mm_storeu_ps(ab + 24, c30);
+  _mm_storeu_ps(ab + 28, c31);
+}
+
+const S21SimdKernels<float> kSse2FloatKernels = {
+    S21SimdLevel::kSse2, "sse2", AddSse2F, SubSse2F,        ScaleSse2F,
+    NearEqualSse2F,      4,      8,        GemmKernelSse2F,
+};
+
+// ------------------------------------------------------------ AVX2 + FMA ---
+
+__attribute__((target("avx2,fma"))) void AddAvx2(std::size_t n, double* dst,
+                                                 const double* src) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_loadu_pd(dst + i),
+                                            _mm256_loadu_pd(src + i)));
+    _mm256_storeu_pd(dst + i + 4, _mm256_add_pd(_mm256_loadu_pd(dst + i + 4),
+                                                _mm256_loadu_pd(src + i + 4)));
+  }
+  for (; i < n; i++) dst[i] += src[i];
+}
+
+__attribute__((target("avx2,fma"))) void SubAvx2(std::size_t n, double* dst,
+                                                 const double* src) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_pd(dst + i, _mm256_sub_pd(_mm256_loadu_pd(dst + i),
+                                            _mm256_loadu_pd(src + i)));
+    _mm256_storeu_pd(dst + i + 4, _mm256_sub_pd(_mm256_loadu_pd(dst + i + 4),
+                                                _mm256_loadu_pd(src + i + 4)));
+  }
+  for (; i < n; i++) dst[i] -= src[i];
+}
+
+__attribute__((target("avx2,fma"))) void ScaleAvx2(std::size_t n, double* dst,
+                                                   double factor) {
+  __m256d f = _mm256_set1_pd(factor);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_pd(dst + i, _mm256_mul_pd(_mm256_loadu_pd(dst + i), f));
+    _mm256_storeu_pd(dst + i + 4,
+                     _mm256_mul_pd(_mm256_loadu_pd(dst + i + 4), f));
+  }
+  for (; i < n; i++) dst[i] *= factor;
+}
+
+__attribute__((target("avx2,fma"))) bool NearEqualAvx2(std::size_t n,
+                                                       const double* a,
+                                                       const double* b,
+                                                       double eps) {
+  __m256d sign = _mm256_set1_pd(-0.0);
+  __m256d limit = _mm256_set1_pd(eps);
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256d diff =
+        _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+    __m256d over =
+        _mm256_cmp_pd(_mm256_andnot_pd(sign, diff), limit, _CMP_GT_OQ);
+    if (_mm256_movemask_pd(over)) return false;
+  }
+  return NearEqualScalar(n - i, a + i, b + i, eps);
+}
+
+// 6 x 8 tile in twelve 4-wide accumulators, the classic Haswell shape: two
+// loads of B and six broadcasts feed twelve FMAs per step. The accumulators
+// are spelled out one by one; kept in an array GCC spills them every step.
+__attribute__((target("avx2,fma"))) void GemmKernelAvx2(int kc,
+                                                        const double* a,
+                                                        const double* b,
+                                                        double* ab) {
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+  __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+  for (int p = 0; p < kc; p++) {
+    __m256d b0 = _mm256_loadu_pd(b);
+    __m256d b1 = _mm256_loadu_pd(b + 4);
+    __m256d a_i = _mm256_broadcast_sd(a);
+    c00 = _mm256_fmadd_pd(a_i, b0, c00);
+    c01 = _mm256_fmadd_pd(a_i, b1, c01);
+    a_i = _mm256_broadcast_sd(a + 1);
+    c10 = _mm256_fmadd_pd(a_i, b0, c10);
+    c11 = _mm256_fmadd_pd(a_i, b1, c11);
+    a_i = _mm256_broadcast_sd(a + 2);
+    c20 = _mm256_fmadd_pd(a_i, b0, c20);
+    c21 = _mm256_fmadd_pd(a_i, b1, c21);
+    a_i = _mm256_broadcast_sd(a + 3);
+    c30 = _mm256_fmadd_pd(a_i, b0, c30);
+    c31 = _mm256_fmadd_pd(a_i, b1, c31);
+    a_i = _mm256_broadcast_sd(a + 4);
+    c40 = _mm256_fmadd_pd(a_i, b0, c40);
+    c41 = _mm256_fmadd_pd(a_i, b1, c41);
+    a_i = _mm256_broadcast_sd(a + 5);
+    c50 = _mm256_fmadd_pd(a_i, b0, c50);
+    c51 = _mm256_fmadd_pd(a_i, b1, c51);
+    a += 6;
+    b += 8;
+  }
+  _mm256_storeu_pd(ab + 0, c00);
+  _mm256_storeu_pd(ab + 4, c01);
+  _mm256_storeu_pd(ab + 8, c10);
+  _mm256_storeu_pd(ab + 12, c11);
+  _mm256_storeu_pd(ab + 16, c20);
+  _mm256_storeu_pd(ab + 20, c21);
+  _mm256_storeu_pd(ab + 24, c30);
+  _mm256_storeu_pd(ab + 28, c31);
+  _mm256_storeu_pd(ab + 32, c40);
+  _mm256_storeu_pd(ab + 36, c41);
+  _mm256_storeu_pd(ab + 40, c50);
+  _mm256_storeu_pd(ab + 44, c51);
+}
+
+const S21SimdKernels<double> kAvx2Kernels = {
+    S21SimdLevel::kAvx2, "avx2", AddAvx2, SubAvx2,        ScaleAvx2,
+    NearEqualAvx2,       6,      8,       GemmKernelAvx2,
+};
+
+__attribute__((target("avx2,fma"))) void AddAvx2F(std::size_t n, float* dst,
+                                                  const float* src) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i),
+                                            _mm256_loadu_ps(src + i)));
+  for (; i < n; i++) dst[i] += src[i];
+}
+
+__attribute__((target("avx2,fma"))) void SubAvx2F(std::size_t n, float* dst,
+                                                  const float* src) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_sub_ps(_mm256_loadu_ps(dst + i),
+                                            _mm256_loadu_ps(src + i)));
+  for (; i < n; i++) dst[i] -= src[i];
+}
+
+__attribute__((target("avx2,fma"))) void ScaleAvx2F(std::size_t n, float* dst,
+                                                    float factor) {
+  __m256 f = _mm256_set1_ps(factor);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_loadu_ps(dst + i), f));
+  for (; i < n; i++) dst[i] *= factor;
+}
+
+__attribute__((target("avx2,fma"))) bool NearEqualAvx2F(std::size_t n,
+                                                        const float* a,
+                                                        const float* b,
+                                                        float eps) {
+  __m256 sign = _mm256_set1_ps(-0.0f);
+  __m256 limit = _mm256_set1_ps(eps);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+    __m256 over =
+        _mm256_cmp_ps(_mm256_andnot_ps(sign, diff), limit, _CMP_GT_OQ);
+    if (_mm256_movemask_ps(over)) return false;
+  }
+  return NearEqualScalar(n - i, a + i, b + i, eps);
+}
+
+// 6 x 16 float tile, the same register shape as the double kernel.
+__attribute__((target("avx2,fma"))) void GemmKernelAvx2F(int kc,
+                                                         const float* a,
+                                                         const float* b,
+                                                         float* ab) {
+  __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+  __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+  __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+  __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+  __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+  __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+  for (int p = 0; p < kc; p++) {
+    __m256 b0 = _mm256_loadu_ps(b);
+    __m256 b1 = _mm256_loadu_ps(b + 8);
+    __m256 a_i = _mm256_broadcast_ss(a);
+    c00 = _mm256_fmadd_ps(a_i, b0, c00);
+    c01 = _mm256_fmadd_ps(a_i, b1, c01);
+    a_i = _mm256_broadcast_ss(a + 1);
+    c10 = _mm256_fmadd_ps(a_i, b0, c10);
+    c11 = _mm256_fmadd_ps(a_i, b1, c11);
+    a_i = _mm256_broadcast_ss(a + 2);
+    c20 = _mm256_fmadd_ps(a_i, b0, c20);
+    c21 = _mm256_fmadd_ps(a_i, b1, c21);
+    a_i = _mm256_broadcast_ss(a + 3);
+    c30 = _mm256_fmadd_ps(a_i, b0, c30);
+    c31 = _mm256_fmadd_ps(a_i, b1, c31);
+    a_i = _mm256_broadcast_ss(a + 4);
+    c40 = _mm256_fmadd_ps(a_i, b0, c40);
+    c41 = _mm256_fmadd_ps(a_i, b1, c41);
+    a_i = _mm256_broadcast_ss(a + 5);
+    c50 = _mm256_fmadd_ps(a_i, b0, c50);
+    c51 = _mm256_fmadd_ps(a_i, b1, c51);
+    a += 6;
+    b += 16;
+  }
+  _mm256_storeu_ps(ab + 0, c00);
+  _mm256_storeu_ps(ab + 8, c01);
+  _mm256_storeu_ps(ab + 16, c10);
+  _mm256_storeu_ps(ab + 24, c11);
+  _mm256_storeu_ps(ab + 32, c20);
+  _mm256_storeu_ps(ab + 40, c21);
+  _mm256_storeu_ps(ab + 48, c30);
+  _mm256_storeu_ps(ab + 56, c31);
+  _mm256_storeu_ps(ab + 64, c40);
+  _mm256_storeu_ps(ab + 72, c41);
+  _mm256_storeu_ps(ab + 80, c50);
+  _mm256_storeu_ps(ab + 88, c51);
+}
+
+const S21SimdKernels<float> kAvx2FloatKernels = {
+    S21SimdLevel::kAvx2, "avx2", AddAvx2F, SubAvx2F,        ScaleAvx2F,
+    NearEqualAvx2F,      6,      16,       GemmKernelAvx2F,
+};
+
+// --------------------------------------------------------------- AVX-512 ---
+
+__attribute__((target("avx512f"))) void AddAvx512(std::size_t n, double* dst,
+                                                  const double* src) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(dst + i, _mm512_add_pd(_mm512_loadu_pd(dst + i),
+                                            _mm512_loadu_pd(src + i)));
+  if (i < n) {
+    __mmask8 mask = (__mmask8)((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(dst + i, mask,
+                          _mm512_add_pd(_mm512_maskz_loadu_pd(mask, dst + i),
+                                        _mm512_maskz_loadu_pd(mask, src + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void SubAvx512(std::size_t n, double* dst,
+                                                  const double* src) {
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(dst + i, _mm512_sub_pd(_mm512_loadu_pd(dst + i),
+                                            _mm512_loadu_pd(src + i)));
+  if (i < n) {
+    __mmask8 mask = (__mmask8)((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(dst + i, mask,
+                          _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, dst + i),
+                                        _mm512_maskz_loadu_pd(mask, src + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512(std::size_t n,
+                                                    double* dst,
+                                                    double factor) {
+  __m512d f = _mm512_set1_pd(factor);
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8)
+    _mm512_storeu_pd(dst + i, _mm512_mul_pd(_mm512_loadu_pd(dst + i), f));
+  if (i < n) {
+    __mmask8 mask = (__mmask8)((1u << (n - i)) - 1);
+    _mm512_mask_storeu_pd(
+        dst + i, mask, _mm512_mul_pd(_mm512_maskz_loadu_pd(mask, dst + i), f));
+  }
+}
+
+__attribute__((target("avx512f"))) bool NearEqualAvx512(std::size_t n,
+                                                        const double* a,
+                                                        const double* b,
+                                                        double eps) {
+  __m512d limit = _mm512_set1_pd(eps);
+  std::size_t i = 0;
+  for (; i < n; i += 8) {
+    __mmask8 mask = n - i >= 8 ? (__mmask8)0xFF
+                               : (__mmask8)((1u << (n - i)) - 1);
+    __m512d diff = _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, a + i),
+                                 _mm512_maskz_loadu_pd(mask, b + i));
+    if (_mm512_cmp_pd_mask(_mm512_abs_pd(diff), limit, _CMP_GT_OQ))
+      return false;
+  }
+  return true;
+}
+
+// 8 x 16 tile in sixteen 8-wide accumulators, spelled out for the same
+// reason as the AVX2 kernel.
+__attribute__((target("avx512f"))) void GemmKernelAvx512(int kc,
+                                                         const double* a,
+                                                         const double* b,
+                                                         double* ab) {
+  __m512d c00 = _mm512_setzero_pd(), c01 = _mm512_setzero_pd();
+  __m512d c10 = _mm512_setzero_pd(), c11 = _mm512_setzero_pd();
+  __m512d c20 = _mm512_setzero_pd(), c21 = _mm512_setzero_pd();
+  __m512d c30 = _mm512_setzero_pd(), c31 = _mm512_setzero_pd();
+  __m512d c40 = _mm512_setzero_pd(), c41 = _mm512_setzero_pd();
+  __m512d c50 = _mm512_setzero_pd(), c51 = _mm512_setzero_pd();
+  __m512d c60 = _mm512_setzero_pd(), c61 = _mm512_setzero_pd();
+  __m512d c70 = _mm512_setzero_pd(), c71 = _mm512_setzero_pd();
+  for (int p = 0; p < kc; p++) {
+    __m512d b0 = _mm512_loadu_pd(b);
+    __m512d b1 = _mm512_loadu_pd(b + 8);
+    __m512d a_i = _mm512_set1_pd(a[0]);
+    c00 = _mm512_fmadd_pd(a_i, b0, c00);
+    c01 = _mm512_fmadd_pd(a_i, b1, c01);
+    a_i = _mm512_set1_pd(a[1]);
+    c10 = _mm512_fmadd_pd(a_i, b0, c10);
+    c11 = _mm512_fmadd_pd(a_i, b1, c11);
+    a_i = _mm512_set1_pd(a[2]);
+    c20 = _mm512_fmadd_pd(a_i, b0, c20);
+    c21 = _mm512_fmadd_pd(a_i, b1, c21);
+    a_i = _mm512_set1_pd(a[3]);
+    c30 = _mm512_fmadd_pd(a_i, b0, c30);
+    c31 = _mm512_fmadd_pd(a_i, b1, c31);
+    a_i = _mm512_set1_pd(a[4]);
+    c40 = _mm512_fmadd_pd(a_i, b0, c40);
+    c41 = _mm512_fmadd_pd(a_i, b1, c41);
+    a_i = _mm512_set1_pd(a[5]);
+    c50 = _mm512_fmadd_pd(a_i, b0, c50);
+    c51 = _mm512_fmadd_pd(a_i, b1, c51);
+    a_i = _mm512_set1_pd(a[6]);
+    c60 = _mm512_fmadd_pd(a_i, b0, c60);
+    c61 = _mm512_fmadd_pd(a_i, b1, c61);
+    a_i = _mm512_set1_pd(a[7]);
+    c70 = _mm512_fmadd_pd(a_i, b0, c70);
+    c71 = _mm512_fmadd_pd(a_i, b1, c71);
+    a += 8;
+    b += 16;
+  }
+  _mm512_storeu_pd(ab + 0, c00);
+  _mm512_storeu_pd(ab + 8, c01);
+  _mm512_storeu_pd(ab + 16, c10);
+  _mm512_storeu_pd(ab + 24, c11);
+  _mm512_storeu_pd(ab + 32, c20);
+  _mm512_storeu_pd(ab + 40, c21);
+  _mm512_storeu_pd(ab + 48, c30);
+  _mm512_storeu_pd(ab + 56, c31);
+  _mm512_storeu_pd(ab + 64, c40);
+  _mm512_storeu_pd(ab + 72, c41);
+  _mm512_storeu_pd(ab + 80, c50);
+  _mm512_storeu_pd(ab + 88, c51);
+  _mm512_storeu_pd(ab + 96, c60);
+  _mm512_storeu_pd(ab + 104, c61);
+  _mm512_storeu_pd(ab + 112, c70);
+  _mm512_storeu_pd(ab + 120, c71);
+}
+
+const S21SimdKernels<double> kAvx512Kernels = {
+    S21SimdLevel::kAvx512, "avx512", AddAvx512, SubAvx512,        ScaleAvx512,
+    NearEqualAvx512,       8,        16,        GemmKernelAvx512,
+};
+
+__attribute__((target("avx512f"))) void AddAvx512F(std::size_t n, float* dst,
+                                                   const float* src) {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_add_ps(_mm512_loadu_ps(dst + i),
+                                            _mm512_loadu_ps(src + i)));
+  if (i < n) {
+    __mmask16 mask = (__mmask16)((1u << (n - i)) - 1);
+    _mm512_mask_storeu_ps(dst + i, mask,
+                          _mm512_add_ps(_mm512_maskz_loadu_ps(mask, dst + i),
+                                        _mm512_maskz_loadu_ps(mask, src + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void SubAvx512F(std::size_t n, float* dst,
+                                                   const float* src) {
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_sub_ps(_mm512_loadu_ps(dst + i),
+                                            _mm512_loadu_ps(src + i)));
+  if (i < n) {
+    __mmask16 mask = (__mmask16)((1u << (n - i)) - 1);
+    _mm512_mask_storeu_ps(dst + i, mask,
+                          _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, dst + i),
+                                        _mm512_maskz_loadu_ps(mask, src + i)));
+  }
+}
+
+__attribute__((target("avx512f"))) void ScaleAvx512F(std::size_t n,
+                                                     float* dst,
+                                                     float factor) {
+  __m512 f = _mm512_set1_ps(factor);
+  std::size_t i = 0;
+  for (; i + 16 <= n; i += 16)
+    _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_loadu_ps(dst + i), f));
+  if (i < n) {
+    __mmask16 mask = (__mmask16)((1u << (n - i)) - 1);
+    _mm512_mask_storeu_ps(
+        dst + i, mask, _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, dst + i), f));
+  }
+}
+
+__attribute__((target("avx512f"))) bool NearEqualAvx512F(std::size_t n,
+                                                         const float* a,
+                                                         const float* b,
+                                                         float eps) {
+  __m512 limit = _mm512_set1_ps(eps);
+  std::size_t i = 0;
+  for (; i < n; i += 16) {
+    __mmask16 mask = n - i >= 16 ? (__mmask16)0xFFFF
+                                 : (__mmask16)((1u << (n - i)) - 1);
+    __m512 diff = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i),
+                                _mm512_maskz_loadu_ps(mask, b + i));
+    if (_mm512_cmp_ps_mask(_mm512_abs_ps(diff), limit, _CMP_GT_OQ))
+      return false;
+  }
+  return true;
+}
+
+// 8 x 32 float tile in sixteen 16-wide accumulators.
+__attribute__((target("avx512f"))) void GemmKernelAvx512F(int kc,
+                                                          const float* a,
+                                                          const float* b,
+                                                          float* ab) {
+  __m512 c00 = _mm512_setzero_ps(), c01 = _mm512_setzero_ps();
+  __m512 c10 = _mm512_setzero_ps(), c11 = _mm512_setzero_ps();
+  __m512 c20 = _mm512_setzero_ps(), c21 = _mm512_setzero_ps();
+  __m512 c30 = _mm512_setzero_ps(), c31 = _mm512_setzero_ps();
+  __m512 c40 = _mm512_setzero_ps(), c41 = _mm512_setzero_ps();
+  __m512 c50 = _mm512_setzero_ps(), c51 = _mm512_setzero_ps();
+  __m512 c60 = _mm512_setzero_ps(), c61 = _mm512_setzero_ps();
+  __m512 c70 = _mm512_setzero_ps(), c71 = _mm512_setzero_ps();
+  for (int p = 0; p < kc; p++) {
+    __m512 b0 = _mm512_loadu_ps(b);
+    __m512 b1 = _mm512_loadu_ps(b + 16);
+    __m512 a_i = _mm512_set1_ps(a[0]);
+    c00 = _mm512_fmadd_ps(a_i, b0, c00);
+    c01 = _mm512_fmadd_ps(a_i, b1, c01);
+    a_i = _mm512_set1_ps(a[1]);
+    c10 = _mm512_fmadd_ps(a_i, b0, c10);
+    c11 = _mm512_fmadd_ps(a_i, b1, c11);
+    a_i = _mm512_set1_ps(a[2]);
+    c20 = _mm512_fmadd_ps(a_i, b0, c20);
+    c21 = _mm512_fmadd_ps(a_i, b1, c21);
+    a_i = _mm512_set1_ps(a[3]);
+    c30 = _mm512_fmadd_ps(a_i, b0, c30);
+    c31 = _mm512_fmadd_ps(a_i, b1, c31);
+    a_i = _mm512_set1_ps(a[4]);
+    c40 = _mm512_fmadd_ps(a_i, b0, c40);
+    c41 = _mm512_fmadd_ps(a_i, b1, c41);
+    a_i = _mm512_set1_ps(a[5]);
+    c50 = _mm512_fmadd_ps(a_i, b0, c50);
+    c51 = _mm512_fmadd_ps(a_i, b1, c51);
+    a_i = _mm512_set1_ps(a[6]);
+    c60 = _mm512_fmadd_ps(a_i, b0, c60);
+    c61 = _mm512_fmadd_ps(a_i, b1, c61);
+    a_i = _mm512_set1_ps(a[7]);
+    c70 = _mm512_fmadd_ps(a_i, b0, c70);
+    c71 = _mm512_fmadd_ps(a_i, b1, c71);
+    a += 8;
+    b += 32;
+  }
+  _mm512_storeu_ps(ab + 0, c00);
+  _mm512_storeu_ps(ab + 16, c01);
+  _mm512_storeu_ps(ab + 32, c10);
+  _mm512_storeu_ps(ab + 48, c11);
+  _mm512_storeu_ps(ab + 64, c20);
+  _mm512_storeu_ps(ab + 80, c21);
+  _mm512_storeu_ps(ab + 96, c30);
+  _mm512_storeu_ps(ab + 112, c31);
+  _mm512_storeu_ps(ab + 128, c40);
+  _mm512_storeu_ps(ab + 144, c41);
+  _mm512_storeu_ps(ab + 160, c50);
+  _mm512_storeu_ps(ab + 176, c51);
+  _mm512_storeu_ps(ab + 192, c60);
+  _mm512_storeu_ps(ab + 208, c61);
+  _mm512_storeu_ps(ab + 224, c70);
+  _mm512_storeu_ps(ab + 240, c71);
+}
+
+const S21SimdKernels<float> kAvx512FloatKernels = {
+    S21SimdLevel::kAvx512, "avx512", AddAvx512F, SubAvx512F, ScaleAvx512F,
+    NearEqualAvx512F,      8,        32,         GemmKernelAvx512F,
+};
+
+#endif  // S21_SIMD_X86
+
+template <typename T>
+const S21SimdKernels<T>& KernelsFor(S21SimdLevel level);
+
+template <>
+const S21SimdKernels<double>& KernelsFor<double>(S21SimdLevel level) {
+#if S21_SIMD_X86
+  switch (level) {
+    case S21SimdLevel::kAvx512:
+      return kAvx512Kernels;
+    case S21SimdLevel::kAvx2:
+      return kAvx2Kernels;
+    case S21SimdLevel::kSse2:
+      return kSse2Kernels;
+    case S21SimdLevel::kScalar:
+      break;
+  }
+#else
+  (void)level;
+#endif
+  return kScalarKernels<double>;
+}
+
+template <>
+const S21SimdKernels<float>& KernelsFor<float>(S21SimdLevel level) {
+#if S21_SIMD_X86
+  switch (level) {
+    case S21SimdLevel::kAvx512:
+      return kAvx512FloatKernels;
+    case S21SimdLevel::kAvx2:
+      return kAvx2FloatKernels;
+    case S21SimdLevel::kSse2:
+      return kSse2FloatKernels;
+    case S21SimdLevel::kScalar:
+      break;
+  }
+#else
+  (void)level;
+#endif
+  return kScalarKernels<float>;
+}
+
+template <>
+const S21SimdKernels<long double>& KernelsFor<long double>(S21SimdLevel) {
+  return kScalarKernels<long double>;
+}
+
+S21SimdLevel LevelFromEnvironment(S21SimdLevel fallback) {
+  S21SimdLevel level = fallback;
+  const char* value = std::getenv("S21_MATRIX_SIMD");
+  if (value != nullptr) {
+    if (std::strcmp(value, "scalar") == 0) level = S21SimdLevel::kScalar;
+    if (std::strcmp(value, "sse2") == 0) level = S21SimdLevel::kSse2;
+    if (std::strcmp(value, "avx2") == 0) level = S21SimdLevel::kAvx2;
+    if (std::strcmp(value, "avx512") == 0) level = S21SimdLevel::kAvx512;
+  }
+  return level;
+}
+
+// -1 until the first call picks a level.
+std::atomic<int> active_level{-1};
+
+S21SimdLevel ActiveLevel() {
+  int level = active_level.load(std::memory_order_acquire);
+  if (level < 0)
+    level = (int)S21SetSimdLevel(LevelFromEnvironment(S21DetectSimdLevel()));
+  return (S21SimdLevel)level;
+}
+
+}  // namespace
+
+S21SimdLevel S21DetectSimdLevel() {
+  S21SimdLevel level = S21SimdLevel::kScalar;
+#if S21_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("sse2")) level = S21SimdLevel::kSse2;
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    level = S21SimdLevel::kAvx2;
+  if (__builtin_cpu_supports("avx512f")) level = S21SimdLevel::kAvx512;
+#endif
+  return level;
+}
+
+template <typename T>
+const S21SimdKernels<T>& S21GetSimdKernels() {
+  return KernelsFor<T>(ActiveLevel());
+}
+
+template const S21SimdKernels<float>& S21GetSimdKernels<float>();
+template const S21SimdKernels<double>& S21GetSimdKernels<double>();
+template const S21SimdKernels<long double>& S21GetSimdKernels<long double>();
+
+S21SimdLevel S21GetSimdLevel() { return ActiveLevel(); }
+
+S21SimdLevel S21SetSimdLevel(S21SimdLevel level) {
+  S21SimdLevel supported = S21DetectSimdLevel();
+  if (level > supported) level = supported;
+  active_level.store((int)level, std::memory_order_release);
+  return level;
+}
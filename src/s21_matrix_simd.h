@@ -0,0 +1,50 @@
+#ifndef SRC_S21_MATRIX_SIMD_H_
+#define SRC_S21_MATRIX_SIMD_H_
+
+#include <cstddef>
+
+// Instruction set levels the library carries kernels for. Every level is
+// compiled into the same binary; the best one the running CPU supports is
+// picked on first use.
+enum class S21SimdLevel { kScalar, kSse2, kAvx2, kAvx512 };
+
+// Largest register tile any GEMM micro-kernel uses (AVX-512 on floats).
+constexpr int kS21GemmMaxTile = 8 * 32;
+
+// Kernel table for one element type at one instruction set level. The
+// element-wise kernels work on n contiguous elements; nothing needs to be
+// aligned. long double has no vector instructions, so every level uses the
+// scalar kernels for it.
+template <typename T>
+struct S21SimdKernels {
+  S21SimdLevel level;
+  const char* name;
+
+  void (*add)(std::size_t n, T* dst, const T* src);
+  void (*sub)(std::size_t n, T* dst, const T* src);
+  void (*scale)(std::size_t n, T* dst, T factor);
+  // False as soon as some |a[i] - b[i]| > eps.
+  bool (*near_equal)(std::size_t n, const T* a, const T* b, T eps);
+
+  // GEMM micro-kernel: ab (gemm_mr x gemm_nr, row-major) = a * b where a is
+  // a packed gemm_mr-row panel and b a packed gemm_nr-column sliver, both
+  // kc deep.
+  int gemm_mr;
+  int gemm_nr;
+  void (*gemm_kernel)(int kc, const T* a, const T* b, T* ab);
+};
+
+// Kernels of the active level for element type T (float, double or long
+// double). The first call detects the CPU (honouring the S21_MATRIX_SIMD
+// environment variable: scalar, sse2, avx2 or avx512).
+template <typename T = double>
+const S21SimdKernels<T>& S21GetSimdKernels();
+
+S21SimdLevel S21DetectSimdLevel();
+S21SimdLevel S21GetSimdLevel();
+// Switches the active level; levels the CPU cannot run are clamped down to
+// the best supported one. Returns the level actually selected. Must not be
+// called while other threads are running matrix operations.
+S21SimdLevel S21SetSimdLevel(S21SimdLevel level);
+
+#endif  // SRC_S21_MATRIX_SIMD_H_
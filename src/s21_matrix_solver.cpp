@@ -0,0 +1,87 @@
+#include "s21_matrix_solver.h"
+
+namespace {
+
+// Symmetric with a positive diagonal: necessary for positive definiteness
+// and cheap to check before attempting Cholesky.
+template <typename T>
+bool LooksPositiveDefinite(const S21BasicMatrix<T>& a) {
+  int n = a.getRows();
+  for (int i = 0; i < n; i++) {
+    if (!(a.at_unchecked(i, i) > T(0))) return false;
+    for (int j = 0; j < i; j++)
+      if (a.at_unchecked(i, j) != a.at_unchecked(j, i)) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+template <typename T>
+S21BasicSolver<T>::S21BasicSolver(const S21BasicMatrix<T>& a,
+                                  S21SolverMethod method)
+    : method_(method), rows_(a.getRows()), cols_(a.getCols()) {
+  bool square = rows_ == cols_;
+  if (method_ == S21SolverMethod::kAuto) {
+    if (square && LooksPositiveDefinite(a)) {
+      try {
+        cholesky_.emplace(a);
+        method_ = S21SolverMethod::kCholesky;
+        return;
+      } catch (const std::invalid_argument&) {
+      }
+    }
+    if (square) {
+      lu_.emplace(a);
+      if (!lu_->IsSingular()) {
+        method_ = S21SolverMethod::kLU;
+        return;
+      }
+      lu_.reset();
+    }
+    method_ = S21SolverMethod::kQR;
+  }
+
+  switch (method_) {
+    case S21SolverMethod::kLU:
+      lu_.emplace(a);
+      if (lu_->IsSingular())
+        throw std::invalid_argument("The matrix is singular");
+      break;
+    case S21SolverMethod::kCholesky:
+      cholesky_.emplace(a);
+      break;
+    default:
+      qr_.emplace(a);
+      break;
+  }
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicSolver<T>::Solve(const S21BasicMatrix<T>& b) const {
+  if (b.getRows() != rows_)
+    throw std::invalid_argument(
+        "The number of rows of the right-hand side is not equal to the size "
+        "of the matrix");
+  if (lu_) return lu_->Solve(b);
+  if (cholesky_) return cholesky_->Solve(b);
+  return qr_->Solve(b);
+}
+
+template <typename T>
+std::vector<T> S21BasicSolver<T>::Solve(const std::vector<T>& b) const {
+  if ((int)b.size() != rows_)
+    throw std::invalid_argument(
+        "The number of rows of the right-hand side is not equal to the size "
+        "of the matrix");
+  S21BasicMatrix<T> column(rows_, 1);
+  for (int i = 0; i < rows_; i++) column.at_unchecked(i, 0) = b[i];
+  S21BasicMatrix<T> x = Solve(column);
+  std::vector<T> result(cols_);
+  for (int i = 0; i < cols_; i++) result[i] = x.at_unchecked(i, 0);
+  return result;
+}
+
+template class S21BasicSolver<float>;
+template class S21BasicSolver<double>;
+template class S21BasicSolver<long double>;
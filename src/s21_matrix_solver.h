@@ -0,0 +1,58 @@
+#ifndef SRC_S21_MATRIX_SOLVER_H_
+#define SRC_S21_MATRIX_SOLVER_H_
+
+#include <optional>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+enum class S21SolverMethod { kAuto, kLU, kCholesky, kQR };
+
+// Factors A once and solves A * X = b for any number of right-hand sides,
+// each solve costing O(n^2) per column instead of a new factorization.
+//
+// kAuto picks Cholesky for symmetric matrices with a positive diagonal
+// (falling back to LU when the factorization fails), LU for the other
+// square matrices, and QR with column pivoting for rectangular ones (least
+// squares) or when LU finds the matrix singular. An explicit method throws
+// when it does not apply: LU on a singular matrix, Cholesky on a matrix
+// that is not positive definite.
+template <typename T>
+class S21BasicSolver {
+ public:
+  explicit S21BasicSolver(const S21BasicMatrix<T>& a,
+                          S21SolverMethod method = S21SolverMethod::kAuto);
+
+  // The back-end in use, never kAuto.
+  S21SolverMethod getMethod() const noexcept { return method_; }
+  int getRows() const noexcept { return rows_; }
+  int getCols() const noexcept { return cols_; }
+
+  // b has getRows() rows; the result has getCols() rows.
+  S21BasicMatrix<T> Solve(const S21BasicMatrix<T>& b) const;
+  std::vector<T> Solve(const std::vector<T>& b) const;
+
+ private:
+  S21SolverMethod method_;
+  int rows_;
+  int cols_;
+  std::optional<S21BasicMatrixLU<T>> lu_;
+  std::optional<S21BasicMatrixCholesky<T>> cholesky_;
+  std::optional<S21BasicMatrixQR<T>> qr_;
+};
+
+extern template class S21BasicSolver<float>;
+extern template class S21BasicSolver<double>;
+extern template class S21BasicSolver<long double>;
+
+using S21Solver = S21BasicSolver<double>;
+
+// One-off solve; keep an S21BasicSolver to reuse the factorization.
+template <typename T>
+S21BasicMatrix<T> S21Solve(const S21BasicMatrix<T>& a,
+                           const S21BasicMatrix<T>& b,
+                           S21SolverMethod method = S21SolverMethod::kAuto) {
+  return S21BasicSolver<T>(a, method).Solve(b);
+}
+
+#endif  // SRC_S21_MATRIX_SOLVER_H_
@@ -0,0 +1,155 @@
+#include "s21_matrix_stats.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+namespace {
+
+// A cache line per operation, so threads running different operations do
+// not contend.
+struct alignas(64) Counters {
+  std::atomic<std::uint64_t> calls{0};
+  std::atomic<std::uint64_t> nanoseconds{0};
+  std::atomic<std::uint64_t> flops{0};
+  std::atomic<std::uint64_t> bytes_allocated{0};
+  std::atomic<std::uint64_t> bytes_copied{0};
+};
+
+Counters counters[(std::size_t)S21StatOp::kCount];
+
+thread_local S21StatScope* innermost = nullptr;
+
+const char* const kNames[] = {
+    "allocate",    "copy_construct",   "copy_assign",    "sum_matrix",
+    "sub_matrix",  "mul_number",       "mul_matrix",     "transpose",
+    "determinant", "calc_complements", "inverse_matrix", "solve",
+    "gemm",        "gemv",             "ger"};
+static_assert(sizeof(kNames) / sizeof(kNames[0]) ==
+                  (std::size_t)S21StatOp::kCount,
+              "Every operation needs a name");
+
+std::int64_t Now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Add(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+  if (value != 0) counter.fetch_add(value, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+bool S21StatsEnabled() {
+#ifdef S21_MATRIX_STATS
+  return true;
+#else
+  return false;
+#endif
+}
+
+const char* S21StatOpName(S21StatOp op) { return kNames[(std::size_t)op]; }
+
+S21MatrixStats S21GetStats() {
+  S21MatrixStats stats;
+  for (std::size_t i = 0; i < stats.ops.size(); i++) {
+    const Counters& source = counters[i];
+    S21OpStats& target = stats.ops[i];
+    target.calls = source.calls.load(std::memory_order_relaxed);
+    target.nanoseconds = source.nanoseconds.load(std::memory_order_relaxed);
+    target.flops = source.flops.load(std::memory_order_relaxed);
+    target.bytes_allocated =
+        source.bytes_allocated.load(std::memory_order_relaxed);
+    target.bytes_copied = source.bytes_copied.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void S21ResetStats() {
+  for (Counters& source : counters) {
+    source.calls.store(0, std::memory_order_relaxed);
+    source.nanoseconds.store(0, std::memory_order_relaxed);
+    source.flops.store(0, std::memory_order_relaxed);
+    source.bytes_allocated.store(0, std::memory_order_relaxed);
+    source.bytes_copied.store(0, std::memory_order_relaxed);
+  }
+}
+
+void S21RecordStats(S21StatOp op, const S21OpStats& delta) {
+  Counters& target = counters[(std::size_t)op];
+  Add(target.calls, delta.calls);
+  Add(target.nanoseconds, delta.nanoseconds);
+  Add(target.flops, delta.flops);
+  Add(target.bytes_allocated, delta.bytes_allocated);
+  Add(target.bytes_copied, delta.bytes_copied);
+}
+
+std::string S21StatsPrometheus(const S21MatrixStats& stats) {
+  struct Family {
+    const char* name;
+    const char* help;
+    std::uint64_t S21OpStats::*field;
+  };
+  const Family families[] = {
+      {"s21_matrix_calls_total", "Calls of the operation.",
+       &S21OpStats::calls},
+      {"s21_matrix_seconds_total", "Wall time spent in the operation.",
+       &S21OpStats::nanoseconds},
+      {"s21_matrix_flops_total",
+       "Nominal floating-point operations of the classical algorithm.",
+       &S21OpStats::flops},
+      {"s21_matrix_allocated_bytes_total",
+       "Bytes of matrix buffers allocated.", &S21OpStats::bytes_allocated},
+      {"s21_matrix_copied_bytes_total", "Bytes of elements copied.",
+       &S21OpStats::bytes_copied}};
+
+  std::string text;
+  char line[160];
+  for (const Family& family : families) {
+    std::snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s counter\n",
+                  family.name, family.help, family.name);
+    text += line;
+    for (std::size_t i = 0; i < stats.ops.size(); i++) {
+      std::uint64_t value = stats.ops[i].*family.field;
+      if (family.field == &S21OpStats::nanoseconds) {
+        std::snprintf(line, sizeof(line), "%s{op=\"%s\"} %.9f\n", family.name,
+                      kNames[i], value * 1e-9);
+      } else {
+        std::snprintf(line, sizeof(line), "%s{op=\"%s\"} %llu\n", family.name,
+                      kNames[i], (unsigned long long)value);
+      }
+      text += line;
+    }
+  }
+  return text;
+}
+
+S21StatScope::S21StatScope(S21StatOp op, std::uint64_t flops,
+                           std::uint64_t bytes_copied)
+    : op_(op), start_(Now()), outer_(innermost) {
+  stats_.calls = 1;
+  stats_.flops = flops;
+  stats_.bytes_copied = bytes_copied;
+  innermost = this;
+}
+
+S21StatScope::~S21StatScope() {
+  innermost = outer_;
+  stats_.nanoseconds = (std::uint64_t)(Now() - start_);
+  S21RecordStats(op_, stats_);
+}
+
+void S21StatScope::Allocated(std::uint64_t bytes,
+                             std::uint64_t bytes_copied) {
+  S21OpStats stats;
+  stats.calls = 1;
+  stats.bytes_allocated = bytes;
+  stats.bytes_copied = bytes_copied;
+  S21RecordStats(S21StatOp::kAllocate, stats);
+  for (S21StatScope* scope = innermost; scope != nullptr;
+       scope = scope->outer_) {
+    scope->stats_.bytes_allocated += bytes;
+    scope->stats_.bytes_copied += bytes_copied;
+  }
+}
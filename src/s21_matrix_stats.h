@@ -0,0 +1,95 @@
+#ifndef SRC_S21_MATRIX_STATS_H_
+#define SRC_S21_MATRIX_STATS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Opt-in counters of the library's operations. With the library compiled
+// with -DS21_MATRIX_STATS (make STATS=1) every operation below records its
+// calls, wall time, nominal FLOPs and the bytes it allocated and copied;
+// without it the hooks expand to nothing and the counters stay zero.
+//
+// Times and bytes of an operation include the operations it calls, e.g. the
+// allocation of the result of kMulMatrix, so only kAllocate totals the
+// buffers. Allocations made by pool threads are only counted there.
+
+enum class S21StatOp {
+  kAllocate,  // every matrix buffer handed out, in place of a time
+  kCopyConstruct,
+  kCopyAssign,
+  kSumMatrix,
+  kSubMatrix,
+  kMulNumber,
+  kMulMatrix,  // MulMatrix and operator*
+  kTranspose,
+  kDeterminant,
+  kCalcComplements,
+  kInverseMatrix,
+  kSolve,
+  kGemm,  // s21_matrix_blas.h
+  kGemv,
+  kGer,
+  kCount
+};
+
+struct S21OpStats {
+  std::uint64_t calls = 0;
+  std::uint64_t nanoseconds = 0;
+  std::uint64_t flops = 0;
+  std::uint64_t bytes_allocated = 0;
+  std::uint64_t bytes_copied = 0;
+};
+
+struct S21MatrixStats {
+  std::array<S21OpStats, (std::size_t)S21StatOp::kCount> ops;
+
+  const S21OpStats& operator[](S21StatOp op) const {
+    return ops[(std::size_t)op];
+  }
+};
+
+// Whether the library was built with S21_MATRIX_STATS.
+bool S21StatsEnabled();
+// Snake-case name of op, the label of the exported series.
+const char* S21StatOpName(S21StatOp op);
+// Consistent per counter; concurrent operations may be half recorded.
+S21MatrixStats S21GetStats();
+void S21ResetStats();
+// Adds delta to the counters of op.
+void S21RecordStats(S21StatOp op, const S21OpStats& delta);
+// Prometheus text exposition format: one counter family per field,
+// labelled by op, with the time in seconds.
+std::string S21StatsPrometheus(const S21MatrixStats& stats);
+
+// Records one call of op with its duration when it goes out of scope.
+class S21StatScope {
+ public:
+  S21StatScope(S21StatOp op, std::uint64_t flops, std::uint64_t bytes_copied);
+  S21StatScope(const S21StatScope&) = delete;
+  S21StatScope& operator=(const S21StatScope&) = delete;
+  ~S21StatScope();
+
+  // Counts a buffer of bytes (bytes_copied of them filled from an old
+  // buffer) under kAllocate and the scopes open on this thread.
+  static void Allocated(std::uint64_t bytes, std::uint64_t bytes_copied);
+
+ private:
+  S21StatOp op_;
+  S21OpStats stats_;
+  std::int64_t start_;
+  S21StatScope* outer_;
+};
+
+#ifdef S21_MATRIX_STATS
+#define S21_STAT_SCOPE(op, flops, bytes_copied) \
+  S21StatScope s21_stat_scope_(op, flops, bytes_copied)
+#define S21_STAT_ALLOCATED(bytes, bytes_copied) \
+  S21StatScope::Allocated(bytes, bytes_copied)
+#else
+#define S21_STAT_SCOPE(op, flops, bytes_copied) ((void)0)
+#define S21_STAT_ALLOCATED(bytes, bytes_copied) ((void)0)
+#endif
+
+#endif  // SRC_S21_MATRIX_STATS_H_
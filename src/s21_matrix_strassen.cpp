@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+#include "s21_matrix_expr.h"
+#include "s21_matrix_gemm.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+std::atomic<S21MulAlgorithm> mul_algorithm(S21MulAlgorithm::kClassic);
+std::atomic<int> strassen_crossover(kS21DefaultStrassenCrossover);
+
+// Read-only operand of the recursion: element (i, j) is at
+// data[i * rs + j * cs].
+template <typename T>
+struct Operand {
+  const T* data;
+  std::ptrdiff_t rs;
+  std::ptrdiff_t cs;
+
+  Operand At(int i, int j) const { return {data + i * rs + j * cs, rs, cs}; }
+};
+
+template <typename T>
+Operand<T> Dense(const T* data, std::ptrdiff_t rs) {
+  return {data, rs, 1};
+}
+
+// out = x + sign * y over rows x cols elements. out may be x or y itself.
+template <typename T>
+void Combine(int rows, int cols, Operand<T> x, Operand<T> y, T sign, T* out,
+             std::ptrdiff_t out_rs) {
+  if (rows <= 0 || cols <= 0) return;
+  S21ParallelRows(rows, cols, [&](long first, long last) {
+    for (long i = first; i < last; i++) {
+      const T* x_row = x.data + i * x.rs;
+      const T* y_row = y.data + i * y.rs;
+      T* out_row = out + i * out_rs;
+      if (x.cs == 1 && y.cs == 1) {
+        for (int j = 0; j < cols; j++) out_row[j] = x_row[j] + sign * y_row[j];
+      } else {
+        for (int j = 0; j < cols; j++)
+          out_row[j] = x_row[j * x.cs] + sign * y_row[j * y.cs];
+      }
+    }
+  });
+}
+
+template <typename T>
+void Multiply(int m, int n, int k, Operand<T> a, Operand<T> b, T* c,
+              std::ptrdiff_t c_rs, int crossover, bool parallel);
+
+// One level with the products one after another, in the schedule of Boyer,
+// Dumas, Pernet and Zhou (ISSAC 2009) that uses the quadrants of C and two
+// scratch operands x (sums of A, then P1) and y (sums of B) as workspace.
+template <typename T>
+void SerialLevel(int m2, int n2, int k2, Operand<T> a, Operand<T> b, T* c,
+                 std::ptrdiff_t c_rs, int crossover) {
+  Operand<T> a11 = a, a12 = a.At(0, k2), a21 = a.At(m2, 0),
+             a22 = a.At(m2, k2);
+  Operand<T> b11 = b, b12 = b.At(0, n2), b21 = b.At(k2, 0),
+             b22 = b.At(k2, n2);
+  T* c11 = c;
+  T* c12 = c + n2;
+  T* c21 = c + m2 * c_rs;
+  T* c22 = c21 + n2;
+  Operand<T> c11_in = Dense<T>(c11, c_rs), c12_in = Dense<T>(c12, c_rs),
+             c21_in = Dense<T>(c21, c_rs), c22_in = Dense<T>(c22, c_rs);
+
+  std::ptrdiff_t x_rs = std::max(k2, n2);
+  std::unique_ptr<T[]> x(new T[(std::size_t)m2 * x_rs]);
+  std::unique_ptr<T[]> y(new T[(std::size_t)k2 * n2]);
+  Operand<T> x_in = Dense<T>(x.get(), x_rs), y_in = Dense<T>(y.get(), n2);
+  auto product = [&](Operand<T> lhs, Operand<T> rhs, T* out,
+                     std::ptrdiff_t out_rs) {
+    Multiply(m2, n2, k2, lhs, rhs, out, out_rs, crossover, false);
+  };
+
+  Combine(m2, k2, a11, a21, T(-1), x.get(), x_rs);    // S3
+  Combine(k2, n2, b22, b12, T(-1), y.get(), n2);      // T3
+  product(x_in, y_in, c21, c_rs);                     // P7
+  Combine(m2, k2, a21, a22, T(1), x.get(), x_rs);     // S1
+  Combine(k2, n2, b12, b11, T(-1), y.get(), n2);      // T1
+  product(x_in, y_in, c22, c_rs);                     // P5
+  Combine(m2, k2, x_in, a11, T(-1), x.get(), x_rs);   // S2
+  Combine(k2, n2, b22, y_in, T(-1), y.get(), n2);     // T2
+  product(x_in, y_in, c12, c_rs);                     // P6
+  Combine(m2, k2, a12, x_in, T(-1), x.get(), x_rs);   // S4
+  product(x_in, b22, c11, c_rs);                      // P3
+  product(a11, b11, x.get(), x_rs);                   // P1
+  Combine(m2, n2, x_in, c12_in, T(1), c12, c_rs);     // P1 + P6
+  Combine(m2, n2, c12_in, c21_in, T(1), c21, c_rs);   // + P7
+  Combine(m2, n2, c12_in, c22_in, T(1), c12, c_rs);   // P1 + P6 + P5
+  Combine(m2, n2, c21_in, c22_in, T(1), c22, c_rs);   // C22
+  Combine(m2, n2, c12_in, c11_in, T(1), c12, c_rs);   // C12
+  Combine(k2, n2, y_in, b21, T(-1), y.get(), n2);     // T4
+  product(a22, y_in, c11, c_rs);                      // P4
+  Combine(m2, n2, c21_in, c11_in, T(-1), c21, c_rs);  // C21
+  product(a12, b21, c11, c_rs);                       // P2
+  Combine(m2, n2, c11_in, x_in, T(1), c11, c_rs);     // C11
+}
+
+// One level with the 7 products as parallel tasks. Four of them write
+// straight into the quadrants of C, which are then combined in place.
+template <typename T>
+void ParallelLevel(int m2, int n2, int k2, Operand<T> a, Operand<T> b, T* c,
+                   std::ptrdiff_t c_rs, int crossover) {
+  Operand<T> a11 = a, a12 = a.At(0, k2), a21 = a.At(m2, 0),
+             a22 = a.At(m2, k2);
+  Operand<T> b11 = b, b12 = b.At(0, n2), b21 = b.At(k2, 0),
+             b22 = b.At(k2, n2);
+  T* c11 = c;
+  T* c12 = c + n2;
+  T* c21 = c + m2 * c_rs;
+  T* c22 = c21 + n2;
+
+  std::size_t a_size = (std::size_t)m2 * k2;
+  std::size_t b_size = (std::size_t)k2 * n2;
+  std::size_t c_size = (std::size_t)m2 * n2;
+  std::unique_ptr<T[]> scratch(new T[4 * a_size + 4 * b_size + 3 * c_size]);
+  T* s[4];
+  T* t[4];
+  for (int i = 0; i < 4; i++) {
+    s[i] = scratch.get() + i * a_size;
+    t[i] = scratch.get() + 4 * a_size + i * b_size;
+  }
+  T* p1 = scratch.get() + 4 * a_size + 4 * b_size;
+  T* p3 = p1 + c_size;
+  T* p4 = p3 + c_size;
+  auto a_sum = [&](T* data) { return Dense<T>(data, k2); };
+  auto b_sum = [&](T* data) { return Dense<T>(data, n2); };
+
+  Combine(m2, k2, a21, a22, T(1), s[0], k2);           // S1
+  Combine(m2, k2, a_sum(s[0]), a11, T(-1), s[1], k2);  // S2
+  Combine(m2, k2, a11, a21, T(-1), s[2], k2);          // S3
+  Combine(m2, k2, a12, a_sum(s[1]), T(-1), s[3], k2);  // S4
+  Combine(k2, n2, b12, b11, T(-1), t[0], n2);          // T1
+  Combine(k2, n2, b22, b_sum(t[0]), T(-1), t[1], n2);  // T2
+  Combine(k2, n2, b22, b12, T(-1), t[2], n2);          // T3
+  Combine(k2, n2, b_sum(t[1]), b21, T(-1), t[3], n2);  // T4
+
+  struct Product {
+    Operand<T> lhs;
+    Operand<T> rhs;
+    T* out;
+    std::ptrdiff_t out_rs;
+  };
+  const Product products[7] = {
+      {a11, b11, p1, n2},                      // P1
+      {a12, b21, c11, c_rs},                   // P2
+      {a_sum(s[3]), b22, p3, n2},              // P3
+      {a22, b_sum(t[3]), p4, n2},              // P4
+      {a_sum(s[0]), b_sum(t[0]), c22, c_rs},   // P5
+      {a_sum(s[1]), b_sum(t[1]), c12, c_rs},   // P6
+      {a_sum(s[2]), b_sum(t[2]), c21, c_rs}};  // P7
+  S21ThreadPool::Instance().ParallelFor(0, 7, 1, [&](long first, long last) {
+    for (long i = first; i < last; i++)
+      Multiply(m2, n2, k2, products[i].lhs, products[i].rhs, products[i].out,
+               products[i].out_rs, crossover, false);
+  });
+
+  Operand<T> c11_in = Dense<T>(c11, c_rs), c12_in = Dense<T>(c12, c_rs),
+             c21_in = Dense<T>(c21, c_rs), c22_in = Dense<T>(c22, c_rs);
+  Combine(m2, n2, c12_in, Dense<T>(p1, n2), T(1), c12, c_rs);   // P6 + P1
+  Combine(m2, n2, c21_in, c12_in, T(1), c21, c_rs);             // + P7
+  Combine(m2, n2, c12_in, c22_in, T(1), c12, c_rs);             // + P5
+  Combine(m2, n2, c22_in, c21_in, T(1), c22, c_rs);             // C22
+  Combine(m2, n2, c12_in, Dense<T>(p3, n2), T(1), c12, c_rs);   // C12
+  Combine(m2, n2, c21_in, Dense<T>(p4, n2), T(-1), c21, c_rs);  // C21
+  Combine(m2, n2, c11_in, Dense<T>(p1, n2), T(1), c11, c_rs);   // C11
+}
+
+// C = A * B, ignoring the previous contents of C.
+template <typename T>
+void Multiply(int m, int n, int k, Operand<T> a, Operand<T> b, T* c,
+              std::ptrdiff_t c_rs, int crossover, bool parallel) {
+  if (std::min(m, std::min(n, k)) < crossover) {
+    S21GemmStrided(m, n, k, T(1), a.data, a.rs, a.cs, b.data, b.rs, b.cs, T(0),
+                   c, c_rs);
+    return;
+  }
+  int m2 = m / 2, n2 = n / 2, k2 = k / 2;
+  if (parallel && S21ThreadPool::Instance().getThreadCount() > 1)
+    ParallelLevel(m2, n2, k2, a, b, c, c_rs, crossover);
+  else
+    SerialLevel(m2, n2, k2, a, b, c, c_rs, crossover);
+  // The last row, column and inner index when the dimensions are odd.
+  if (k % 2 != 0) {
+    Operand<T> a_col = a.At(0, k - 1), b_row = b.At(k - 1, 0);
+    S21GemmStrided(2 * m2, 2 * n2, 1, T(1), a_col.data, a_col.rs, a_col.cs,
+                   b_row.data, b_row.rs, b_row.cs, T(1), c, c_rs);
+  }
+  if (n % 2 != 0) {
+    Operand<T> b_col = b.At(0, n - 1);
+    S21GemmStrided(m, 1, k, T(1), a.data, a.rs, a.cs, b_col.data, b_col.rs,
+                   b_col.cs, T(0), c + n - 1, c_rs);
+  }
+  if (m % 2 != 0) {
+    Operand<T> a_row = a.At(m - 1, 0);
+    S21GemmStrided(1, 2 * n2, k, T(1), a_row.data, a_row.rs, a_row.cs, b.data,
+                   b.rs, b.cs, T(0), c + (m - 1) * c_rs, c_rs);
+  }
+}
+
+}  // namespace
+
+void S21SetMulAlgorithm(S21MulAlgorithm algorithm) {
+  mul_algorithm.store(algorithm);
+}
+
+S21MulAlgorithm S21GetMulAlgorithm() { return mul_algorithm.load(); }
+
+void S21SetStrassenCrossover(int crossover) {
+  if (crossover < 1)
+    throw std::invalid_argument("The Strassen crossover must be positive");
+  strassen_crossover.store(crossover);
+}
+
+int S21GetStrassenCrossover() { return strassen_crossover.load(); }
+
+template <typename T>
+void S21GemmStrassen(int m, int n, int k, T alpha, const T* a,
+                     std::ptrdiff_t a_row_stride, std::ptrdiff_t a_col_stride,
+                     const T* b, std::ptrdiff_t b_row_stride,
+                     std::ptrdiff_t b_col_stride, T beta, T* c,
+                     std::ptrdiff_t c_row_stride, int crossover) {
+  if (crossover < 1)
+    throw std::invalid_argument("The Strassen crossover must be positive");
+  if (m <= 0 || n <= 0 || k <= 0 || alpha == T(0) ||
+      std::min(m, std::min(n, k)) < crossover) {
+    S21GemmStrided(m, n, k, alpha, a, a_row_stride, a_col_stride, b,
+                   b_row_stride, b_col_stride, beta, c, c_row_stride);
+    return;
+  }
+  Operand<T> a_in = {a, a_row_stride, a_col_stride};
+  Operand<T> b_in = {b, b_row_stride, b_col_stride};
+  if (alpha == T(1) && beta == T(0)) {
+    Multiply(m, n, k, a_in, b_in, c, c_row_stride, crossover, true);
+    return;
+  }
+  // The recursion combines products, so alpha and beta are applied after.
+  std::unique_ptr<T[]> product(new T[(std::size_t)m * n]);
+  Multiply(m, n, k, a_in, b_in, product.get(), n, crossover, true);
+  S21ParallelRows(m, n, [&](long first, long last) {
+    for (long i = first; i < last; i++) {
+      const T* p = product.get() + i * n;
+      T* row = c + i * c_row_stride;
+      if (beta == T(0)) {
+        for (int j = 0; j < n; j++) row[j] = alpha * p[j];
+      } else {
+        for (int j = 0; j < n; j++) row[j] = alpha * p[j] + beta * row[j];
+      }
+    }
+  });
+}
+
+template <typename T>
+void S21GemmWith(S21MulAlgorithm algorithm, int m, int n, int k, T alpha,
+                 const T* a, std::ptrdiff_t a_row_stride,
+                 std::ptrdiff_t a_col_stride, const T* b,
+                 std::ptrdiff_t b_row_stride, std::ptrdiff_t b_col_stride,
+                 T beta, T* c, std::ptrdiff_t c_row_stride) {
+  if (algorithm == S21MulAlgorithm::kStrassen)
+    S21GemmStrassen(m, n, k, alpha, a, a_row_stride, a_col_stride, b,
+                    b_row_stride, b_col_stride, beta, c, c_row_stride,
+                    S21GetStrassenCrossover());
+  else
+    S21GemmStrided(m, n, k, alpha, a, a_row_stride, a_col_stride, b,
+                   b_row_stride, b_col_stride, beta, c, c_row_stride);
+}
+
+template void S21GemmStrassen<float>(int, int, int, float, const float*,
+                                     std::ptrdiff_t, std::ptrdiff_t,
+                                     const float*, std::ptrdiff_t,
+                                     std::ptrdiff_t, float, float*,
+                                     std::ptrdiff_t, int);
+template void S21GemmStrassen<double>(int, int, int, double, const double*,
+                                      std::ptrdiff_t, std::ptrdiff_t,
+                                      const double*, std::ptrdiff_t,
+                                      std::ptrdiff_t, double, double*,
+                                      std::ptrdiff_t, int);
+template void S21GemmStrassen<long double>(
+    int, int, int, long double, const long double*, std::ptrdiff_t,
+    std::ptrdiff_t, const long double*, std::ptrdiff_t, std::ptrdiff_t,
+    long double, long double*, std::ptrdiff_t, int);
+template void S21GemmWith<float>(S21MulAlgorithm, int, int, int, float,
+                                 const float*, std::ptrdiff_t, std::ptrdiff_t,
+                                 const float*, std::ptrdiff_t, std::ptrdiff_t,
+                                 float, float*, std::ptrdiff_t);
+template void S21GemmWith<double>(S21MulAlgorithm, int, int, int, double,
+                                  const double*, std::ptrdiff_t,
+                                  std::ptrdiff_t, const double*,
+                                  std::ptrdiff_t, std::ptrdiff_t, double,
+                                  double*, std::ptrdiff_t);
+template void S21GemmWith<long double>(
+    S21MulAlgorithm, int, int, int, long double, const long double*,
+    std::ptrdiff_t, std::ptrdiff_t, const long double*, std::ptrdiff_t,
+    std::ptrdiff_t, long double, long double*, std::ptrdiff_t);
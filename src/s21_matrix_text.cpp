@@ -0,0 +1,270 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Chunks of a file handed to one thread, big enough to make the split and
+// the hand-off negligible.
+constexpr std::size_t kMinChunk = std::size_t(1) << 20;
+// Delimiter that stands for any run of spaces and tabs.
+constexpr char kWhitespace = '\0';
+
+void Fail(const std::string& what, const std::string& path) {
+  throw std::runtime_error(what + ": " + path);
+}
+
+bool IsBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+// The newline ending the line that starts at begin, or end.
+const char* LineEnd(const char* begin, const char* end) {
+  if (begin >= end) return end;
+  const void* newline = std::memchr(begin, '\n', end - begin);
+  return newline != nullptr ? static_cast<const char*>(newline) : end;
+}
+
+// Read-only mapping of a whole file.
+class MappedText {
+ public:
+  explicit MappedText(const std::string& path) : data_(nullptr), size_(0) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) Fail("Cannot open", path);
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+      close(fd);
+      Fail("Cannot open", path);
+    }
+    size_ = (std::size_t)info.st_size;
+    if (size_ > 0) {
+      void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        Fail("Cannot map", path);
+      }
+      data_ = static_cast<const char*>(data);
+      madvise(data, size_, MADV_SEQUENTIAL);
+    }
+    close(fd);
+  }
+  MappedText(const MappedText&) = delete;
+  MappedText& operator=(const MappedText&) = delete;
+  ~MappedText() {
+    if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+  }
+
+  const char* begin() const noexcept { return data_; }
+  const char* end() const noexcept { return data_ + size_; }
+
+ private:
+  const char* data_;
+  std::size_t size_;
+};
+
+// Boundaries of about four chunks per thread, each starting at a line.
+std::vector<const char*> SplitLines(const char* begin, const char* end) {
+  std::size_t size = end - begin;
+  std::size_t chunks = std::min<std::size_t>(
+      size / kMinChunk, 4 * S21ThreadPool::Instance().getThreadCount());
+  std::vector<const char*> bounds = {begin};
+  for (std::size_t c = 1; c < chunks; c++) {
+    const char* cut = begin + size * c / chunks;
+    if (cut < bounds.back()) continue;
+    const char* newline = LineEnd(cut, end);
+    if (newline == end) break;
+    bounds.push_back(newline + 1);
+  }
+  bounds.push_back(end);
+  return bounds;
+}
+
+// Calls row(first, last) for each line of [begin, end) that is not blank,
+// with first past the leading blanks.
+template <typename Body>
+void ForEachRow(const char* begin, const char* end, Body row) {
+  while (begin < end) {
+    const char* line_end = LineEnd(begin, end);
+    const char* first = begin;
+    while (first < line_end && IsBlank(*first)) first++;
+    if (first < line_end) row(first, line_end);
+    begin = line_end + 1;
+  }
+}
+
+// Parses the fields of one line into out[0, cols) and returns how many
+// there are, or -1 if one of them is not a number.
+template <typename T>
+int ParseRow(const char* p, const char* end, char delimiter, T* out,
+             int cols) {
+  int count = 0;
+  for (;;) {
+    while (p < end && IsBlank(*p) && *p != delimiter) p++;
+    // from_chars takes no explicit plus sign.
+    if (p < end && *p == '+') p++;
+    T value;
+    std::from_chars_result parsed = std::from_chars(p, end, value);
+    if (parsed.ec == std::errc::result_out_of_range) {
+      // Saturates to zero or infinity, as a cast from a wider type would.
+      long double wide;
+      parsed = std::from_chars(p, end, wide);
+      value = static_cast<T>(wide);
+    }
+    if (parsed.ec != std::errc()) return -1;
+    if (count < cols) out[count] = value;
+    count++;
+    p = parsed.ptr;
+    // A tab or space delimiter is a field separator, not padding.
+    while (p < end && IsBlank(*p) && *p != delimiter) p++;
+    if (p == end) return count;
+    if (delimiter == kWhitespace) {
+      if (p == parsed.ptr) return -1;
+    } else {
+      if (*p != delimiter) return -1;
+      p++;
+    }
+  }
+}
+
+template <typename T>
+S21BasicMatrix<T> ReadText(const std::string& path, char delimiter) {
+  MappedText text(path);
+  std::vector<const char*> bounds = SplitLines(text.begin(), text.end());
+  long chunks = (long)bounds.size() - 1;
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+
+  // First pass: rows per chunk, so that each chunk knows where its rows go.
+  std::vector<long> first_row(chunks + 1, 0);
+  pool.ParallelFor(0, chunks, 1, [&](long first, long last) {
+    for (long c = first; c < last; c++)
+      ForEachRow(bounds[c], bounds[c + 1],
+                 [&](const char*, const char*) { first_row[c + 1]++; });
+  });
+  for (long c = 0; c < chunks; c++) first_row[c + 1] += first_row[c];
+  long rows = first_row[chunks];
+  if (rows == 0) Fail("No rows in matrix file", path);
+  if (rows > INT_MAX) Fail("Unsupported matrix size in matrix file", path);
+  // The first row sets the number of columns.
+  const char* line = text.begin();
+  const char* line_end = text.end();
+  while (line < text.end()) {
+    line_end = LineEnd(line, text.end());
+    while (line < line_end && IsBlank(*line)) line++;
+    if (line < line_end) break;
+    line = line_end + 1;
+  }
+  int cols = ParseRow<T>(line, line_end, delimiter, nullptr, 0);
+  if (cols <= 0) Fail("Malformed row 1 in matrix file", path);
+
+  S21BasicMatrix<T> matrix((int)rows, cols);
+  T* data = matrix.data();
+  std::size_t stride = matrix.stride();
+  pool.ParallelFor(0, chunks, 1, [&](long first, long last) {
+    for (long c = first; c < last; c++) {
+      long row = first_row[c];
+      ForEachRow(bounds[c], bounds[c + 1], [&](const char* begin,
+                                               const char* end) {
+        T* out = data + row * stride;
+        if (ParseRow(begin, end, delimiter, out, cols) != cols)
+          Fail("Malformed row " + std::to_string(row + 1) + " in matrix file",
+               path);
+        row++;
+      });
+    }
+  });
+  return matrix;
+}
+
+// Formats a few chunks of rows in parallel at a time and writes them out
+// in order, so the text of a big matrix is never held in memory at once.
+template <typename T>
+void WriteText(const S21BasicMatrix<T>& matrix, const std::string& path,
+               char delimiter) {
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) Fail("Cannot open", path);
+  int rows = matrix.getRows(), cols = matrix.getCols();
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  // About kMinChunk bytes of text per chunk at up to 24 bytes a number.
+  int chunk_rows = std::max<int>(1, kMinChunk / 24 / std::max(cols, 1));
+  std::vector<std::string> texts(4 * pool.getThreadCount());
+  for (long start = 0; start < rows;
+       start += (long)chunk_rows * texts.size()) {
+    long chunks = std::min<long>(texts.size(),
+                                 (rows - start + chunk_rows - 1) / chunk_rows);
+    pool.ParallelFor(0, chunks, 1, [&](long first, long last) {
+      char number[64];
+      for (long c = first; c < last; c++) {
+        std::string& text = texts[c];
+        text.clear();
+        long begin = start + c * chunk_rows;
+        long end = std::min<long>(rows, begin + chunk_rows);
+        for (long i = begin; i < end; i++) {
+          for (int j = 0; j < cols; j++) {
+            std::to_chars_result written = std::to_chars(
+                number, number + sizeof(number), matrix.at_unchecked(i, j));
+            text.append(number, written.ptr);
+            text.push_back(j + 1 < cols ? delimiter : '\n');
+          }
+        }
+      }
+    });
+    for (long c = 0; c < chunks; c++)
+      file.write(texts[c].data(), texts[c].size());
+  }
+  file.close();
+  if (!file) Fail("Cannot write", path);
+}
+
+}  // namespace
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::FromCSV(const std::string& path,
+                                             char delimiter) {
+  return ReadText<T>(path, delimiter);
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::FromText(const std::string& path) {
+  return ReadText<T>(path, kWhitespace);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::ToCSV(const std::string& path, char delimiter) const {
+  WriteText(*this, path, delimiter);
+}
+
+template <typename T>
+void S21BasicMatrix<T>::ToText(const std::string& path) const {
+  WriteText(*this, path, ' ');
+}
+
+template S21BasicMatrix<float> S21BasicMatrix<float>::FromCSV(
+    const std::string&, char);
+template S21BasicMatrix<double> S21BasicMatrix<double>::FromCSV(
+    const std::string&, char);
+template S21BasicMatrix<long double> S21BasicMatrix<long double>::FromCSV(
+    const std::string&, char);
+template S21BasicMatrix<float> S21BasicMatrix<float>::FromText(
+    const std::string&);
+template S21BasicMatrix<double> S21BasicMatrix<double>::FromText(
+    const std::string&);
+template S21BasicMatrix<long double> S21BasicMatrix<long double>::FromText(
+    const std::string&);
+template void S21BasicMatrix<float>::ToCSV(const std::string&, char) const;
+template void S21BasicMatrix<double>::ToCSV(const std::string&, char) const;
+template void S21BasicMatrix<long double>::ToCSV(const std::string&,
+                                                 char) const;
+template void S21BasicMatrix<float>::ToText(const std::string&) const;
+template void S21BasicMatrix<double>::ToText(const std::string&) const;
+template void S21BasicMatrix<long double>::ToText(const std::string&) const;
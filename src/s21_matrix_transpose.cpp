@@ -0,0 +1,142 @@
+#include "s21_matrix_oop.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "s21_matrix_stats.h"
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Side of the square blocks the recursion stops at: a source and a
+// destination block of 32 x 32 doubles fit in L1 together.
+constexpr int kTransposeTile = 32;
+
+// dst = src^T for a rows x cols source. Splits the longer side in half until
+// the block is a tile, which keeps both the reads and the strided writes
+// within cache at every level without knowing the cache sizes.
+template <typename T>
+void TransposeRecursive(const T* src, std::size_t src_stride, T* dst,
+                        std::size_t dst_stride, int rows, int cols) {
+  if (rows <= kTransposeTile && cols <= kTransposeTile) {
+    // Walking the destination rows keeps the stores contiguous; the
+    // strided loads hit the source tile, which is already in L1.
+    for (int j = 0; j < cols; j++) {
+      T* dst_row = dst + j * dst_stride;
+      for (int i = 0; i < rows; i++) dst_row[i] = src[i * src_stride + j];
+    }
+  } else if (rows >= cols) {
+    int half = rows / 2;
+    TransposeRecursive(src, src_stride, dst, dst_stride, half, cols);
+    TransposeRecursive(src + half * src_stride, src_stride, dst + half,
+                       dst_stride, rows - half, cols);
+  } else {
+    int half = cols / 2;
+    TransposeRecursive(src, src_stride, dst, dst_stride, rows, half);
+    TransposeRecursive(src + half, src_stride, dst + half * dst_stride,
+                       dst_stride, rows, cols - half);
+  }
+}
+
+// Runs body(first_tile, last_tile) over the rows * cols matrix cut into
+// row bands of kTransposeTile, on the pool when it is large enough. Bands
+// keep threads from sharing cache lines of the destination.
+template <typename Body>
+void ForTileBands(int rows, int cols, Body body) {
+  long bands = (rows + kTransposeTile - 1) / kTransposeTile;
+  if ((long)rows * cols < kS21SerialCutoff) {
+    body(0L, bands);
+  } else {
+    S21ThreadPool::Instance().ParallelFor(0, bands, 1, body);
+  }
+}
+
+// Swaps the tile at rows [r0, r1) x cols [c0, c1) with its mirror image
+// across the diagonal; a diagonal tile is transposed onto itself.
+template <typename T>
+void SwapMirrorTiles(T* a, std::size_t stride, int r0, int r1, int c0,
+                     int c1) {
+  for (int i = r0; i < r1; i++) {
+    T* row = a + i * stride;
+    for (int j = std::max(c0, i + 1); j < c1; j++)
+      std::swap(row[j], a[j * stride + i]);
+  }
+}
+
+// In-place transpose of a contiguous rows x cols buffer by following the
+// cycles of the permutation: element k = i * cols + j moves to
+// j * rows + i. A bitmap of visited positions (one bit per element) is the
+// only extra memory.
+template <typename T>
+void TransposeCycles(T* a, int rows, int cols) {
+  std::size_t count = (std::size_t)rows * cols;
+  std::vector<bool> moved(count, false);
+  // The first and the last element never move.
+  for (std::size_t start = 1; start + 1 < count; start++) {
+    if (moved[start]) continue;
+    T carry = a[start];
+    std::size_t position = start;
+    do {
+      position = position % cols * rows + position / cols;
+      std::swap(carry, a[position]);
+      moved[position] = true;
+    } while (position != start);
+  }
+}
+
+}  // namespace
+
+template <typename T>
+S21BasicMatrix<T> S21BasicMatrix<T>::Transpose() const {
+  S21_STAT_SCOPE(S21StatOp::kTranspose, 0,
+                 (std::uint64_t)rows_ * cols_ * sizeof(T));
+  S21BasicMatrix result_matrix(cols_, rows_, false);
+  std::size_t src_stride = stride();
+  std::size_t dst_stride = result_matrix.stride();
+  T* dst = result_matrix.matrix_;
+  ForTileBands(rows_, cols_, [&](long first, long last) {
+    int r0 = (int)first * kTransposeTile;
+    int r1 = std::min(rows_, (int)last * kTransposeTile);
+    TransposeRecursive(matrix_ + r0 * src_stride, src_stride, dst + r0,
+                       dst_stride, r1 - r0, cols_);
+  });
+  return result_matrix;
+}
+
+template <typename T>
+void S21BasicMatrix<T>::TransposeInPlace() {
+  if (rows_ == cols_) {
+    T* a = matrix_;
+    std::size_t a_stride = stride();
+    int n = rows_;
+    ForTileBands(n, n, [&](long first, long last) {
+      for (long band = first; band < last; band++) {
+        int r0 = (int)band * kTransposeTile;
+        int r1 = std::min(n, r0 + kTransposeTile);
+        for (int c0 = r0; c0 < n; c0 += kTransposeTile)
+          SwapMirrorTiles(a, a_stride, r0, r1, c0,
+                          std::min(n, c0 + kTransposeTile));
+      }
+    });
+  } else {
+    // Cycle following needs the rows packed together.
+    if (stride_ != cols_) {
+      for (int i = 1; i < rows_; i++)
+        std::copy(matrix_ + (std::size_t)i * stride_,
+                  matrix_ + (std::size_t)i * stride_ + cols_,
+                  matrix_ + (std::size_t)i * cols_);
+    }
+    TransposeCycles(matrix_, rows_, cols_);
+    std::swap(rows_, cols_);
+    stride_ = cols_;
+  }
+}
+
+template S21BasicMatrix<float> S21BasicMatrix<float>::Transpose() const;
+template S21BasicMatrix<double> S21BasicMatrix<double>::Transpose() const;
+template S21BasicMatrix<long double> S21BasicMatrix<long double>::Transpose()
+    const;
+template void S21BasicMatrix<float>::TransposeInPlace();
+template void S21BasicMatrix<double>::TransposeInPlace();
+template void S21BasicMatrix<long double>::TransposeInPlace();
@@ -0,0 +1,24 @@
+#include "s21_matrix_blas.h"
+#include "s21_matrix_oop.h"
+
+template <typename T>
+S21BasicMatrix<T> S21MulViews(const S21BasicMatrixView<const T>& a,
+                              const S21BasicMatrixView<const T>& b) {
+  if (a.getCols() != b.getRows())
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the number "
+        "of rows of the second matrix");
+  S21BasicMatrix<T> c(a.getRows(), b.getCols());
+  S21GemmViews(T(1), a, S21Op::kNoTrans, b, S21Op::kNoTrans, T(0), c.view());
+  return c;
+}
+
+template S21BasicMatrix<float> S21MulViews(
+    const S21BasicMatrixView<const float>&,
+    const S21BasicMatrixView<const float>&);
+template S21BasicMatrix<double> S21MulViews(
+    const S21BasicMatrixView<const double>&,
+    const S21BasicMatrixView<const double>&);
+template S21BasicMatrix<long double> S21MulViews(
+    const S21BasicMatrixView<const long double>&,
+    const S21BasicMatrixView<const long double>&);
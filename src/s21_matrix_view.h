@@ -0,0 +1,202 @@
+#ifndef SRC_S21_MATRIX_VIEW_H_
+#define SRC_S21_MATRIX_VIEW_H_
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+
+#include "s21_matrix_expr.h"
+
+// Non-owning rows x cols window on the elements of a matrix buffer. Element
+// (i, j) of the window is data[i' * row_stride + j' * col_stride], where i'
+// and j' equal i and j except that they step over the row and column left
+// out by Minor(). block(), Minor() and Transpose() make new views without
+// touching the elements, so slicing allocates and copies nothing.
+//
+// A view is a lazy expression: it can be an operand of +, -, scalar * and
+// S21MulElements, a matrix is constructed or assigned from it with one copy,
+// and matrix products read it in place through S21MulViews. Copying a view
+// copies the window; assigning to a view writes its elements. When the
+// right-hand side reads some of them through another mapping (A.block(0, 0,
+// 2, 2) = A.block(1, 1, 2, 2), or A.view().Transpose() on the right of a
+// matrix assignment), it is evaluated into a temporary first. A view must
+// not outlive its buffer, and resizing the matrix it came from invalidates
+// it. S21BasicMatrixView<const T> is the read-only variant, which a mutable
+// view converts to.
+template <typename T>
+class S21BasicMatrixView : public S21MatrixExpr<S21BasicMatrixView<T>> {
+ public:
+  using value_type = std::remove_const_t<T>;
+
+  S21BasicMatrixView(T* data, int rows, int cols, std::ptrdiff_t row_stride,
+                     std::ptrdiff_t col_stride = 1) noexcept
+      : data_(data),
+        rows_(rows),
+        cols_(cols),
+        row_stride_(row_stride),
+        col_stride_(col_stride),
+        skip_row_(INT_MAX),
+        skip_col_(INT_MAX) {}
+  S21BasicMatrixView(const S21BasicMatrixView& other) = default;
+  template <typename U, typename = std::enable_if_t<
+                            std::is_same<const U, T>::value &&
+                            !std::is_same<U, T>::value>>
+  S21BasicMatrixView(const S21BasicMatrixView<U>& other) noexcept
+      : data_(other.data_),
+        rows_(other.rows_),
+        cols_(other.cols_),
+        row_stride_(other.row_stride_),
+        col_stride_(other.col_stride_),
+        skip_row_(other.skip_row_),
+        skip_col_(other.skip_col_) {}
+
+  S21BasicMatrixView& operator=(const S21BasicMatrixView& other) {
+    return Assign<S21ExprAssign>(other);
+  }
+  template <typename Expr>
+  S21BasicMatrixView& operator=(const S21MatrixExpr<Expr>& expr) {
+    return Assign<S21ExprAssign>(expr.derived());
+  }
+  template <typename Expr>
+  S21BasicMatrixView& operator+=(const S21MatrixExpr<Expr>& expr) {
+    return Assign<S21ExprPlus>(expr.derived());
+  }
+  template <typename Expr>
+  S21BasicMatrixView& operator-=(const S21MatrixExpr<Expr>& expr) {
+    return Assign<S21ExprMinus>(expr.derived());
+  }
+
+  int getRows() const noexcept { return rows_; }
+  int getCols() const noexcept { return cols_; }
+  T* data() const noexcept { return data_; }
+  std::ptrdiff_t getRowStride() const noexcept { return row_stride_; }
+  std::ptrdiff_t getColStride() const noexcept { return col_stride_; }
+  // Index of the row (column) left out by Minor(), -1 if there is none.
+  int getSkippedRow() const noexcept {
+    return skip_row_ == INT_MAX ? -1 : skip_row_;
+  }
+  int getSkippedCol() const noexcept {
+    return skip_col_ == INT_MAX ? -1 : skip_col_;
+  }
+
+  T& at_unchecked(int i, int j) const noexcept {
+    assert(i >= 0 && i < rows_ && j >= 0 && j < cols_);
+    return data_[(i + (i >= skip_row_)) * row_stride_ +
+                 (j + (j >= skip_col_)) * col_stride_];
+  }
+  T& operator()(int i, int j) const {
+    if (i < 0 || i >= rows_ || j < 0 || j >= cols_)
+      throw std::invalid_argument("Index out of range");
+    return at_unchecked(i, j);
+  }
+  value_type Coeff(int i, int j) const { return at_unchecked(i, j); }
+
+  S21BasicMatrixView block(int row, int col, int rows, int cols) const {
+    if (row < 0 || col < 0 || rows <= 0 || cols <= 0 || rows > rows_ - row ||
+        cols > cols_ - col)
+      throw std::invalid_argument("Index out of range");
+    if (skip_row_ != INT_MAX || skip_col_ != INT_MAX)
+      throw std::invalid_argument("A block of a minor is not a view");
+    return S21BasicMatrixView(data_ + row * row_stride_ + col * col_stride_,
+                              rows, cols, row_stride_, col_stride_);
+  }
+  // All elements but row row and column col.
+  S21BasicMatrixView Minor(int row, int col) const {
+    if (row < 0 || row >= rows_ || col < 0 || col >= cols_)
+      throw std::invalid_argument("Index out of range");
+    if (rows_ < 2 || cols_ < 2)
+      throw std::invalid_argument("Invalid size of matrix");
+    if (skip_row_ != INT_MAX || skip_col_ != INT_MAX)
+      throw std::invalid_argument("A minor of a minor is not a view");
+    S21BasicMatrixView minor(data_, rows_ - 1, cols_ - 1, row_stride_,
+                             col_stride_);
+    minor.skip_row_ = row;
+    minor.skip_col_ = col;
+    return minor;
+  }
+  // Whether writing target element by element could change what this view
+  // reads afterwards: both cover some of the same elements but map (i, j)
+  // to different ones, as A.view().Transpose() does for A. Decided on the
+  // span between the first and last element of each, which errs on the safe
+  // side for interleaved windows.
+  bool Conflicts(const S21BasicMatrixView<const value_type>& target) const {
+    if (data_ == target.data_ && row_stride_ == target.row_stride_ &&
+        col_stride_ == target.col_stride_ && skip_row_ == target.skip_row_ &&
+        skip_col_ == target.skip_col_)
+      return false;
+    if (rows_ == 0 || cols_ == 0 || target.rows_ == 0 || target.cols_ == 0)
+      return false;
+    std::less<const value_type*> less;
+    return !less(Last(), target.First()) && !less(target.Last(), First());
+  }
+
+  S21BasicMatrixView Transpose() const noexcept {
+    S21BasicMatrixView transposed(data_, cols_, rows_, col_stride_,
+                                  row_stride_);
+    transposed.skip_row_ = skip_col_;
+    transposed.skip_col_ = skip_row_;
+    return transposed;
+  }
+
+ private:
+  template <typename Op, typename Expr>
+  S21BasicMatrixView& Assign(const Expr& source) {
+    static_assert(!std::is_const<T>::value, "Assignment to a read-only view");
+    static_assert(std::is_same<value_type, typename Expr::value_type>::value,
+                  "Expression of a different element type");
+    if (rows_ != source.getRows() || cols_ != source.getCols())
+      throw std::invalid_argument("Different dimension of matrices");
+    typename S21ExprOperand<Expr>::type expr(source);
+    if (expr.Conflicts(S21BasicMatrixView<const T>(*this)))
+      return Assign<Op>(S21BasicMatrix<value_type>(source));
+    const S21BasicMatrixView& self = *this;
+    S21ParallelRows(rows_, cols_, [&self, &expr](long first, long last) {
+      for (long i = first; i < last; i++)
+        for (int j = 0; j < self.cols_; j++) {
+          T& element = self.at_unchecked((int)i, j);
+          element = Op::Apply(element, expr.Coeff((int)i, j));
+        }
+    });
+    return *this;
+  }
+
+  // Lowest and highest address of an element.
+  const value_type* First() const noexcept {
+    std::less<const value_type*> less;
+    return std::min({&at_unchecked(0, 0), &at_unchecked(rows_ - 1, 0),
+                     &at_unchecked(0, cols_ - 1)},
+                    less);
+  }
+  const value_type* Last() const noexcept {
+    return &at_unchecked(rows_ - 1, cols_ - 1);
+  }
+
+  T* data_;
+  int rows_;
+  int cols_;
+  std::ptrdiff_t row_stride_;
+  std::ptrdiff_t col_stride_;
+  // INT_MAX when nothing is skipped, so that i + (i >= skip_row_) needs no
+  // branch.
+  int skip_row_;
+  int skip_col_;
+
+  template <typename U>
+  friend class S21BasicMatrixView;
+};
+
+// Product of two views into a new matrix by the S21GetMulAlgorithm()
+// algorithm, reading both in place: views with a skipped row or column are
+// multiplied as up to eight contiguous pieces. Instantiated for float,
+// double and long double.
+template <typename T>
+S21BasicMatrix<T> S21MulViews(const S21BasicMatrixView<const T>& a,
+                              const S21BasicMatrixView<const T>& b);
+
+using S21MatrixView = S21BasicMatrixView<double>;
+
+#endif  // SRC_S21_MATRIX_VIEW_H_
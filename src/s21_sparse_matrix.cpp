@@ -0,0 +1,413 @@
+#include "s21_sparse_matrix.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#include "s21_thread_pool.h"
+
+namespace {
+
+// Runs body(first, last) over [0, lines), spread across the thread pool
+// when work (roughly the stored elements touched) is large enough.
+template <typename Body>
+void ParallelLines(int lines, long work, Body body) {
+  if (work < kS21SerialCutoff || lines < 2) {
+    body(0L, (long)lines);
+  } else {
+    long grain = std::max(1L, (long)((double)lines * (kS21SerialCutoff / 4) /
+                                     (double)work));
+    S21ThreadPool::Instance().ParallelFor(0, lines, grain, body);
+  }
+}
+
+// Compressed lines of one operand, read-only.
+template <typename T>
+struct Lines {
+  const std::vector<int>& offsets;
+  const std::vector<int>& indices;
+  const std::vector<T>& values;
+};
+
+// Gustavson: line i of the product is the sum of the lines k of b scaled by
+// the nonzeros (i, k) of a. A symbolic pass sizes every output line, then
+// the numeric pass fills them in place; both split the lines across the
+// pool, each chunk with its own dense accumulator of width inner.
+template <typename T>
+void MultiplyLines(int outer, int inner, const Lines<T>& a, const Lines<T>& b,
+                   std::vector<int>& offsets, std::vector<int>& indices,
+                   std::vector<T>& values) {
+  long work = (long)a.values.size() + (long)b.values.size() + outer;
+  offsets.assign(outer + 1, 0);
+  ParallelLines(outer, work, [&](long first, long last) {
+    std::vector<int> marker(inner, -1);
+    for (long i = first; i < last; i++) {
+      int count = 0;
+      for (int p = a.offsets[i]; p < a.offsets[i + 1]; p++) {
+        int k = a.indices[p];
+        for (int q = b.offsets[k]; q < b.offsets[k + 1]; q++) {
+          int j = b.indices[q];
+          if (marker[j] != (int)i) {
+            marker[j] = (int)i;
+            count++;
+          }
+        }
+      }
+      offsets[i + 1] = count;
+    }
+  });
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  indices.resize(offsets[outer]);
+  values.resize(offsets[outer]);
+
+  ParallelLines(outer, work, [&](long first, long last) {
+    std::vector<int> marker(inner, -1);
+    std::vector<T> sums(inner);
+    for (long i = first; i < last; i++) {
+      int* line = indices.data() + offsets[i];
+      int count = 0;
+      for (int p = a.offsets[i]; p < a.offsets[i + 1]; p++) {
+        int k = a.indices[p];
+        T factor = a.values[p];
+        for (int q = b.offsets[k]; q < b.offsets[k + 1]; q++) {
+          int j = b.indices[q];
+          if (marker[j] != (int)i) {
+            marker[j] = (int)i;
+            sums[j] = T(0);
+            line[count++] = j;
+          }
+          sums[j] += factor * b.values[q];
+        }
+      }
+      std::sort(line, line + count);
+      for (int p = 0; p < count; p++) values[offsets[i] + p] = sums[line[p]];
+    }
+  });
+}
+
+}  // namespace
+
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(int rows, int cols,
+                                              S21SparseFormat format)
+    : rows_(rows),
+      cols_(cols),
+      format_(format),
+      offsets_(),
+      indices_(),
+      values_() {
+  if (rows <= 0 || cols <= 0) {
+    throw std::invalid_argument("Invalid size of matrix");
+  }
+  offsets_.assign(getOuter() + 1, 0);
+}
+
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(
+    int rows, int cols, const std::vector<S21Triplet<T>>& triplets,
+    S21SparseFormat format)
+    : S21BasicSparseMatrix(rows, cols, format) {
+  bool csr = format_ == S21SparseFormat::kCsr;
+  std::vector<std::pair<long, T>> entries;
+  entries.reserve(triplets.size());
+  for (const S21Triplet<T>& triplet : triplets) {
+    if (triplet.row < 0 || triplet.row >= rows_ || triplet.col < 0 ||
+        triplet.col >= cols_)
+      throw std::invalid_argument("Index out of range");
+    long outer = csr ? triplet.row : triplet.col;
+    long inner = csr ? triplet.col : triplet.row;
+    entries.emplace_back(outer * getInner() + inner, triplet.value);
+  }
+  std::stable_sort(entries.begin(), entries.end(),
+                   [](const std::pair<long, T>& lhs,
+                      const std::pair<long, T>& rhs) {
+                     return lhs.first < rhs.first;
+                   });
+  for (std::size_t p = 0; p < entries.size();) {
+    long key = entries[p].first;
+    T sum = 0;
+    for (; p < entries.size() && entries[p].first == key; p++)
+      sum += entries[p].second;
+    if (sum == T(0)) continue;
+    offsets_[key / getInner() + 1]++;
+    indices_.push_back((int)(key % getInner()));
+    values_.push_back(sum);
+  }
+  std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+}
+
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(const S21BasicMatrix<T>& dense,
+                                              S21SparseFormat format, T drop)
+    : S21BasicSparseMatrix(dense.getRows(), dense.getCols(), format) {
+  bool csr = format_ == S21SparseFormat::kCsr;
+  for (int k = 0; k < getOuter(); k++) {
+    for (int m = 0; m < getInner(); m++) {
+      T value = csr ? dense.at_unchecked(k, m) : dense.at_unchecked(m, k);
+      if (std::abs(value) > drop) {
+        indices_.push_back(m);
+        values_.push_back(value);
+      }
+    }
+    offsets_[k + 1] = (int)values_.size();
+  }
+}
+
+template <typename T>
+S21BasicSparseMatrix<T>::S21BasicSparseMatrix(int rows, int cols,
+                                              S21SparseFormat format,
+                                              std::vector<int> offsets,
+                                              std::vector<int> indices,
+                                              std::vector<T> values)
+    : rows_(rows),
+      cols_(cols),
+      format_(format),
+      offsets_(std::move(offsets)),
+      indices_(std::move(indices)),
+      values_(std::move(values)) {}
+
+template <typename T>
+int S21BasicSparseMatrix<T>::getOuter() const noexcept {
+  return format_ == S21SparseFormat::kCsr ? rows_ : cols_;
+}
+
+template <typename T>
+int S21BasicSparseMatrix<T>::getInner() const noexcept {
+  return format_ == S21SparseFormat::kCsr ? cols_ : rows_;
+}
+
+template <typename T>
+T S21BasicSparseMatrix<T>::operator()(int i, int j) const {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_)
+    throw std::invalid_argument("Index out of range");
+  int outer = format_ == S21SparseFormat::kCsr ? i : j;
+  int inner = format_ == S21SparseFormat::kCsr ? j : i;
+  auto first = indices_.begin() + offsets_[outer];
+  auto last = indices_.begin() + offsets_[outer + 1];
+  auto found = std::lower_bound(first, last, inner);
+  if (found == last || *found != inner) return T(0);
+  return values_[found - indices_.begin()];
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicSparseMatrix<T>::ToDense() const {
+  S21BasicMatrix<T> result(rows_, cols_);
+  bool csr = format_ == S21SparseFormat::kCsr;
+  for (int k = 0; k < getOuter(); k++) {
+    for (int p = offsets_[k]; p < offsets_[k + 1]; p++) {
+      if (csr)
+        result.at_unchecked(k, indices_[p]) = values_[p];
+      else
+        result.at_unchecked(indices_[p], k) = values_[p];
+    }
+  }
+  return result;
+}
+
+// Counting sort of the nonzeros by inner index: the lines of the other
+// format come out already sorted.
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::Convert() const {
+  int outer = getOuter();
+  int inner = getInner();
+  std::vector<int> offsets(inner + 1, 0);
+  for (int index : indices_) offsets[index + 1]++;
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<int> next(offsets.begin(), offsets.end() - 1);
+  std::vector<int> indices(values_.size());
+  std::vector<T> values(values_.size());
+  for (int k = 0; k < outer; k++) {
+    for (int p = offsets_[k]; p < offsets_[k + 1]; p++) {
+      int q = next[indices_[p]]++;
+      indices[q] = k;
+      values[q] = values_[p];
+    }
+  }
+  S21SparseFormat format = format_ == S21SparseFormat::kCsr
+                               ? S21SparseFormat::kCsc
+                               : S21SparseFormat::kCsr;
+  return S21BasicSparseMatrix(rows_, cols_, format, std::move(offsets),
+                              std::move(indices), std::move(values));
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::ToCsr() const {
+  return format_ == S21SparseFormat::kCsr ? *this : Convert();
+}
+
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::ToCsc() const {
+  return format_ == S21SparseFormat::kCsc ? *this : Convert();
+}
+
+// The lines of A in one format are the lines of A^T in the other, so the
+// transpose is a relabelling followed by a conversion back.
+template <typename T>
+S21BasicSparseMatrix<T> S21BasicSparseMatrix<T>::Transpose() const {
+  S21SparseFormat format = format_ == S21SparseFormat::kCsr
+                               ? S21SparseFormat::kCsc
+                               : S21SparseFormat::kCsr;
+  return S21BasicSparseMatrix(cols_, rows_, format, offsets_, indices_,
+                              values_)
+      .Convert();
+}
+
+template <typename T>
+bool S21BasicSparseMatrix<T>::EqMatrix(
+    const S21BasicSparseMatrix& other) const {
+  if (rows_ != other.rows_ || cols_ != other.cols_) return false;
+  if (format_ != other.format_) return EqMatrix(other.Convert());
+  T eps = S21MatrixTraits<T>::kEpsilon;
+  for (int k = 0; k < getOuter(); k++) {
+    int p = offsets_[k];
+    int q = other.offsets_[k];
+    while (p < offsets_[k + 1] || q < other.offsets_[k + 1]) {
+      int i = p < offsets_[k + 1] ? indices_[p] : getInner();
+      int j = q < other.offsets_[k + 1] ? other.indices_[q] : getInner();
+      T lhs = i <= j ? values_[p++] : T(0);
+      T rhs = j <= i ? other.values_[q++] : T(0);
+      if (std::abs(lhs - rhs) > eps) return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::AddScaled(const S21BasicSparseMatrix& other,
+                                        T factor) {
+  if (rows_ != other.rows_ || cols_ != other.cols_)
+    throw std::invalid_argument("Different dimension of matrices");
+  if (format_ != other.format_) {
+    AddScaled(other.Convert(), factor);
+    return;
+  }
+  std::vector<int> offsets(getOuter() + 1, 0);
+  std::vector<int> indices;
+  std::vector<T> values;
+  indices.reserve(indices_.size() + other.indices_.size());
+  values.reserve(indices_.size() + other.indices_.size());
+  for (int k = 0; k < getOuter(); k++) {
+    int p = offsets_[k];
+    int q = other.offsets_[k];
+    while (p < offsets_[k + 1] || q < other.offsets_[k + 1]) {
+      int i = p < offsets_[k + 1] ? indices_[p] : getInner();
+      int j = q < other.offsets_[k + 1] ? other.indices_[q] : getInner();
+      int index = std::min(i, j);
+      T sum = i <= j ? values_[p++] : T(0);
+      if (j <= i) sum += factor * other.values_[q++];
+      if (sum != T(0)) {
+        indices.push_back(index);
+        values.push_back(sum);
+      }
+    }
+    offsets[k + 1] = (int)values.size();
+  }
+  offsets_ = std::move(offsets);
+  indices_ = std::move(indices);
+  values_ = std::move(values);
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::SumMatrix(const S21BasicSparseMatrix& other) {
+  AddScaled(other, T(1));
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::SubMatrix(const S21BasicSparseMatrix& other) {
+  AddScaled(other, T(-1));
+}
+
+template <typename T>
+void S21BasicSparseMatrix<T>::MulNumber(const T num) {
+  if (num == T(0)) {
+    *this = S21BasicSparseMatrix(rows_, cols_, format_);
+    return;
+  }
+  for (T& value : values_) value *= num;
+}
+
+// In CSR, C = A * B row by row. In CSC the stored lines are those of A^T
+// and B^T, so the same routine computes C^T = B^T * A^T line by line, which
+// is C in CSC.
+template <typename T>
+void S21BasicSparseMatrix<T>::MulMatrix(const S21BasicSparseMatrix& other) {
+  if (cols_ != other.rows_) {
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the number "
+        "of rows of the second matrix");
+  }
+  if (format_ != other.format_) {
+    MulMatrix(other.Convert());
+    return;
+  }
+  std::vector<int> offsets;
+  std::vector<int> indices;
+  std::vector<T> values;
+  Lines<T> lhs{offsets_, indices_, values_};
+  Lines<T> rhs{other.offsets_, other.indices_, other.values_};
+  if (format_ == S21SparseFormat::kCsr)
+    MultiplyLines(rows_, other.cols_, lhs, rhs, offsets, indices, values);
+  else
+    MultiplyLines(other.cols_, rows_, rhs, lhs, offsets, indices, values);
+  cols_ = other.cols_;
+  offsets_ = std::move(offsets);
+  indices_ = std::move(indices);
+  values_ = std::move(values);
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicSparseMatrix<T>::MulMatrix(
+    const S21BasicMatrix<T>& other) const {
+  if (cols_ != other.getRows()) {
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the number "
+        "of rows of the second matrix");
+  }
+  if (format_ == S21SparseFormat::kCsc) return Convert().MulMatrix(other);
+  int width = other.getCols();
+  S21BasicMatrix<T> result(rows_, width);
+  ParallelLines(rows_, ((long)values_.size() + rows_) * width,
+                [&](long first, long last) {
+                  for (long i = first; i < last; i++) {
+                    T* out = result.data() + i * result.stride();
+                    for (int p = offsets_[i]; p < offsets_[i + 1]; p++) {
+                      T factor = values_[p];
+                      const T* row = other.data() +
+                                     (std::size_t)indices_[p] * other.stride();
+                      for (int j = 0; j < width; j++) out[j] += factor * row[j];
+                    }
+                  }
+                });
+  return result;
+}
+
+template <typename T>
+std::vector<T> S21BasicSparseMatrix<T>::MulVector(
+    const std::vector<T>& x) const {
+  if ((int)x.size() != cols_)
+    throw std::invalid_argument(
+        "The size of the vector is not equal to the number of columns");
+  std::vector<T> y(rows_, T(0));
+  if (format_ == S21SparseFormat::kCsc) {
+    // Columns scatter into shared rows, so this one stays serial.
+    for (int j = 0; j < cols_; j++)
+      for (int p = offsets_[j]; p < offsets_[j + 1]; p++)
+        y[indices_[p]] += values_[p] * x[j];
+    return y;
+  }
+  ParallelLines(rows_, (long)values_.size() + rows_,
+                [&](long first, long last) {
+                  for (long i = first; i < last; i++) {
+                    T sum = 0;
+                    for (int p = offsets_[i]; p < offsets_[i + 1]; p++)
+                      sum += values_[p] * x[indices_[p]];
+                    y[i] = sum;
+                  }
+                });
+  return y;
+}
+
+template class S21BasicSparseMatrix<float>;
+template class S21BasicSparseMatrix<double>;
+template class S21BasicSparseMatrix<long double>;
@@ -0,0 +1,94 @@
+#ifndef SRC_S21_SPARSE_MATRIX_H_
+#define SRC_S21_SPARSE_MATRIX_H_
+
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+// Compressed sparse row (kCsr) or column (kCsc) storage.
+enum class S21SparseFormat { kCsr, kCsc };
+
+template <typename T>
+struct S21Triplet {
+  int row;
+  int col;
+  T value;
+};
+
+// Matrix that stores only its nonzeros, in compressed rows or columns:
+// the nonzeros of outer line k (row for CSR, column for CSC) are
+// getValues()[getOffsets()[k] .. getOffsets()[k + 1]), with their inner
+// positions in getIndices(), sorted. Memory grows with the number of
+// nonzeros, not with rows * cols.
+//
+// Products and sums keep the format of the left operand and accept any
+// format on the right, converting it first when the formats differ. Sums
+// drop the exact zeros that cancellation produces.
+template <typename T>
+class S21BasicSparseMatrix {
+ public:
+  using value_type = T;
+
+  // All-zero matrix.
+  S21BasicSparseMatrix(int rows, int cols,
+                       S21SparseFormat format = S21SparseFormat::kCsr);
+  // Duplicate positions are summed.
+  S21BasicSparseMatrix(int rows, int cols,
+                       const std::vector<S21Triplet<T>>& triplets,
+                       S21SparseFormat format = S21SparseFormat::kCsr);
+  // Keeps the elements with |value| > drop.
+  explicit S21BasicSparseMatrix(const S21BasicMatrix<T>& dense,
+                                S21SparseFormat format = S21SparseFormat::kCsr,
+                                T drop = T(0));
+
+  int getRows() const noexcept { return rows_; }
+  int getCols() const noexcept { return cols_; }
+  S21SparseFormat getFormat() const noexcept { return format_; }
+  int getNonZeros() const noexcept { return (int)values_.size(); }
+  const std::vector<int>& getOffsets() const noexcept { return offsets_; }
+  const std::vector<int>& getIndices() const noexcept { return indices_; }
+  const std::vector<T>& getValues() const noexcept { return values_; }
+
+  // Element (i, j), zero when it is not stored.
+  T operator()(int i, int j) const;
+  S21BasicMatrix<T> ToDense() const;
+  S21BasicSparseMatrix ToCsr() const;
+  S21BasicSparseMatrix ToCsc() const;
+
+  bool EqMatrix(const S21BasicSparseMatrix& other) const;
+  void SumMatrix(const S21BasicSparseMatrix& other);
+  void SubMatrix(const S21BasicSparseMatrix& other);
+  void MulNumber(const T num);
+  // Sparse product (Gustavson's row-by-row algorithm).
+  void MulMatrix(const S21BasicSparseMatrix& other);
+  S21BasicMatrix<T> MulMatrix(const S21BasicMatrix<T>& other) const;
+  // y = A * x; CSR matrices split the rows across the thread pool.
+  std::vector<T> MulVector(const std::vector<T>& x) const;
+  S21BasicSparseMatrix Transpose() const;
+
+ private:
+  S21BasicSparseMatrix(int rows, int cols, S21SparseFormat format,
+                       std::vector<int> offsets, std::vector<int> indices,
+                       std::vector<T> values);
+
+  int getOuter() const noexcept;
+  int getInner() const noexcept;
+  // Same matrix in the other format.
+  S21BasicSparseMatrix Convert() const;
+  void AddScaled(const S21BasicSparseMatrix& other, T factor);
+
+  int rows_;
+  int cols_;
+  S21SparseFormat format_;
+  std::vector<int> offsets_;
+  std::vector<int> indices_;
+  std::vector<T> values_;
+};
+
+extern template class S21BasicSparseMatrix<float>;
+extern template class S21BasicSparseMatrix<double>;
+extern template class S21BasicSparseMatrix<long double>;
+
+using S21SparseMatrix = S21BasicSparseMatrix<double>;
+
+#endif  // SRC_S21_SPARSE_MATRIX_H_
@@ -0,0 +1,221 @@
+#include "s21_thread_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Index of the pool worker running on this thread, -1 for outside threads.
+thread_local int current_worker = -1;
+
+int HardwareThreads() {
+  int count = (int)std::thread::hardware_concurrency();
+  return count > 0 ? count : 1;
+}
+
+}  // namespace
+
+S21ThreadPool& S21ThreadPool::Instance() {
+  static S21ThreadPool pool;
+  return pool;
+}
+
+S21ThreadPool::S21ThreadPool()
+    : workers_(),
+      thread_count_(1),
+      affinity_(false),
+      sleep_mutex_(),
+      wake_(),
+      queued_(0),
+      stopping_(false) {
+  const char* affinity = std::getenv("S21_MATRIX_AFFINITY");
+  affinity_ = affinity != nullptr && std::strcmp(affinity, "1") == 0;
+  const char* threads = std::getenv("S21_MATRIX_THREADS");
+  Start(threads != nullptr ? std::atoi(threads) : 0);
+}
+
+S21ThreadPool::~S21ThreadPool() { Stop(); }
+
+void S21ThreadPool::SetThreadCount(int count) {
+  Stop();
+  Start(count);
+}
+
+int S21ThreadPool::getThreadCount() const { return thread_count_; }
+
+void S21ThreadPool::SetAffinity(bool enabled) {
+  if (enabled != affinity_) {
+    affinity_ = enabled;
+    SetThreadCount(thread_count_);
+  }
+}
+
+bool S21ThreadPool::getAffinity() const { return affinity_; }
+
+void S21ThreadPool::ParallelFor(long begin, long end, long grain,
+                                const std::function<void(long, long)>& body) {
+  long length = end - begin;
+  if (length <= 0) return;
+  grain = std::max(grain, 1L);
+  long chunks = std::min((length + grain - 1) / grain, 4L * thread_count_);
+  if (thread_count_ == 1 || chunks <= 1) {
+    body(begin, end);
+    return;
+  }
+
+  long chunk_size = (length + chunks - 1) / chunks;
+  chunks = (length + chunk_size - 1) / chunk_size;
+
+  Job job;
+  job.body = &body;
+  job.pending.store(chunks);
+  int self = current_worker;
+  int queues = (int)workers_.size();
+  int queue = self >= 0 ? self : 0;
+  for (long chunk_begin = begin; chunk_begin < end; chunk_begin += chunk_size) {
+    Worker& worker = *workers_[queue];
+    {
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      worker.tasks.push_back(
+          {&job, chunk_begin, std::min(end, chunk_begin + chunk_size)});
+    }
+    queue = (queue + 1) % queues;
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    queued_ += chunks;
+  }
+  wake_.notify_all();
+
+  while (job.pending.load() > 0) {
+    Task task;
+    if ((self >= 0 && PopTask(self, task)) || StealTask(self, task)) {
+      RunTask(task);
+    } else {
+      std::unique_lock<std::mutex> lock(job.mutex);
+      job.done.wait(lock, [&job] { return job.pending.load() == 0; });
+    }
+  }
+  // Workers decrement and notify under job.mutex; taking it once more makes
+  // sure the last of them has let go before the job leaves the stack.
+  std::lock_guard<std::mutex> lock(job.mutex);
+  if (job.error) std::rethrow_exception(job.error);
+}
+
+void S21ThreadPool::Start(int count) {
+  thread_count_ = count > 0 ? count : HardwareThreads();
+  stopping_ = false;
+  for (int i = 0; i + 1 < thread_count_; i++)
+    workers_.push_back(std::make_unique<Worker>());
+  for (int i = 0; i + 1 < thread_count_; i++)
+    workers_[i]->thread = std::thread(&S21ThreadPool::WorkerLoop, this, i);
+}
+
+void S21ThreadPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_)
+    if (worker->thread.joinable()) worker->thread.join();
+  workers_.clear();
+  queued_.store(0);
+}
+
+void S21ThreadPool::WorkerLoop(int index) {
+  current_worker = index;
+  if (affinity_) PinCurrentThread((index + 1) % HardwareThreads());
+
+  while (true) {
+    Task task;
+    if (PopTask(index, task) || StealTask(index, task)) {
+      RunTask(task);
+    } else {
+      std::unique_lock<std::mutex> lock(sleep_mutex_);
+      wake_.wait(lock, [this] { return stopping_ || queued_.load() > 0; });
+      if (stopping_) break;
+    }
+  }
+}
+
+bool S21ThreadPool::PopTask(int index, Task& task) {
+  Worker& worker = *workers_[index];
+  std::lock_guard<std::mutex> lock(worker.mutex);
+  bool found = !worker.tasks.empty();
+  if (found) {
+    task = worker.tasks.pop_back();
+    queued_--;
+  }
+  return found;
+}
+
+bool S21ThreadPool::StealTask(int thief, Task& task) {
+  int queues = (int)workers_.size();
+  bool found = false;
+  for (int offset = 1; !found && offset <= queues; offset++) {
+    int victim = (thief + offset + queues) % queues;
+    if (victim == thief) continue;
+    Worker& worker = *workers_[victim];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (!worker.tasks.empty()) {
+      task = worker.tasks.pop_front();
+      queued_--;
+      found = true;
+    }
+  }
+  return found;
+}
+
+void S21ThreadPool::RunTask(const Task& task) {
+  Job* job = task.job;
+  try {
+    (*job->body)(task.begin, task.end);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(job->mutex);
+    if (!job->error) job->error = std::current_exception();
+  }
+  std::lock_guard<std::mutex> lock(job->mutex);
+  if (job->pending.fetch_sub(1) == 1) job->done.notify_all();
+}
+
+void S21ThreadPool::TaskQueue::push_back(const Task& task) {
+  if (size_ == ring_.size()) {
+    std::vector<Task> grown(std::max<std::size_t>(16, 2 * ring_.size()));
+    for (std::size_t i = 0; i < size_; i++)
+      grown[i] = ring_[(head_ + i) % ring_.size()];
+    ring_.swap(grown);
+    head_ = 0;
+  }
+  ring_[(head_ + size_) % ring_.size()] = task;
+  size_++;
+}
+
+S21ThreadPool::Task S21ThreadPool::TaskQueue::pop_back() {
+  size_--;
+  return ring_[(head_ + size_) % ring_.size()];
+}
+
+S21ThreadPool::Task S21ThreadPool::TaskQueue::pop_front() {
+  Task task = ring_[head_];
+  head_ = (head_ + 1) % ring_.size();
+  size_--;
+  return task;
+}
+
+void S21ThreadPool::PinCurrentThread(int cpu) const {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)cpu;
+#endif
+}
@@ -0,0 +1,103 @@
+#ifndef SRC_S21_THREAD_POOL_H_
+#define SRC_S21_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Operations smaller than this many scalar operations run on the calling
+// thread; below it the cost of waking workers outweighs the gain.
+constexpr long kS21SerialCutoff = 1L << 16;
+
+// Library-owned work-stealing pool. Each worker owns a queue: it pops its
+// own tasks from the back and steals from the front of the others when it
+// runs dry. The thread that calls ParallelFor takes part in the work until
+// its loop is done, so nested ParallelFor calls from inside a task are fine.
+//
+// The thread count comes from S21_MATRIX_THREADS (default: all hardware
+// threads) and includes the calling thread. With S21_MATRIX_AFFINITY=1, or
+// after SetAffinity(true), worker i is pinned to CPU i (Linux only).
+class S21ThreadPool {
+ public:
+  static S21ThreadPool& Instance();
+
+  S21ThreadPool(const S21ThreadPool&) = delete;
+  S21ThreadPool& operator=(const S21ThreadPool&) = delete;
+  ~S21ThreadPool();
+
+  // count <= 0 selects the number of hardware threads. Must not be called
+  // while a ParallelFor is in flight.
+  void SetThreadCount(int count);
+  int getThreadCount() const;
+  void SetAffinity(bool enabled);
+  bool getAffinity() const;
+
+  // Calls body(chunk_begin, chunk_end) for chunks of [begin, end) no shorter
+  // than grain and returns once all of them have finished. The first
+  // exception thrown by body is rethrown here.
+  void ParallelFor(long begin, long end, long grain,
+                   const std::function<void(long, long)>& body);
+
+ private:
+  struct Job {
+    const std::function<void(long, long)>* body;
+    std::atomic<long> pending;
+    std::mutex mutex;
+    std::condition_variable done;
+    std::exception_ptr error;
+  };
+
+  struct Task {
+    Job* job;
+    long begin;
+    long end;
+  };
+
+  // Double-ended ring of tasks. Unlike std::deque it keeps its storage, so
+  // once it has grown to the deepest backlog queuing allocates nothing.
+  class TaskQueue {
+   public:
+    bool empty() const { return size_ == 0; }
+    void push_back(const Task& task);
+    Task pop_back();
+    Task pop_front();
+
+   private:
+    std::vector<Task> ring_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+  };
+
+  struct Worker {
+    std::mutex mutex;
+    TaskQueue tasks;
+    std::thread thread;
+  };
+
+  S21ThreadPool();
+
+  void Start(int count);
+  void Stop();
+  void WorkerLoop(int index);
+  bool PopTask(int index, Task& task);
+  bool StealTask(int thief, Task& task);
+  void RunTask(const Task& task);
+  void PinCurrentThread(int cpu) const;
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  int thread_count_;
+  bool affinity_;
+
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  std::atomic<long> queued_;
+  bool stopping_;
+};
+
+#endif  // SRC_S21_THREAD_POOL_H_
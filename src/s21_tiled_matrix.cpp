@@ -0,0 +1,773 @@
+#include "s21_tiled_matrix.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_io.h"
+#include "s21_matrix_memory.h"
+
+namespace {
+
+// Reads queued ahead of the computation; more would only evict tiles that
+// are still to be used.
+constexpr std::size_t kMaxQueued = 8;
+
+// Creates an unlinked temporary file of the given size in directory.
+int CreateTileFile(const std::string& directory, std::size_t bytes) {
+  std::string dir = directory;
+  if (dir.empty()) {
+    const char* tmp = std::getenv("TMPDIR");
+    dir = tmp && *tmp ? tmp : "/tmp";
+  }
+  std::string name = dir + "/s21_tiles_XXXXXX";
+  std::vector<char> path(name.begin(), name.end());
+  path.push_back('\0');
+  int fd = mkstemp(path.data());
+  if (fd < 0) throw std::runtime_error("Cannot create a tile file in " + dir);
+  unlink(path.data());
+  if (ftruncate(fd, (off_t)bytes) != 0) {
+    close(fd);
+    throw std::runtime_error("Cannot create a tile file in " + dir);
+  }
+  return fd;
+}
+
+// Keeps a tile of the cache pinned for the lifetime of the object.
+template <typename T>
+class PinnedTile {
+ public:
+  PinnedTile(S21TileCache& cache, long tile, S21TileCache::Access access)
+      : cache_(cache),
+        tile_(tile),
+        data_(static_cast<T*>(cache.Pin(tile, access))) {}
+  PinnedTile(const PinnedTile&) = delete;
+  PinnedTile& operator=(const PinnedTile&) = delete;
+  ~PinnedTile() { cache_.Unpin(tile_); }
+
+  T* data() const noexcept { return data_; }
+
+ private:
+  S21TileCache& cache_;
+  long tile_;
+  T* data_;
+};
+
+template <typename T>
+void SwapRows(S21BasicMatrix<T>& matrix, int a, int b) {
+  T* row_a = matrix.data() + (std::size_t)a * matrix.stride();
+  T* row_b = matrix.data() + (std::size_t)b * matrix.stride();
+  std::swap_ranges(row_a, row_a + matrix.getCols(), row_b);
+}
+
+}  // namespace
+
+S21TileCache::S21TileCache(int fd, std::size_t tile_bytes, std::size_t budget)
+    : fd_(fd),
+      tile_bytes_(tile_bytes),
+      budget_(budget),
+      stop_(false),
+      stats_() {}
+
+S21TileCache::~S21TileCache() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  queued_.notify_all();
+  if (io_thread_.joinable()) io_thread_.join();
+  for (auto& entry : entries_) Free(entry.second.data);
+  close(fd_);
+}
+
+void* S21TileCache::Allocate() const {
+  return S21HeapResource()->allocate(tile_bytes_,
+                                     S21BasicMatrix<double>::kAlignment);
+}
+
+void S21TileCache::Free(void* data) const {
+  S21HeapResource()->deallocate(data, tile_bytes_,
+                                S21BasicMatrix<double>::kAlignment);
+}
+
+void S21TileCache::ReadTile(long tile, void* data) const {
+  char* bytes = static_cast<char*>(data);
+  off_t offset = (off_t)tile * tile_bytes_;
+  for (std::size_t done = 0; done < tile_bytes_;) {
+    ssize_t count = pread(fd_, bytes + done, tile_bytes_ - done, offset + done);
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) throw std::runtime_error("Cannot read a tile");
+    done += count;
+  }
+}
+
+void S21TileCache::WriteTile(long tile, const void* data) const {
+  const char* bytes = static_cast<const char*>(data);
+  off_t offset = (off_t)tile * tile_bytes_;
+  for (std::size_t done = 0; done < tile_bytes_;) {
+    ssize_t count =
+        pwrite(fd_, bytes + done, tile_bytes_ - done, offset + done);
+    if (count < 0 && errno == EINTR) continue;
+    if (count <= 0) throw std::runtime_error("Cannot write a tile");
+    done += count;
+  }
+}
+
+// Write-backs happen under the lock, so a tile is never read from the file
+// while its newer contents are on their way there.
+S21TileCache::Entry& S21TileCache::Insert(long tile, void* data) {
+  try {
+    auto it = recency_.end();
+    while ((entries_.size() + 1) * tile_bytes_ > budget_ &&
+           it != recency_.begin()) {
+      --it;
+      long victim_tile = *it;
+      Entry& victim = entries_.at(victim_tile);
+      if (victim.pins > 0) continue;
+      if (victim.dirty) {
+        WriteTile(victim_tile, victim.data);
+        stats_.write_backs++;
+      }
+      Free(victim.data);
+      entries_.erase(victim_tile);
+      it = recency_.erase(it);
+      stats_.evictions++;
+    }
+  } catch (...) {
+    Free(data);
+    throw;
+  }
+  recency_.push_front(tile);
+  Entry& entry = entries_[tile];
+  entry = Entry{data, 0, false, recency_.begin()};
+  return entry;
+}
+
+void* S21TileCache::Pin(long tile, Access access) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  loaded_.wait(lock, [&] { return in_flight_.count(tile) == 0; });
+  Entry* entry;
+  auto found = entries_.find(tile);
+  if (found != entries_.end()) {
+    stats_.hits++;
+    entry = &found->second;
+    recency_.splice(recency_.begin(), recency_, entry->position);
+    if (access == Access::kOverwrite) std::memset(entry->data, 0, tile_bytes_);
+  } else {
+    stats_.misses++;
+    void* data = Allocate();
+    if (access == Access::kOverwrite) {
+      std::memset(data, 0, tile_bytes_);
+    } else {
+      // Other tiles stay available while this one is read.
+      in_flight_.insert(tile);
+      lock.unlock();
+      try {
+        ReadTile(tile, data);
+      } catch (...) {
+        Free(data);
+        lock.lock();
+        in_flight_.erase(tile);
+        loaded_.notify_all();
+        throw;
+      }
+      lock.lock();
+      in_flight_.erase(tile);
+      loaded_.notify_all();
+    }
+    entry = &Insert(tile, data);
+  }
+  entry->pins++;
+  if (access != Access::kRead) entry->dirty = true;
+  return entry->data;
+}
+
+void S21TileCache::Unpin(long tile) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.at(tile).pins--;
+}
+
+void S21TileCache::Prefetch(long tile) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  // A budget of a few tiles has no room for tiles read ahead.
+  if (budget_ < 4 * tile_bytes_ || queue_.size() >= kMaxQueued ||
+      entries_.count(tile) || in_flight_.count(tile) ||
+      std::find(queue_.begin(), queue_.end(), tile) != queue_.end())
+    return;
+  queue_.push_back(tile);
+  if (!io_thread_.joinable())
+    io_thread_ = std::thread(&S21TileCache::IoLoop, this);
+  queued_.notify_one();
+}
+
+S21TileCacheStats S21TileCache::getStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+// A failed read is dropped: Pin() will read the tile again and report it.
+void S21TileCache::IoLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    queued_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+    if (stop_) return;
+    long tile = queue_.front();
+    queue_.pop_front();
+    if (entries_.count(tile) || in_flight_.count(tile)) continue;
+    in_flight_.insert(tile);
+    lock.unlock();
+    void* data = nullptr;
+    try {
+      data = Allocate();
+      ReadTile(tile, data);
+    } catch (...) {
+      if (data) Free(data);
+      data = nullptr;
+    }
+    lock.lock();
+    in_flight_.erase(tile);
+    if (data) {
+      try {
+        Insert(tile, data);
+        stats_.prefetched++;
+      } catch (...) {
+      }
+    }
+    loaded_.notify_all();
+  }
+}
+
+template <typename T>
+S21BasicTiledMatrix<T>::S21BasicTiledMatrix(int rows, int cols, int tile_size,
+                                            std::size_t cache_bytes,
+                                            const std::string& directory)
+    : rows_(rows), cols_(cols), tile_size_(tile_size), directory_(directory) {
+  if (rows <= 0 || cols <= 0)
+    throw std::invalid_argument("Invalid size of matrix");
+  if (tile_size <= 0) throw std::invalid_argument("Invalid tile size");
+  std::size_t tile_bytes = (std::size_t)tile_size * tile_size * sizeof(T);
+  int fd = CreateTileFile(directory,
+                          tile_bytes * (std::size_t)TileRows() * TileCols());
+  cache_ = std::make_unique<S21TileCache>(fd, tile_bytes, cache_bytes);
+}
+
+template <typename T>
+int S21BasicTiledMatrix<T>::TileRows() const noexcept {
+  return (rows_ + tile_size_ - 1) / tile_size_;
+}
+
+template <typename T>
+int S21BasicTiledMatrix<T>::TileCols() const noexcept {
+  return (cols_ + tile_size_ - 1) / tile_size_;
+}
+
+template <typename T>
+int S21BasicTiledMatrix<T>::RowsIn(int t) const noexcept {
+  return std::min(tile_size_, rows_ - t * tile_size_);
+}
+
+template <typename T>
+int S21BasicTiledMatrix<T>::ColsIn(int t) const noexcept {
+  return std::min(tile_size_, cols_ - t * tile_size_);
+}
+
+template <typename T>
+long S21BasicTiledMatrix<T>::TileIndex(int tile_row,
+                                       int tile_col) const noexcept {
+  return (long)tile_row * TileCols() + tile_col;
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::Prefetch(int tile_row, int tile_col) const {
+  if (tile_row < TileRows() && tile_col < TileCols())
+    cache_->Prefetch(TileIndex(tile_row, tile_col));
+}
+
+template <typename T>
+S21BasicTiledMatrix<T> S21BasicTiledMatrix<T>::Empty(int rows,
+                                                     int cols) const {
+  return S21BasicTiledMatrix(rows, cols, tile_size_, cache_->getBudget(),
+                             directory_);
+}
+
+template <typename T>
+S21BasicTiledMatrix<T> S21BasicTiledMatrix<T>::Clone() const {
+  S21BasicTiledMatrix copy = Empty(rows_, cols_);
+  std::size_t bytes = cache_->getTileBytes();
+  long tiles = (long)TileRows() * TileCols();
+  for (long tile = 0; tile < tiles; tile++) {
+    if (tile + 1 < tiles) cache_->Prefetch(tile + 1);
+    PinnedTile<T> source(*cache_, tile, S21TileCache::Access::kRead);
+    PinnedTile<T> target(*copy.cache_, tile, S21TileCache::Access::kOverwrite);
+    std::memcpy(target.data(), source.data(), bytes);
+  }
+  return copy;
+}
+
+template <typename T>
+S21BasicTiledMatrix<T> S21BasicTiledMatrix<T>::FromMatrix(
+    const S21BasicMatrix<T>& matrix, int tile_size, std::size_t cache_bytes) {
+  S21BasicTiledMatrix tiled(matrix.getRows(), matrix.getCols(), tile_size,
+                            cache_bytes);
+  tiled.WriteBlock(0, 0, matrix);
+  return tiled;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicTiledMatrix<T>::ToMatrix() const {
+  return ReadBlock(0, 0, rows_, cols_);
+}
+
+template <typename T>
+S21BasicTiledMatrix<T> S21BasicTiledMatrix<T>::FromBinary(
+    const std::string& path, int tile_size, std::size_t cache_bytes) {
+  S21BinaryHeader header = S21ReadBinaryHeader(path);
+  if (header.element_type != S21ElementTypeOf<T>())
+    throw std::runtime_error(
+        "Element type of the matrix file does not match: " + path);
+  if (header.layout != S21MatrixLayout::kRowMajor)
+    throw std::runtime_error("Only row-major matrix files can be tiled: " +
+                             path);
+
+  S21BasicTiledMatrix tiled((int)header.rows, (int)header.cols, tile_size,
+                            cache_bytes);
+  std::ifstream file(path, std::ios::binary);
+  file.seekg(header.payload_offset);
+  std::size_t row_bytes = (std::size_t)tiled.cols_ * sizeof(T);
+  S21Checksum checksum;
+  for (int row = 0; row < tiled.rows_; row += tile_size) {
+    S21BasicMatrix<T> band(std::min(tile_size, tiled.rows_ - row),
+                           tiled.cols_);
+    for (int i = 0; i < band.getRows(); i++) {
+      char* target =
+          reinterpret_cast<char*>(band.data() + (std::size_t)i * band.stride());
+      if (!file.read(target, row_bytes))
+        throw std::runtime_error("Truncated matrix file: " + path);
+      checksum.Update(target, row_bytes);
+    }
+    tiled.WriteBlock(row, 0, band);
+  }
+  if (checksum.Finish() != header.checksum)
+    throw std::runtime_error("Checksum mismatch in matrix file: " + path);
+  return tiled;
+}
+
+// The checksum is only known once every band has gone out, so the header is
+// written last.
+template <typename T>
+void S21BasicTiledMatrix<T>::SaveBinary(const std::string& path) const {
+  S21BinaryHeader header = {};
+  std::memcpy(header.magic, S21BinaryHeader::kMagic, 8);
+  header.version = S21BinaryHeader::kVersion;
+  header.byte_order = S21BinaryHeader::kByteOrder;
+  header.rows = rows_;
+  header.cols = cols_;
+  header.element_type = S21ElementTypeOf<T>();
+  header.element_size = sizeof(T);
+  header.layout = S21MatrixLayout::kRowMajor;
+  header.payload_offset = sizeof(header);
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) throw std::runtime_error("Cannot open: " + path);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  std::size_t row_bytes = (std::size_t)cols_ * sizeof(T);
+  S21Checksum checksum;
+  for (int row = 0; row < rows_; row += tile_size_) {
+    S21BasicMatrix<T> band =
+        ReadBlock(row, 0, std::min(tile_size_, rows_ - row), cols_);
+    for (int i = 0; i < band.getRows(); i++) {
+      const T* source = band.data() + (std::size_t)i * band.stride();
+      checksum.Update(source, row_bytes);
+      file.write(reinterpret_cast<const char*>(source), row_bytes);
+    }
+  }
+  header.checksum = checksum.Finish();
+  file.seekp(0);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.close();
+  if (!file) throw std::runtime_error("Cannot write: " + path);
+}
+
+template <typename T>
+T S21BasicTiledMatrix<T>::Get(int i, int j) const {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_)
+    throw std::invalid_argument("Index out of range");
+  int t = tile_size_;
+  PinnedTile<T> tile(*cache_, TileIndex(i / t, j / t),
+                     S21TileCache::Access::kRead);
+  return tile.data()[(std::size_t)(i % t) * t + j % t];
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::Set(int i, int j, T value) {
+  if (i < 0 || i >= rows_ || j < 0 || j >= cols_)
+    throw std::invalid_argument("Index out of range");
+  int t = tile_size_;
+  PinnedTile<T> tile(*cache_, TileIndex(i / t, j / t),
+                     S21TileCache::Access::kWrite);
+  tile.data()[(std::size_t)(i % t) * t + j % t] = value;
+}
+
+template <typename T>
+S21BasicMatrix<T> S21BasicTiledMatrix<T>::ReadBlock(int row, int col,
+                                                    int rows,
+                                                    int cols) const {
+  if (row < 0 || col < 0 || rows <= 0 || cols <= 0 || row + rows > rows_ ||
+      col + cols > cols_)
+    throw std::invalid_argument("Index out of range");
+  S21BasicMatrix<T> block(rows, cols);
+  int t = tile_size_;
+  int last_tr = (row + rows - 1) / t, last_tc = (col + cols - 1) / t;
+  for (int tr = row / t; tr <= last_tr; tr++) {
+    for (int tc = col / t; tc <= last_tc; tc++) {
+      if (tc < last_tc)
+        Prefetch(tr, tc + 1);
+      else
+        Prefetch(tr + 1, col / t);
+      PinnedTile<T> tile(*cache_, TileIndex(tr, tc),
+                         S21TileCache::Access::kRead);
+      int i0 = std::max(row, tr * t), i1 = std::min(row + rows, tr * t + t);
+      int j0 = std::max(col, tc * t), j1 = std::min(col + cols, tc * t + t);
+      for (int i = i0; i < i1; i++) {
+        const T* source = tile.data() + (std::size_t)(i - tr * t) * t;
+        T* target = block.data() + (std::size_t)(i - row) * block.stride();
+        std::copy(source + (j0 - tc * t), source + (j1 - tc * t),
+                  target + (j0 - col));
+      }
+    }
+  }
+  return block;
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::WriteBlock(int row, int col,
+                                        const S21BasicMatrix<T>& block) {
+  int rows = block.getRows(), cols = block.getCols();
+  if (row < 0 || col < 0 || row + rows > rows_ || col + cols > cols_)
+    throw std::invalid_argument("Index out of range");
+  int t = tile_size_;
+  int last_tr = (row + rows - 1) / t, last_tc = (col + cols - 1) / t;
+  for (int tr = row / t; tr <= last_tr; tr++) {
+    for (int tc = col / t; tc <= last_tc; tc++) {
+      int i0 = std::max(row, tr * t), i1 = std::min(row + rows, tr * t + t);
+      int j0 = std::max(col, tc * t), j1 = std::min(col + cols, tc * t + t);
+      // Tiles the block covers entirely need not be read first.
+      bool covered = i1 - i0 == RowsIn(tr) && j1 - j0 == ColsIn(tc);
+      if (!covered) {
+        if (tc < last_tc)
+          Prefetch(tr, tc + 1);
+        else
+          Prefetch(tr + 1, col / t);
+      }
+      PinnedTile<T> tile(*cache_, TileIndex(tr, tc),
+                         covered ? S21TileCache::Access::kOverwrite
+                                 : S21TileCache::Access::kWrite);
+      for (int i = i0; i < i1; i++) {
+        const T* source =
+            block.data() + (std::size_t)(i - row) * block.stride();
+        T* target = tile.data() + (std::size_t)(i - tr * t) * t;
+        std::copy(source + (j0 - col), source + (j1 - col),
+                  target + (j0 - tc * t));
+      }
+    }
+  }
+}
+
+template <typename T>
+void S21BasicTiledMatrix<T>::SumMatrix(const S21BasicTiledMatrix& other) {
+  if (rows_ != other.rows_ || cols_ != other.cols_)
+    throw std::invalid_argument("Different dimension of matrices");
+  if (tile_size_ != other.tile_size_)
+    throw std::invalid_argument("Different tile sizes of matrices");
+  int t = tile_size_;
+  for (int tr = 0; tr < TileRows(); tr++) {
+    for (int tc = 0; tc < TileCols(); tc++) {
+      int next_tr = tc + 1 < TileCols() ? tr : tr + 1;
+      int next_tc = tc + 1 < TileCols() ? tc + 1 : 0;
+      Prefetch(next_tr, next_tc);
+      other.Prefetch(next_tr, next_tc);
+      PinnedTile<T> target(*cache_, TileIndex(tr, tc),
+                           S21TileCache::Access::kWrite);
+      PinnedTile<T> source(*other.cache_, other.TileIndex(tr, tc),
+                           S21TileCache::Access::kRead);
+      for (int i = 0; i < RowsIn(tr); i++) {
+        T* a = target.data() + (std::size_t)i * t;
+        const T* b = source.data() + (std::size_t)i * t;
+        for (int j = 0; j < ColsIn(tc); j++) a[j] += b[j];
+      }
+    }
+  }
+}
+
+// C(i, j) accumulates A(i, k) * B(k, j) over k in a pinned tile of C; the
+// tile row of A is reused across j, so a budget of one tile row of A plus a
+// few tiles keeps A from being read more than once.
+template <typename T>
+void S21BasicTiledMatrix<T>::MulMatrix(const S21BasicTiledMatrix& other) {
+  if (cols_ != other.rows_)
+    throw std::invalid_argument(
+        "The number of columns of the first matrix is not equal to the "
+        "number of rows of the second matrix");
+  if (tile_size_ != other.tile_size_)
+    throw std::invalid_argument("Different tile sizes of matrices");
+  int t = tile_size_;
+  S21BasicTiledMatrix product = Empty(rows_, other.cols_);
+  for (int tr = 0; tr < product.TileRows(); tr++) {
+    for (int tc = 0; tc < product.TileCols(); tc++) {
+      PinnedTile<T> c(*product.cache_, product.TileIndex(tr, tc),
+                      S21TileCache::Access::kOverwrite);
+      for (int tk = 0; tk < TileCols(); tk++) {
+        if (tk + 1 < TileCols()) {
+          Prefetch(tr, tk + 1);
+          other.Prefetch(tk + 1, tc);
+        } else {
+          other.Prefetch(0, tc + 1);
+        }
+        PinnedTile<T> a(*cache_, TileIndex(tr, tk),
+                        S21TileCache::Access::kRead);
+        PinnedTile<T> b(*other.cache_, other.TileIndex(tk, tc),
+                        S21TileCache::Access::kRead);
+        S21GemmStrided(RowsIn(tr), other.ColsIn(tc), ColsIn(tk), T(1),
+                       a.data(), t, 1, b.data(), t, 1, T(1), c.data(), t);
+      }
+    }
+  }
+  *this = std::move(product);
+}
+
+template <typename T>
+S21BasicTiledMatrix<T> S21BasicTiledMatrix<T>::Transpose() const {
+  int t = tile_size_;
+  S21BasicTiledMatrix result = Empty(cols_, rows_);
+  for (int tr = 0; tr < result.TileRows(); tr++) {
+    for (int tc = 0; tc < result.TileCols(); tc++) {
+      if (tc + 1 < result.TileCols())
+        Prefetch(tc + 1, tr);
+      else
+        Prefetch(0, tr + 1);
+      PinnedTile<T> source(*cache_, TileIndex(tc, tr),
+                           S21TileCache::Access::kRead);
+      PinnedTile<T> target(*result.cache_, result.TileIndex(tr, tc),
+                           S21TileCache::Access::kOverwrite);
+      for (int i = 0; i < result.RowsIn(tr); i++) {
+        T* row = target.data() + (std::size_t)i * t;
+        for (int j = 0; j < result.ColsIn(tc); j++)
+          row[j] = source.data()[(std::size_t)j * t + i];
+      }
+    }
+  }
+  return result;
+}
+
+template <typename T>
+S21BasicTiledLU<T> S21BasicTiledMatrix<T>::LU() const {
+  return S21BasicTiledLU<T>(*this);
+}
+
+namespace {
+
+template <typename T>
+const S21BasicTiledMatrix<T>& RequireSquare(
+    const S21BasicTiledMatrix<T>& matrix) {
+  if (matrix.getRows() != matrix.getCols())
+    throw std::invalid_argument("The matrix is not square");
+  return matrix;
+}
+
+}  // namespace
+
+// Right-looking: strip k (rows k0.., one tile wide) is factored with partial
+// pivoting in memory; each strip to its right then gets the row swaps, the
+// solve with the unit lower triangle L11 for its U12 block and the update
+// A22 -= L21 * U12. Swaps for the strips to the left are collected and
+// applied in a single pass at the end, since nothing reads those strips
+// again.
+template <typename T>
+S21BasicTiledLU<T>::S21BasicTiledLU(const S21BasicTiledMatrix<T>& matrix)
+    : lu_(RequireSquare(matrix).Clone()),
+      pivots_(matrix.getRows()),
+      sign_(1),
+      singular_(false) {
+  int n = getSize();
+  int t = lu_.getTileSize();
+  int tiles = lu_.TileCols();
+
+  for (int k = 0; k < tiles; k++) {
+    int k0 = k * t, w = lu_.ColsIn(k), h = n - k0;
+    S21BasicMatrix<T> panel = lu_.ReadBlock(k0, k0, h, w);
+    T* p = panel.data();
+    int ps = panel.stride();
+    for (int c = 0; c < w; c++) {
+      int pivot = c;
+      T pivot_value = std::abs(p[(std::size_t)c * ps + c]);
+      for (int i = c + 1; i < h; i++) {
+        T value = std::abs(p[(std::size_t)i * ps + c]);
+        if (value > pivot_value) {
+          pivot = i;
+          pivot_value = value;
+        }
+      }
+      pivots_[k0 + c] = k0 + pivot;
+      if (pivot != c) {
+        SwapRows(panel, c, pivot);
+        sign_ = -sign_;
+      }
+      if (pivot_value == T(0)) {
+        singular_ = true;
+        continue;
+      }
+      const T* row_c = p + (std::size_t)c * ps;
+      for (int i = c + 1; i < h; i++) {
+        T* row_i = p + (std::size_t)i * ps;
+        T factor = row_i[c] / row_c[c];
+        row_i[c] = factor;
+        if (factor != T(0))
+          for (int j = c + 1; j < w; j++) row_i[j] -= factor * row_c[j];
+      }
+    }
+    lu_.WriteBlock(k0, k0, panel);
+
+    for (int j = k + 1; j < tiles; j++) {
+      int wj = lu_.ColsIn(j);
+      S21BasicMatrix<T> strip = lu_.ReadBlock(k0, j * t, h, wj);
+      T* s = strip.data();
+      int ss = strip.stride();
+      for (int c = 0; c < w; c++)
+        if (pivots_[k0 + c] != k0 + c) SwapRows(strip, c, pivots_[k0 + c] - k0);
+      for (int i = 1; i < w; i++) {
+        T* row_i = s + (std::size_t)i * ss;
+        for (int c = 0; c < i; c++) {
+          T factor = p[(std::size_t)i * ps + c];
+          const T* row_c = s + (std::size_t)c * ss;
+          for (int col = 0; col < wj; col++) row_i[col] -= factor * row_c[col];
+        }
+      }
+      if (h > w)
+        S21GemmStrided(h - w, wj, w, T(-1), p + (std::size_t)w * ps, ps, 1, s,
+                       ss, 1, T(1), s + (std::size_t)w * ss, ss);
+      lu_.WriteBlock(k0, j * t, strip);
+    }
+  }
+
+  for (int j = 0; j + 1 < tiles; j++) {
+    int r0 = (j + 1) * t;
+    S21BasicMatrix<T> strip = lu_.ReadBlock(r0, j * t, n - r0, t);
+    for (int r = r0; r < n; r++)
+      if (pivots_[r] != r) SwapRows(strip, r - r0, pivots_[r] - r0);
+    lu_.WriteBlock(r0, j * t, strip);
+  }
+}
+
+template <typename T>
+int S21BasicTiledLU<T>::getSize() const {
+  return lu_.getRows();
+}
+
+template <typename T>
+bool S21BasicTiledLU<T>::IsSingular() const {
+  return singular_;
+}
+
+template <typename T>
+T S21BasicTiledLU<T>::Determinant() const {
+  T determinant = 0;
+  if (!singular_) {
+    determinant = sign_;
+    for (int i = 0; i < getSize(); i++) determinant *= lu_.Get(i, i);
+  }
+  return determinant;
+}
+
+// Block forward and back substitution over tile rows: off-diagonal tiles are
+// applied to the right-hand side with GEMM, diagonal ones are solved
+// directly.
+template <typename T>
+S21BasicMatrix<T> S21BasicTiledLU<T>::Solve(const S21BasicMatrix<T>& b) const {
+  if (b.getRows() != getSize())
+    throw std::invalid_argument(
+        "The number of rows of the right-hand side is not equal to the size "
+        "of the matrix");
+  if (singular_) throw std::invalid_argument("The matrix is singular");
+
+  int n = getSize();
+  int m = b.getCols();
+  int t = lu_.getTileSize();
+  int tiles = lu_.TileRows();
+  S21BasicMatrix<T> x(b);
+  T* xd = x.data();
+  int xs = x.stride();
+  S21TileCache& cache = *lu_.cache_;
+  for (int k = 0; k < n; k++)
+    if (pivots_[k] != k) SwapRows(x, k, pivots_[k]);
+
+  for (int i = 0; i < tiles; i++) {
+    int hi = lu_.RowsIn(i);
+    T* x_i = xd + (std::size_t)i * t * xs;
+    for (int k = 0; k <= i; k++) {
+      lu_.Prefetch(k < i ? i : i + 1, k < i ? k + 1 : 0);
+      PinnedTile<T> l(cache, lu_.TileIndex(i, k), S21TileCache::Access::kRead);
+      if (k < i) {
+        S21GemmStrided(hi, m, t, T(-1), l.data(), t, 1,
+                       xd + (std::size_t)k * t * xs, xs, 1, T(1), x_i, xs);
+        continue;
+      }
+      for (int r = 1; r < hi; r++)
+        for (int c = 0; c < r; c++) {
+          T factor = l.data()[(std::size_t)r * t + c];
+          T* x_r = x_i + (std::size_t)r * xs;
+          const T* x_c = x_i + (std::size_t)c * xs;
+          for (int j = 0; j < m; j++) x_r[j] -= factor * x_c[j];
+        }
+    }
+  }
+
+  for (int i = tiles - 1; i >= 0; i--) {
+    int hi = lu_.RowsIn(i);
+    T* x_i = xd + (std::size_t)i * t * xs;
+    for (int k = tiles - 1; k >= i; k--) {
+      if (k > i) lu_.Prefetch(i, k - 1);
+      PinnedTile<T> u(cache, lu_.TileIndex(i, k), S21TileCache::Access::kRead);
+      if (k > i) {
+        S21GemmStrided(hi, m, lu_.ColsIn(k), T(-1), u.data(), t, 1,
+                       xd + (std::size_t)k * t * xs, xs, 1, T(1), x_i, xs);
+        continue;
+      }
+      for (int r = hi - 1; r >= 0; r--) {
+        T* x_r = x_i + (std::size_t)r * xs;
+        for (int c = r + 1; c < hi; c++) {
+          T factor = u.data()[(std::size_t)r * t + c];
+          const T* x_c = x_i + (std::size_t)c * xs;
+          for (int j = 0; j < m; j++) x_r[j] -= factor * x_c[j];
+        }
+        T diagonal = u.data()[(std::size_t)r * t + r];
+        for (int j = 0; j < m; j++) x_r[j] /= diagonal;
+      }
+    }
+  }
+  return x;
+}
+
+template <typename T>
+const S21BasicTiledMatrix<T>& S21BasicTiledLU<T>::getLU() const {
+  return lu_;
+}
+
+template <typename T>
+const std::vector<int>& S21BasicTiledLU<T>::getPivots() const {
+  return pivots_;
+}
+
+template class S21BasicTiledMatrix<float>;
+template class S21BasicTiledMatrix<double>;
+template class S21BasicTiledMatrix<long double>;
+template class S21BasicTiledLU<float>;
+template class S21BasicTiledLU<double>;
+template class S21BasicTiledLU<long double>;
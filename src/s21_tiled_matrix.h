@@ -0,0 +1,208 @@
+#ifndef SRC_S21_TILED_MATRIX_H_
+#define SRC_S21_TILED_MATRIX_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "s21_matrix_oop.h"
+
+struct S21TileCacheStats {
+  long hits;
+  long misses;
+  // Tiles read ahead by the I/O thread.
+  long prefetched;
+  long evictions;
+  // Evicted tiles that had to be written back to the file.
+  long write_backs;
+};
+
+// LRU cache of the fixed-size tiles of a file: tile t occupies bytes
+// [t * tile_bytes, (t + 1) * tile_bytes). At most budget bytes of tiles stay
+// resident, more only while more tiles than that are pinned. Modified tiles
+// are written back when evicted. Prefetch() hands tiles to a background I/O
+// thread, so their reads overlap with the work on the tiles already pinned.
+// All members are thread-safe.
+class S21TileCache {
+ public:
+  enum class Access {
+    kRead,
+    // Marks the tile modified.
+    kWrite,
+    // Marks it modified and skips the read: the tile starts zero-filled.
+    kOverwrite
+  };
+
+  // Takes ownership of fd.
+  S21TileCache(int fd, std::size_t tile_bytes, std::size_t budget);
+  S21TileCache(const S21TileCache&) = delete;
+  S21TileCache& operator=(const S21TileCache&) = delete;
+  ~S21TileCache();
+
+  // The tile stays resident until the matching Unpin().
+  void* Pin(long tile, Access access);
+  void Unpin(long tile);
+  // Queues a read of the tile unless it is resident or already queued.
+  void Prefetch(long tile);
+
+  std::size_t getTileBytes() const noexcept { return tile_bytes_; }
+  std::size_t getBudget() const noexcept { return budget_; }
+  S21TileCacheStats getStats() const;
+
+ private:
+  struct Entry {
+    void* data;
+    int pins;
+    bool dirty;
+    std::list<long>::iterator position;
+  };
+
+  void* Allocate() const;
+  void Free(void* data) const;
+  void ReadTile(long tile, void* data) const;
+  void WriteTile(long tile, const void* data) const;
+  // Inserts a loaded tile, evicting least recently used unpinned tiles to
+  // stay within the budget. Called with mutex_ held.
+  Entry& Insert(long tile, void* data);
+  void IoLoop();
+
+  int fd_;
+  std::size_t tile_bytes_;
+  std::size_t budget_;
+  mutable std::mutex mutex_;
+  // Signalled when a read in flight completes.
+  std::condition_variable loaded_;
+  std::condition_variable queued_;
+  std::unordered_map<long, Entry> entries_;
+  // Most recently used first.
+  std::list<long> recency_;
+  std::unordered_set<long> in_flight_;
+  std::deque<long> queue_;
+  std::thread io_thread_;
+  bool stop_;
+  S21TileCacheStats stats_;
+};
+
+template <typename T>
+class S21BasicTiledLU;
+
+// Matrix kept in a file as square tiles of tile_size x tile_size elements
+// and streamed through an S21TileCache of cache_bytes, for matrices that do
+// not fit in memory. The file is an unlinked temporary one, so it goes away
+// with the matrix; FromBinary() and SaveBinary() convert from and to the
+// format of s21_matrix_io.h.
+//
+// Operations walk the tiles in an order that reuses cached ones and prefetch
+// the tiles they need next while the current ones are multiplied or added.
+// Operands of the same operation must have the same tile size.
+template <typename T>
+class S21BasicTiledMatrix {
+ public:
+  static constexpr int kDefaultTileSize = 256;
+  static constexpr std::size_t kDefaultCacheBytes = std::size_t(256) << 20;
+
+  // Zero matrix. The file is created in directory, by default $TMPDIR or
+  // /tmp; it is sparse until tiles are written.
+  S21BasicTiledMatrix(int rows, int cols, int tile_size = kDefaultTileSize,
+                      std::size_t cache_bytes = kDefaultCacheBytes,
+                      const std::string& directory = "");
+  S21BasicTiledMatrix(S21BasicTiledMatrix&& other) noexcept = default;
+  S21BasicTiledMatrix& operator=(S21BasicTiledMatrix&& other) noexcept =
+      default;
+
+  static S21BasicTiledMatrix FromMatrix(
+      const S21BasicMatrix<T>& matrix, int tile_size = kDefaultTileSize,
+      std::size_t cache_bytes = kDefaultCacheBytes);
+  // Streams a row-major file with elements of type T, tile_size rows at a
+  // time, verifying its checksum. Throws std::runtime_error like
+  // S21BasicMatrix::LoadBinary.
+  static S21BasicTiledMatrix FromBinary(
+      const std::string& path, int tile_size = kDefaultTileSize,
+      std::size_t cache_bytes = kDefaultCacheBytes);
+  S21BasicMatrix<T> ToMatrix() const;
+  void SaveBinary(const std::string& path) const;
+
+  int getRows() const noexcept { return rows_; }
+  int getCols() const noexcept { return cols_; }
+  int getTileSize() const noexcept { return tile_size_; }
+  S21TileCacheStats getCacheStats() const { return cache_->getStats(); }
+
+  T Get(int i, int j) const;
+  void Set(int i, int j, T value);
+  // Copies of the rows x cols block at (row, col) and back.
+  S21BasicMatrix<T> ReadBlock(int row, int col, int rows, int cols) const;
+  void WriteBlock(int row, int col, const S21BasicMatrix<T>& block);
+
+  void SumMatrix(const S21BasicTiledMatrix& other);
+  void MulMatrix(const S21BasicTiledMatrix& other);
+  S21BasicTiledMatrix Transpose() const;
+  S21BasicTiledLU<T> LU() const;
+
+ private:
+  int TileRows() const noexcept;
+  int TileCols() const noexcept;
+  // Number of valid rows (columns) in tile row (column) t.
+  int RowsIn(int t) const noexcept;
+  int ColsIn(int t) const noexcept;
+  long TileIndex(int tile_row, int tile_col) const noexcept;
+  // Ignores tiles past the last row or column.
+  void Prefetch(int tile_row, int tile_col) const;
+  // A new matrix of the same shape, tiling and cache budget.
+  S21BasicTiledMatrix Empty(int rows, int cols) const;
+  S21BasicTiledMatrix Clone() const;
+
+  int rows_;
+  int cols_;
+  int tile_size_;
+  std::string directory_;
+  std::unique_ptr<S21TileCache> cache_;
+
+  friend class S21BasicTiledLU<T>;
+};
+
+// LU factorization with partial pivoting of a tiled matrix, P * A = L * U,
+// with both factors in a tiled copy of A. It proceeds in column strips one
+// tile wide: the current strip is factored in memory, then every strip to
+// its right is read, updated and written back, so besides the caches it
+// needs memory for two n x tile_size strips.
+template <typename T>
+class S21BasicTiledLU {
+ public:
+  explicit S21BasicTiledLU(const S21BasicTiledMatrix<T>& matrix);
+
+  int getSize() const;
+  bool IsSingular() const;
+  T Determinant() const;
+  // b is an in-memory right-hand side; U and L stream through the cache.
+  S21BasicMatrix<T> Solve(const S21BasicMatrix<T>& b) const;
+
+  const S21BasicTiledMatrix<T>& getLU() const;
+  // Row k was swapped with row getPivots()[k] at step k.
+  const std::vector<int>& getPivots() const;
+
+ private:
+  S21BasicTiledMatrix<T> lu_;
+  std::vector<int> pivots_;
+  int sign_;
+  bool singular_;
+};
+
+extern template class S21BasicTiledMatrix<float>;
+extern template class S21BasicTiledMatrix<double>;
+extern template class S21BasicTiledMatrix<long double>;
+extern template class S21BasicTiledLU<float>;
+extern template class S21BasicTiledLU<double>;
+extern template class S21BasicTiledLU<long double>;
+
+using S21TiledMatrix = S21BasicTiledMatrix<double>;
+using S21TiledLU = S21BasicTiledLU<double>;
+
+#endif  // SRC_S21_TILED_MATRIX_H_
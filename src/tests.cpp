@@ -1,6 +1,31 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "s21_fixed_matrix.h"
+#include "s21_matrix_batch.h"
+#include "s21_matrix_blas.h"
+#include "s21_matrix_gemm.h"
+#include "s21_matrix_io.h"
+#include "s21_matrix_memory.h"
 #include "s21_matrix_oop.h"
+#include "s21_matrix_simd.h"
+#include "s21_matrix_solver.h"
+#include "s21_matrix_stats.h"
+#include "s21_sparse_matrix.h"
+#include "s21_tiled_matrix.h"
+#include "s21_thread_pool.h"
 
 TEST(MatrixConstructor, DefaultConstructor) {
   S21Matrix A;
@@ -8,6 +33,13 @@ TEST(MatrixConstructor, DefaultConstructor) {
   EXPECT_EQ(A.getCols(), 1);
 }
 
+TEST(MatrixConstructor, DefaultConstructorIsAccessible) {
+  S21Matrix A;
+  EXPECT_NEAR(A(0, 0), 0.0, EPS);
+  A(0, 0) = 2.5;
+  EXPECT_NEAR(A(0, 0), 2.5, EPS);
+}
+
 TEST(MatrixConstructor, ConstructorWithRowsAndCols) {
   int rows = 3;
   int cols = 4;
@@ -64,6 +96,24 @@ TEST(S21MatrixTest, ConstructorMove) {
   EXPECT_NEAR(B(1, 1), -3.55, EPS);
 }
 
+TEST(MatrixMethods, DataIsContiguousAndAligned) {
+  S21Matrix A(3, 5);
+  for (int i = 0; i < A.getRows(); i++)
+    for (int j = 0; j < A.getCols(); j++) A(i, j) = i * 10 + j;
+
+  const double* data = A.data();
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(data) % S21Matrix::kAlignment,
+            0u);
+  EXPECT_EQ(A.stride(), 5);
+  for (int i = 0; i < A.getRows(); i++)
+    for (int j = 0; j < A.getCols(); j++)
+      EXPECT_NEAR(data[i * A.stride() + j], i * 10 + j, EPS);
+
+  S21Matrix B(A);
+  EXPECT_NE(B.data(), A.data());
+  EXPECT_TRUE(B == A);
+}
+
 TEST(MatrixMethods, SetRows) {
   S21Matrix A(2, 3);
   A(0, 0) = 1.25;
@@ -856,6 +906,1802 @@ TEST(S21MatrixTest, InverseMatrix_4x4) {
   EXPECT_EQ(B.getCols(), 4);
 }
 
+TEST(S21MatrixTest, LU_ReusedForSolveDeterminantAndInverse) {
+  S21Matrix A(3, 3);
+  A(0, 0) = 2.0;
+  A(0, 1) = 1.0;
+  A(0, 2) = 1.0;
+  A(1, 0) = 4.0;
+  A(1, 1) = -6.0;
+  A(1, 2) = 0.0;
+  A(2, 0) = -2.0;
+  A(2, 1) = 7.0;
+  A(2, 2) = 2.0;
+
+  S21MatrixLU lu = A.LU();
+  EXPECT_FALSE(lu.IsSingular());
+  EXPECT_NEAR(lu.Determinant(), -16.0, EPS);
+
+  S21Matrix b(3, 2);
+  b(0, 0) = 5.0;
+  b(1, 0) = -2.0;
+  b(2, 0) = 9.0;
+  b(0, 1) = 1.0;
+  b(1, 1) = 0.0;
+  b(2, 1) = 0.0;
+  S21Matrix x = lu.Solve(b);
+
+  EXPECT_NEAR(x(0, 0), 1.0, EPS);
+  EXPECT_NEAR(x(1, 0), 1.0, EPS);
+  EXPECT_NEAR(x(2, 0), 2.0, EPS);
+  EXPECT_TRUE(A * x == b);
+  EXPECT_TRUE(A * lu.InverseMatrix() == A * A.InverseMatrix());
+}
+
+TEST(S21MatrixTest, Solve_InvalidInput_Throws) {
+  S21Matrix A(2, 2);
+  S21Matrix b(2, 1);
+  EXPECT_THROW(A.Solve(b), std::invalid_argument);
+  EXPECT_TRUE(A.LU().IsSingular());
+
+  A(0, 0) = 1.0;
+  A(1, 1) = 1.0;
+  S21Matrix wrong(3, 1);
+  EXPECT_THROW(A.Solve(wrong), std::invalid_argument);
+  EXPECT_THROW(S21MatrixLU lu(S21Matrix(2, 3)), std::invalid_argument);
+}
+
+TEST(S21MatrixTest, InverseMatrix_Large) {
+  int n = 120;
+  S21Matrix A(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++)
+      A(i, j) = (i == j) ? n : ((i * 7 + j * 3) % 11) - 5;
+
+  S21Matrix identity(n, n);
+  for (int i = 0; i < n; i++) identity(i, i) = 1.0;
+
+  EXPECT_TRUE(A * A.InverseMatrix() == identity);
+  EXPECT_NE(A.Determinant(), 0.0);
+}
+
+static S21Matrix NaiveProduct(const S21Matrix& a, const S21Matrix& b) {
+  S21Matrix result(a.getRows(), b.getCols());
+  for (int i = 0; i < a.getRows(); i++)
+    for (int j = 0; j < b.getCols(); j++)
+      for (int k = 0; k < a.getCols(); k++) result(i, j) += a(i, k) * b(k, j);
+  return result;
+}
+
+static S21Matrix PatternMatrix(int rows, int cols, int seed) {
+  S21Matrix result(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      result(i, j) = ((i * 31 + j * 17 + seed) % 23) / 4.0 - 2.5;
+  return result;
+}
+
+TEST(S21MatrixTest, MulMatrix_BlockedRectangular_MatchesNaive) {
+  S21Matrix A = PatternMatrix(131, 77, 1);
+  S21Matrix B = PatternMatrix(77, 203, 2);
+  S21Matrix expected = NaiveProduct(A, B);
+
+  EXPECT_TRUE(A * B == expected);
+
+  S21SetGemmBlocking({8, 16, 24});
+  A.MulMatrix(B);
+  S21ResetGemmBlocking();
+  EXPECT_TRUE(A == expected);
+}
+
+TEST(S21MatrixTest, GemmStrided_TransposedOperandsAndBeta) {
+  S21Matrix A = PatternMatrix(45, 60, 3);
+  S21Matrix B = PatternMatrix(70, 45, 4);
+  S21Matrix C = PatternMatrix(60, 70, 5);
+  S21Matrix expected = NaiveProduct(A.Transpose(), B.Transpose()) * 2.0;
+  expected += C * 0.5;
+
+  S21GemmStrided(60, 70, 45, 2.0, A.data(), 1, A.stride(), B.data(), 1,
+                 B.stride(), 0.5, C.data(), C.stride());
+
+  EXPECT_TRUE(C == expected);
+}
+
+TEST(S21MatrixTest, GemmStrassen_OddSizesAndStrides) {
+  S21Matrix A = PatternMatrix(93, 101, 3);
+  S21Matrix B = PatternMatrix(77, 93, 4);
+  S21Matrix C = PatternMatrix(101, 77, 5);
+  S21Matrix expected = NaiveProduct(A.Transpose(), B.Transpose()) * 2.0;
+  expected += C * 0.5;
+
+  // Crossover 8 recurses through odd sizes down to 12 x 9 x 11.
+  S21GemmStrassen(101, 77, 93, 2.0, A.data(), 1, A.stride(), B.data(), 1,
+                  B.stride(), 0.5, C.data(), C.stride(), 8);
+  EXPECT_TRUE(C == expected);
+
+  S21Matrix product(101, 77);
+  S21GemmStrassen(101, 77, 93, 1.0, A.data(), 1, A.stride(), B.data(), 1,
+                  B.stride(), 0.0, product.data(), product.stride(), 1);
+  EXPECT_TRUE(product == NaiveProduct(A.Transpose(), B.Transpose()));
+  EXPECT_THROW(S21GemmStrassen(1, 1, 1, 1.0, A.data(), 1, 1, B.data(), 1, 1,
+                               0.0, product.data(), 1, 0),
+               std::invalid_argument);
+}
+
+TEST(S21MatrixTest, Strassen_SelectedGloballyOrPerCall) {
+  S21Matrix A = PatternMatrix(130, 120, 6);
+  S21Matrix B = PatternMatrix(120, 140, 7);
+  S21Matrix expected = NaiveProduct(A, B);
+  int crossover = S21GetStrassenCrossover();
+  S21SetStrassenCrossover(16);
+
+  S21Matrix C = A;
+  C.MulMatrix(B, S21MulAlgorithm::kStrassen);
+  EXPECT_TRUE(C == expected);
+  EXPECT_EQ(S21GetMulAlgorithm(), S21MulAlgorithm::kClassic);
+  S21SetMulAlgorithm(S21MulAlgorithm::kStrassen);
+  EXPECT_TRUE(A * B == expected);
+  EXPECT_TRUE(A.block(1, 2, 100, 110) * B.block(2, 3, 110, 90) ==
+              NaiveProduct(S21Matrix(A.block(1, 2, 100, 110)),
+                           S21Matrix(B.block(2, 3, 110, 90))));
+  S21SetMulAlgorithm(S21MulAlgorithm::kClassic);
+  S21SetStrassenCrossover(crossover);
+  EXPECT_THROW(S21SetStrassenCrossover(0), std::invalid_argument);
+}
+
+TEST(S21MatrixTest, Strassen_ErrorWithinDocumentedBound) {
+  // Four levels down to n0 = 16, in float so the error is measurable.
+  int n = 256, n0 = 16, levels = 4;
+  S21MatrixF A(n, n), B(n, n);
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) {
+      A(i, j) = std::sin(i * 0.37f + j * 1.1f);
+      B(i, j) = std::cos(i * 0.71f - j * 0.23f);
+    }
+  S21MatrixF fast(n, n);
+  S21GemmStrassen(n, n, n, 1.0f, A.data(), A.stride(), 1, B.data(),
+                  B.stride(), 1, 0.0f, fast.data(), fast.stride(), n0);
+  double error = 0;
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < n; j++) {
+      long double sum = 0;
+      for (int p = 0; p < n; p++) sum += (long double)A(i, p) * B(p, j);
+      error = std::max(error, (double)std::fabs(sum - fast(i, j)));
+    }
+  double bound = ((double)n0 * n0 + 6.0 * n0) * std::pow(18.0, levels) -
+                 6.0 * n;
+  bound *= std::numeric_limits<float>::epsilon() / 2;
+  EXPECT_LE(error, bound);
+}
+
+TEST(S21MatrixTest, SimdLevels_AgreeWithEachOther) {
+  S21SimdLevel initial = S21GetSimdLevel();
+  S21Matrix A = PatternMatrix(67, 45, 6);
+  S21Matrix B = PatternMatrix(45, 53, 7);
+  S21Matrix C = PatternMatrix(67, 45, 8);
+  S21Matrix product = NaiveProduct(A, B);
+
+  for (S21SimdLevel level : {S21SimdLevel::kScalar, S21SimdLevel::kSse2,
+                             S21SimdLevel::kAvx2, S21SimdLevel::kAvx512}) {
+    S21SimdLevel selected = S21SetSimdLevel(level);
+    EXPECT_LE(selected, level);
+    EXPECT_EQ(S21GetSimdLevel(), selected);
+
+    EXPECT_TRUE(A * B == product);
+    S21Matrix sum = A + C;
+    S21Matrix difference = A - C;
+    S21Matrix scaled = A * -1.5;
+    for (int i = 0; i < A.getRows(); i++) {
+      for (int j = 0; j < A.getCols(); j++) {
+        EXPECT_NEAR(sum(i, j), A(i, j) + C(i, j), EPS);
+        EXPECT_NEAR(difference(i, j), A(i, j) - C(i, j), EPS);
+        EXPECT_NEAR(scaled(i, j), A(i, j) * -1.5, EPS);
+      }
+    }
+    S21Matrix almost(A);
+    almost(A.getRows() - 1, A.getCols() - 1) += 2 * EPS;
+    EXPECT_FALSE(A == almost);
+  }
+  S21SetSimdLevel(initial);
+}
+
+TEST(S21ThreadPoolTest, ParallelFor_CoversRangeOnceAndNests) {
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  int initial = pool.getThreadCount();
+  pool.SetThreadCount(4);
+  EXPECT_EQ(pool.getThreadCount(), 4);
+
+  std::vector<std::atomic<int>> hits(1000);
+  pool.ParallelFor(0, 1000, 7, [&](long first, long last) {
+    for (long i = first; i < last; i++) hits[i]++;
+  });
+  for (auto& hit : hits) EXPECT_EQ(hit.load(), 1);
+
+  std::atomic<long> total(0);
+  pool.ParallelFor(0, 8, 1, [&](long first, long last) {
+    for (long i = first; i < last; i++) {
+      pool.ParallelFor(0, 100, 10, [&](long inner_first, long inner_last) {
+        total += inner_last - inner_first;
+      });
+    }
+  });
+  EXPECT_EQ(total.load(), 800);
+
+  EXPECT_THROW(pool.ParallelFor(0, 100, 1,
+                                [](long first, long last) {
+                                  if (first <= 50 && 50 < last)
+                                    throw std::runtime_error("task failed");
+                                }),
+               std::runtime_error);
+  pool.SetThreadCount(initial);
+}
+
+TEST(S21ThreadPoolTest, ParallelOperations_MatchSerial) {
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  int initial = pool.getThreadCount();
+  S21Matrix A = PatternMatrix(300, 260, 9);
+  S21Matrix B = PatternMatrix(260, 310, 10);
+  S21Matrix C = PatternMatrix(300, 260, 11);
+  S21Matrix D = PatternMatrix(180, 180, 12);
+  for (int i = 0; i < D.getRows(); i++) D(i, i) += 200.0;
+
+  pool.SetThreadCount(1);
+  S21Matrix product = A * B;
+  S21Matrix sum = A + C;
+  S21Matrix transposed = A.Transpose();
+  S21Matrix inverse = D.InverseMatrix();
+
+  pool.SetThreadCount(4);
+  EXPECT_TRUE(A * B == product);
+  EXPECT_TRUE(A + C == sum);
+  EXPECT_TRUE(A.Transpose() == transposed);
+  EXPECT_TRUE(D.InverseMatrix() == inverse);
+  EXPECT_FALSE(A == C);
+  pool.SetThreadCount(initial);
+}
+
+TEST(S21MatrixExprTest, FusedChain_MatchesEagerOperations) {
+  S21Matrix A = PatternMatrix(7, 5, 1);
+  S21Matrix B = PatternMatrix(7, 5, 2);
+  S21Matrix C = PatternMatrix(7, 5, 3);
+  S21Matrix expected(A);
+  expected.SumMatrix(B);
+  S21Matrix scaled(C);
+  scaled.MulNumber(2.0);
+  expected.SubMatrix(scaled);
+
+  S21Matrix D = A + B - C * 2.0;
+  EXPECT_TRUE(D.EqMatrix(expected));
+  EXPECT_TRUE(A + B - 2.0 * C == expected);
+  EXPECT_TRUE(expected == -(C * 2.0 - B - A));
+  EXPECT_TRUE((A + B) / 0.5 == (A + B) * 2.0);
+  EXPECT_DOUBLE_EQ(S21Matrix(S21MulElements(A, B))(3, 4), A(3, 4) * B(3, 4));
+
+  // The lazy comparison draws the line exactly where EqMatrix does.
+  S21Matrix zero(2, 2), edge(2, 2), nan(2, 2);
+  edge(0, 0) = S21MatrixTraits<double>::kEpsilon;
+  nan(1, 1) = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_EQ(zero == edge * 1.0, zero.EqMatrix(edge));
+  EXPECT_EQ(zero == nan * 1.0, zero.EqMatrix(nan));
+}
+
+TEST(S21MatrixExprTest, AssignmentReusesDestinationAndAllowsAliasing) {
+  S21Matrix A = PatternMatrix(40, 30, 4);
+  S21Matrix B = PatternMatrix(40, 30, 5);
+  S21Matrix expected(A);
+  expected.SumMatrix(B);
+  expected.SumMatrix(B);
+
+  S21Matrix D(40, 30);
+  const double* buffer = D.data();
+  D = A + B;
+  EXPECT_EQ(D.data(), buffer);
+  D = D + B;
+  EXPECT_EQ(D.data(), buffer);
+  EXPECT_TRUE(D == expected);
+  D -= B * 2.0;
+  EXPECT_TRUE(D == A);
+  EXPECT_EQ(D.data(), buffer);
+}
+
+TEST(S21MatrixExprTest, DimensionMismatch_ThrowsAtTheOperator) {
+  S21Matrix A(3, 3);
+  S21Matrix B(3, 3);
+  S21Matrix C(2, 3);
+  EXPECT_THROW(A + B - C, std::invalid_argument);
+  EXPECT_THROW(S21MulElements(A * 2.0, C), std::invalid_argument);
+  EXPECT_THROW(A += C * 2.0, std::invalid_argument);
+  EXPECT_FALSE(A + B == C);
+}
+
+TEST(S21MatrixExprTest, ProductOfExpressions) {
+  S21Matrix A = PatternMatrix(6, 4, 6);
+  S21Matrix B = PatternMatrix(4, 5, 7);
+  S21Matrix A2(A);
+  A2.MulNumber(2.0);
+  S21Matrix expected = NaiveProduct(A2, B);
+  EXPECT_TRUE((A + A) * B == expected);
+  EXPECT_TRUE(A * (B * 2.0) == expected);
+}
+
+// Matrix buffers come from the aligned operator new; counting its calls
+// shows which operations allocate.
+static std::atomic<long> aligned_allocations(0);
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  aligned_allocations++;
+  std::size_t align = (std::size_t)alignment;
+  void* memory = std::aligned_alloc(align, (size + align - 1) / align * align);
+  if (memory == nullptr) throw std::bad_alloc();
+  return memory;
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept {
+  std::free(memory);
+}
+
+// Every other allocation (std::vector, std::function, ...).
+static std::atomic<long> heap_allocations(0);
+
+void* operator new(std::size_t size) {
+  heap_allocations++;
+  void* memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) throw std::bad_alloc();
+  return memory;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  heap_allocations++;
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+
+void operator delete(void* memory, std::size_t) noexcept { std::free(memory); }
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept {
+  std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept { std::free(memory); }
+
+void operator delete[](void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+TEST(S21MatrixMoveTest, CompoundOperators_ReturnSelfWithoutAllocating) {
+  S21Matrix A = PatternMatrix(20, 20, 1);
+  S21Matrix B = PatternMatrix(20, 20, 2);
+  S21Matrix expected = PatternMatrix(20, 20, 1);
+  expected.SumMatrix(B);
+  expected.MulNumber(2.0);
+  expected.SubMatrix(B);
+
+  long before = aligned_allocations.load();
+  S21Matrix& result = ((A += B) *= 2.0) -= B;
+  EXPECT_EQ(aligned_allocations.load() - before, 0);
+  EXPECT_EQ(&result, &A);
+  EXPECT_TRUE(A == expected);
+}
+
+TEST(S21MatrixMoveTest, MoveAssignment_StealsBuffer) {
+  S21Matrix A(3, 4);
+  S21Matrix B = PatternMatrix(5, 6, 3);
+  const double* buffer = B.data();
+
+  long before = aligned_allocations.load();
+  A = std::move(B);
+  EXPECT_EQ(aligned_allocations.load() - before, 0);
+  EXPECT_EQ(A.data(), buffer);
+  EXPECT_EQ(A.getRows(), 5);
+  EXPECT_EQ(A.getCols(), 6);
+  EXPECT_EQ(B.getRows(), 0);
+  EXPECT_EQ(B.data(), nullptr);
+}
+
+TEST(S21MatrixMoveTest, ProductAssignment_AllocatesOnlyTheResult) {
+  S21Matrix A = PatternMatrix(6, 6, 4);
+  S21Matrix B = PatternMatrix(6, 6, 5);
+  S21Matrix expected = NaiveProduct(A, B);
+  S21Matrix C(A);
+
+  long before = aligned_allocations.load();
+  A = A * B;
+  C.MulMatrix(B);
+  EXPECT_EQ(aligned_allocations.load() - before, 2);
+  EXPECT_TRUE(A == expected);
+  EXPECT_TRUE(C == expected);
+}
+
+TEST(S21MatrixMoveTest, RvalueOperands_ReuseTheirBuffer) {
+  S21Matrix A = PatternMatrix(8, 5, 6);
+  S21Matrix B = PatternMatrix(5, 8, 7);
+  S21Matrix T = B.Transpose();
+  S21Matrix expected = A + T * 3.0 - A / 2.0;
+  const double* buffer = T.data();
+
+  long before = aligned_allocations.load();
+  S21Matrix D = A + std::move(T) * 3.0 - A / 2.0;
+  EXPECT_EQ(aligned_allocations.load() - before, 0);
+  EXPECT_EQ(D.data(), buffer);
+  EXPECT_TRUE(D == expected);
+
+  S21Matrix E = B.Transpose() - A;
+  EXPECT_TRUE(-(A - E) == B.Transpose() - A * 2.0);
+  EXPECT_TRUE(A - B.Transpose() == -E);
+  EXPECT_TRUE(-(B.Transpose() - A) == -E);
+  EXPECT_TRUE(B.Transpose() / 0.5 == 2.0 * B.Transpose());
+  EXPECT_TRUE(B.Transpose() + B.Transpose() == B.Transpose() * 2.0);
+  EXPECT_TRUE(B.Transpose() - B.Transpose() == S21Matrix(8, 5));
+  EXPECT_THROW(B.Transpose() + B, std::invalid_argument);
+}
+
+TEST(S21MatrixMemoryTest, Pool_RecyclesSameSizedBuffers) {
+  S21PoolResource pool;
+  S21Matrix A = PatternMatrix(30, 30, 1);
+  S21Matrix B = PatternMatrix(30, 30, 2);
+  S21Matrix expected = NaiveProduct(A, B) + A;
+  long before = aligned_allocations.load();
+  {
+    S21ScopedResource scope(&pool);
+    for (int round = 0; round < 10; round++) {
+      S21Matrix product = A * B + A;
+      EXPECT_EQ(product.getResource(), &pool);
+      EXPECT_TRUE(product == expected);
+    }
+  }
+  EXPECT_EQ(aligned_allocations.load() - before, 1);
+
+  S21PoolStats stats = pool.getStats();
+  EXPECT_EQ(stats.misses, 1u);
+  EXPECT_EQ(stats.hits, 9u);
+  EXPECT_DOUBLE_EQ(stats.HitRate(), 0.9);
+  EXPECT_EQ(stats.cached_bytes, 8192u);
+  pool.Release();
+  EXPECT_EQ(pool.getStats().cached_bytes, 0u);
+  EXPECT_EQ(S21Matrix(2, 2).getResource(), S21HeapResource());
+}
+
+TEST(S21MatrixMemoryTest, Arena_ScopesTemporariesAndKeepsResults) {
+  S21Matrix A = PatternMatrix(16, 16, 3);
+  for (int i = 0; i < 16; i++) A(i, i) += 16;
+  S21Matrix result(16, 16);
+  const double* buffer = result.data();
+  {
+    S21ScopedArena arena;
+    S21Matrix inverse = A.InverseMatrix();
+    EXPECT_EQ(inverse.getResource(), &arena);
+    // Move assignment across resources copies into the heap buffer.
+    result = std::move(inverse);
+    result = result * A;
+    EXPECT_GE(arena.getAllocations(), 3u);
+    EXPECT_GE(arena.getBytesAllocated(), 3u * 16 * 16 * sizeof(double));
+  }
+  EXPECT_EQ(result.data(), buffer);
+  EXPECT_EQ(result.getResource(), S21HeapResource());
+  S21Matrix identity(16, 16);
+  for (int i = 0; i < 16; i++) identity(i, i) = 1;
+  EXPECT_TRUE(result == identity);
+}
+
+TEST(S21MatrixMemoryTest, CalcComplements_AllocatesIndependentlyOfSize) {
+  S21Matrix A = PatternMatrix(12, 12, 4);
+  for (int i = 0; i < 12; i++) A(i, i) += 12;
+  S21Matrix adjugate = A.InverseMatrix().Transpose() * A.Determinant();
+  long before = aligned_allocations.load();
+  S21Matrix complements = A.CalcComplements();
+  // One LU copy and a few whole-matrix temporaries, no minors.
+  EXPECT_LE(aligned_allocations.load() - before, 5);
+  EXPECT_TRUE(complements / A.Determinant() ==
+              adjugate / A.Determinant());
+}
+
+TEST(S21MatrixAccessTest, AtUnchecked_MatchesCheckedAccess) {
+  S21Matrix A = PatternMatrix(4, 7, 1);
+  const S21Matrix& view = A;
+  for (int i = 0; i < A.getRows(); i++)
+    for (int j = 0; j < A.getCols(); j++) {
+      EXPECT_EQ(&A.at_unchecked(i, j), &A(i, j));
+      EXPECT_DOUBLE_EQ(view.at_unchecked(i, j), A(i, j));
+    }
+  A.at_unchecked(3, 6) = 42.0;
+  EXPECT_DOUBLE_EQ(A(3, 6), 42.0);
+}
+
+TEST(S21MatrixAccessTest, RowSpans_IterateAndModifyRows) {
+  S21Matrix A = PatternMatrix(5, 3, 2);
+  S21Matrix expected(A);
+  expected.MulNumber(2.0);
+  for (int i = 0; i < A.getRows(); i++)
+    for (double& value : A.row(i)) value *= 2.0;
+  EXPECT_TRUE(A == expected);
+
+  const S21Matrix& view = A;
+  S21RowSpan<const double> row = view.row(4);
+  EXPECT_EQ(row.size(), 3);
+  EXPECT_EQ(row.data(), A.data() + 4 * A.stride());
+  EXPECT_DOUBLE_EQ(row[2], A(4, 2));
+  EXPECT_THROW(A.row(5), std::invalid_argument);
+  EXPECT_THROW(view.row(-1), std::invalid_argument);
+}
+
+// Every element distinct, so any misplaced element is noticed.
+static S21Matrix IndexMatrix(int rows, int cols) {
+  S21Matrix result(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++) result(i, j) = i * cols + j;
+  return result;
+}
+
+static bool IsTransposeOf(const S21Matrix& t, const S21Matrix& a) {
+  bool result = t.getRows() == a.getCols() && t.getCols() == a.getRows();
+  for (int i = 0; result && i < a.getRows(); i++)
+    for (int j = 0; j < a.getCols(); j++)
+      if (t(j, i) != a(i, j)) result = false;
+  return result;
+}
+
+TEST(S21MatrixTransposeTest, Blocked_MatchesDefinition) {
+  int shapes[][2] = {{1, 9}, {9, 1}, {33, 33}, {70, 45}, {45, 131}, {300, 290}};
+  for (auto& shape : shapes) {
+    S21Matrix A = IndexMatrix(shape[0], shape[1]);
+    EXPECT_TRUE(IsTransposeOf(A.Transpose(), A));
+  }
+}
+
+TEST(S21MatrixTransposeTest, InPlace_Square) {
+  for (int n : {1, 2, 31, 67, 300}) {
+    S21Matrix A = IndexMatrix(n, n);
+    S21Matrix original(A);
+    const double* buffer = A.data();
+    A.TransposeInPlace();
+    EXPECT_EQ(A.data(), buffer);
+    EXPECT_TRUE(IsTransposeOf(A, original));
+  }
+}
+
+TEST(S21MatrixTransposeTest, InPlace_Rectangular) {
+  int shapes[][2] = {{1, 5}, {5, 1}, {2, 3}, {37, 53}, {128, 64}};
+  for (auto& shape : shapes) {
+    S21Matrix A = IndexMatrix(shape[0], shape[1]);
+    S21Matrix original(A);
+    const double* buffer = A.data();
+    A.TransposeInPlace();
+    EXPECT_EQ(A.data(), buffer);
+    EXPECT_TRUE(IsTransposeOf(A, original));
+    A.TransposeInPlace();
+    EXPECT_TRUE(A == original);
+  }
+}
+
+template <typename T>
+static S21BasicMatrix<T> CastMatrix(const S21Matrix& source) {
+  S21BasicMatrix<T> result(source.getRows(), source.getCols());
+  for (int i = 0; i < source.getRows(); i++)
+    for (int j = 0; j < source.getCols(); j++) result(i, j) = (T)source(i, j);
+  return result;
+}
+
+template <typename T>
+static void ExpectNearMatrix(const S21BasicMatrix<T>& actual,
+                             const S21Matrix& expected, double tolerance) {
+  ASSERT_EQ(actual.getRows(), expected.getRows());
+  ASSERT_EQ(actual.getCols(), expected.getCols());
+  for (int i = 0; i < expected.getRows(); i++)
+    for (int j = 0; j < expected.getCols(); j++)
+      EXPECT_NEAR((double)actual(i, j), expected(i, j), tolerance);
+}
+
+// Runs the same operations as S21Matrix in element type T on every SIMD
+// level, against double results computed naively.
+template <typename T>
+static void ExpectOperationsMatchDouble(double tolerance) {
+  S21SimdLevel initial = S21GetSimdLevel();
+  S21Matrix a = PatternMatrix(67, 45, 1);
+  S21Matrix b = PatternMatrix(45, 53, 2);
+  S21Matrix c = PatternMatrix(67, 45, 3);
+  S21BasicMatrix<T> A = CastMatrix<T>(a);
+  S21BasicMatrix<T> B = CastMatrix<T>(b);
+  S21BasicMatrix<T> C = CastMatrix<T>(c);
+  S21Matrix chain = a + c * 2.0 - a / 4.0;
+  S21Matrix product = NaiveProduct(a, b);
+
+  for (S21SimdLevel level : {S21SimdLevel::kScalar, S21SimdLevel::kSse2,
+                             S21SimdLevel::kAvx2, S21SimdLevel::kAvx512}) {
+    S21SetSimdLevel(level);
+    S21BasicMatrix<T> sum(A);
+    sum += C * 2;
+    sum -= A / 4;
+    ExpectNearMatrix(sum, chain, tolerance);
+    ExpectNearMatrix(S21BasicMatrix<T>(A + C * 2 - A / 4), chain, tolerance);
+    ExpectNearMatrix(A * B, product, tolerance * 100);
+    ExpectNearMatrix(A.Transpose(), a.Transpose(), 0.0);
+    EXPECT_TRUE(A == S21BasicMatrix<T>(A * 1));
+  }
+  S21SetSimdLevel(initial);
+
+  S21Matrix square = PatternMatrix(12, 12, 4);
+  for (int i = 0; i < 12; i++) square(i, i) += 12;
+  S21BasicMatrix<T> inverse = CastMatrix<T>(square).InverseMatrix();
+  ExpectNearMatrix(inverse, square.InverseMatrix(), tolerance);
+  EXPECT_NEAR((double)CastMatrix<T>(square).Determinant(),
+              square.Determinant(), tolerance * square.Determinant());
+}
+
+TEST(S21MatrixTypeTest, Float_MatchesDouble) {
+  ExpectOperationsMatchDouble<float>(1e-4);
+}
+
+TEST(S21MatrixTypeTest, LongDouble_MatchesDouble) {
+  ExpectOperationsMatchDouble<long double>(1e-9);
+}
+
+TEST(S21MatrixTypeTest, Tolerance_DependsOnElementType) {
+  S21MatrixF F(2, 2);
+  S21MatrixF F_near(F);
+  F_near(1, 1) = 5e-5f;
+  EXPECT_TRUE(F == F_near);
+  F_near(1, 1) = 2e-4f;
+  EXPECT_FALSE(F == F_near);
+  EXPECT_FALSE(F == S21MatrixF(F_near + F));
+
+  S21MatrixLD L(2, 2);
+  S21MatrixLD L_near(L);
+  L_near(0, 1) = 1e-8L;
+  EXPECT_FALSE(L.EqMatrix(L_near));
+  S21Matrix D(2, 2);
+  S21Matrix D_near(D);
+  D_near(0, 1) = 1e-8;
+  EXPECT_TRUE(D.EqMatrix(D_near));
+
+  S21MatrixF singular(2, 2);
+  singular(0, 0) = 1e-3f;
+  singular(1, 1) = 1e-3f;
+  EXPECT_THROW(singular.InverseMatrix(), std::invalid_argument);
+}
+
+constexpr S21FixedMatrix<2, 2> kRotate(0, -1, 1, 0);
+static_assert(kRotate * kRotate * kRotate * kRotate ==
+              S21FixedMatrix<2, 2>::Identity());
+static_assert(S21Matrix3(2, 0, 0, 0, 3, 0, 1, 0, 4).Determinant() == 24);
+static_assert(S21FixedMatrix<2, 2>(4, 7, 2, 6).InverseMatrix() ==
+              S21FixedMatrix<2, 2>(0.6, -0.7, -0.2, 0.4));
+static_assert(S21FixedMatrix<2, 3>(1, 2, 3, 4, 5, 6).Transpose()(2, 1) == 6);
+
+template <typename Lhs, typename Rhs, typename = void>
+struct CanMultiply : std::false_type {};
+
+template <typename Lhs, typename Rhs>
+struct CanMultiply<Lhs, Rhs,
+                   std::void_t<decltype(std::declval<Lhs>() *
+                                        std::declval<Rhs>())>>
+    : std::true_type {};
+
+template <typename Lhs, typename Rhs, typename = void>
+struct CanAdd : std::false_type {};
+
+template <typename Lhs, typename Rhs>
+struct CanAdd<Lhs, Rhs,
+              std::void_t<decltype(std::declval<Lhs>() + std::declval<Rhs>())>>
+    : std::true_type {};
+
+static_assert(CanMultiply<S21FixedMatrix<2, 3>, S21FixedMatrix<3, 4>>::value);
+static_assert(!CanMultiply<S21FixedMatrix<2, 3>, S21FixedMatrix<2, 3>>::value);
+static_assert(CanAdd<S21FixedMatrix<2, 3>, S21FixedMatrix<2, 3>>::value);
+static_assert(!CanAdd<S21FixedMatrix<2, 3>, S21FixedMatrix<3, 2>>::value);
+
+// Compares every operation of an N x N fixed matrix with S21Matrix.
+template <int N>
+static void ExpectFixedMatchesDynamic() {
+  SCOPED_TRACE(N);
+  S21Matrix a = PatternMatrix(N, N, N);
+  S21Matrix b = PatternMatrix(N, N, N + 1);
+  for (int i = 0; i < N; i++) a(i, i) += 10;
+  S21FixedMatrix<N, N> A(a);
+  S21FixedMatrix<N, N> B(b);
+
+  EXPECT_TRUE((A + B).ToMatrix() == a + b);
+  EXPECT_TRUE((A - B * 2.0).ToMatrix() == a - b * 2.0);
+  EXPECT_TRUE((A * B).ToMatrix() == a * b);
+  EXPECT_TRUE(A.Transpose().ToMatrix() == a.Transpose());
+  EXPECT_NEAR(A.Determinant(), a.Determinant(),
+              EPS * std::abs(a.Determinant()));
+  EXPECT_TRUE(A.InverseMatrix().ToMatrix() == a.InverseMatrix());
+  EXPECT_TRUE(A.CalcComplements().ToMatrix() == a.CalcComplements());
+  A *= B;
+  EXPECT_TRUE(A.ToMatrix() == a * b);
+}
+
+TEST(S21FixedMatrixTest, Operations_MatchDynamic) {
+  ExpectFixedMatchesDynamic<1>();
+  ExpectFixedMatchesDynamic<2>();
+  ExpectFixedMatchesDynamic<3>();
+  ExpectFixedMatchesDynamic<4>();
+  ExpectFixedMatchesDynamic<5>();
+  ExpectFixedMatchesDynamic<7>();
+}
+
+TEST(S21FixedMatrixTest, Rectangular_ProductAndConversions) {
+  S21Matrix a = PatternMatrix(2, 3, 1);
+  S21Matrix b = PatternMatrix(3, 4, 2);
+  S21FixedMatrix<2, 4> product = S21FixedMatrix<2, 3>(a) *
+                                 S21FixedMatrix<3, 4>(b);
+  EXPECT_TRUE(product.ToMatrix() == a * b);
+  EXPECT_EQ(product.getRows(), 2);
+  EXPECT_EQ(product.getCols(), 4);
+  EXPECT_THROW((S21FixedMatrix<3, 2>(a)), std::invalid_argument);
+  EXPECT_THROW(product(2, 0), std::invalid_argument);
+
+  // Same tolerance boundary and NaN handling as S21Matrix::EqMatrix.
+  S21Matrix zero(2, 2), edge(2, 2), nan(2, 2);
+  edge(0, 0) = S21MatrixTraits<double>::kEpsilon;
+  nan(1, 1) = std::numeric_limits<double>::quiet_NaN();
+  using S21Matrix2 = S21FixedMatrix<2, 2>;
+  EXPECT_EQ(S21Matrix2() == S21Matrix2(edge), zero == edge);
+  EXPECT_EQ(S21Matrix2() == S21Matrix2(nan), zero == nan);
+}
+
+TEST(S21FixedMatrixTest, SingularAndFirstOrder) {
+  S21Matrix4 singular(1, 2, 3, 4, 2, 4, 6, 8, 0, 1, 0, 1, 1, 0, 1, 0);
+  EXPECT_DOUBLE_EQ(singular.Determinant(), 0.0);
+  EXPECT_THROW(singular.InverseMatrix(), std::invalid_argument);
+  EXPECT_THROW(S21Matrix3().InverseMatrix(), std::invalid_argument);
+  EXPECT_TRUE(singular.CalcComplements().ToMatrix() ==
+              singular.ToMatrix().CalcComplements());
+
+  using S21Matrix1 = S21FixedMatrix<1, 1>;
+  EXPECT_THROW(S21Matrix1().CalcComplements(), std::logic_error);
+  EXPECT_EQ(S21Matrix1(5).CalcComplements()(0, 0), 1.0);
+  EXPECT_EQ(S21Matrix1(4).InverseMatrix()(0, 0), 0.25);
+}
+
+// Cofactors straight from the definition, for small sizes only.
+static S21Matrix CofactorsByDefinition(const S21Matrix& A) {
+  int n = A.getRows();
+  S21Matrix result(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      S21Matrix minor(n - 1, n - 1);
+      for (int r = 0, mr = 0; r < n; r++) {
+        if (r == i) continue;
+        for (int c = 0, mc = 0; c < n; c++)
+          if (c != j) minor(mr, mc++) = A(r, c);
+        mr++;
+      }
+      result(i, j) = ((i + j) % 2 ? -1 : 1) * minor.Determinant();
+    }
+  }
+  return result;
+}
+
+TEST(S21MatrixQRTest, ReconstructsPermutedMatrix) {
+  S21Matrix A = PatternMatrix(7, 5, 3);
+  S21MatrixQR qr = A.QR();
+  S21Matrix R(7, 5);
+  for (int i = 0; i < 5; i++)
+    for (int j = i; j < 5; j++) R(i, j) = qr.getQR()(i, j);
+  S21Matrix QR = qr.MultiplyQ(R);
+  for (int i = 0; i < 7; i++)
+    for (int j = 0; j < 5; j++)
+      EXPECT_NEAR(QR(i, j), A(i, qr.getPermutation()[j]), 1e-9);
+  for (int k = 0; k + 1 < 5; k++)
+    EXPECT_GE(std::abs(qr.getQR()(k, k)), std::abs(qr.getQR()(k + 1, k + 1)));
+
+  S21Matrix b = PatternMatrix(7, 3, 5);
+  EXPECT_TRUE(qr.MultiplyQTransposed(qr.MultiplyQ(b)) == b);
+  EXPECT_THROW(qr.MultiplyQ(S21Matrix(5, 1)), std::invalid_argument);
+}
+
+TEST(S21MatrixQRTest, RevealsRank) {
+  S21Matrix A(6, 6);
+  for (int i = 0; i < 6; i++)
+    for (int j = 0; j < 6; j++) A(i, j) = (i + 1) * (j + 2) + (i % 2) * j;
+  EXPECT_EQ(A.QR().getRank(), 2);
+  EXPECT_EQ(S21Matrix(4, 4).QR().getRank(), 0);
+  S21Matrix identity(5, 5);
+  for (int i = 0; i < 5; i++) identity(i, i) = 1;
+  EXPECT_EQ(identity.QR().getRank(), 5);
+  EXPECT_EQ(S21Matrix(3, 2).QR().getSign(), 1);
+}
+
+TEST(S21MatrixTest, CalcComplements_LargeMatchesAdjugate) {
+  S21Matrix A = PatternMatrix(200, 200, 7);
+  for (int i = 0; i < 200; i++) A(i, i) += 200;
+  A.MulNumber(0.01);  // Keeps det(A) near 2^200, well inside double range.
+  S21Matrix complements = A.CalcComplements();
+  S21Matrix expected = A.InverseMatrix().Transpose();
+  double determinant = A.Determinant();
+  for (int i = 0; i < 200; i += 17)
+    for (int j = 0; j < 200; j += 13)
+      EXPECT_NEAR(complements(i, j) / determinant, expected(i, j), 1e-12);
+}
+
+TEST(S21MatrixTest, CalcComplements_SingularMatchesDefinition) {
+  // Rank 4: the last row is a combination of the others.
+  S21Matrix A = PatternMatrix(5, 5, 2);
+  for (int i = 0; i < 4; i++) A(i, i) += 5;
+  for (int j = 0; j < 5; j++) A(4, j) = 2 * A(0, j) - A(3, j);
+  S21Matrix expected = CofactorsByDefinition(A);
+  S21Matrix complements = A.CalcComplements();
+  for (int i = 0; i < 5; i++)
+    for (int j = 0; j < 5; j++)
+      EXPECT_NEAR(complements(i, j), expected(i, j), 1e-6);
+
+  S21Matrix rank_two(4, 4);
+  for (int i = 0; i < 4; i++)
+    for (int j = 0; j < 4; j++) rank_two(i, j) = i + j;
+  EXPECT_TRUE(rank_two.CalcComplements() == S21Matrix(4, 4));
+  EXPECT_TRUE(CofactorsByDefinition(rank_two) == S21Matrix(4, 4));
+}
+
+TEST(S21MatrixTest, CalcComplements_FloatSingular) {
+  S21MatrixF A(3, 3);
+  float values[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  for (int i = 0; i < 9; i++) A(i / 3, i % 3) = values[i];
+  S21MatrixF complements = A.CalcComplements();
+  float expected[] = {-3, 6, -3, 6, -12, 6, -3, 6, -3};
+  for (int i = 0; i < 9; i++)
+    EXPECT_NEAR(complements(i / 3, i % 3), expected[i], 1e-4);
+}
+
+TEST(S21MatrixTest, CalcComplements_BadlyScaledFullRank) {
+  // Pivot ratios below sqrt(epsilon) without any rank deficiency.
+  S21Matrix A(2, 2);
+  A(0, 0) = 1e9;
+  A(1, 1) = 1;
+  S21Matrix complements = A.CalcComplements();
+  EXPECT_DOUBLE_EQ(complements(0, 0), 1);
+  EXPECT_DOUBLE_EQ(complements(1, 1), 1e9);
+  EXPECT_EQ(complements(0, 1), 0);
+
+  S21MatrixF F(2, 2);
+  F(0, 0) = 1e6f;
+  F(1, 1) = 1;
+  S21MatrixF float_complements = F.CalcComplements();
+  EXPECT_FLOAT_EQ(float_complements(0, 0), 1);
+  EXPECT_FLOAT_EQ(float_complements(1, 1), 1e6f);
+
+  S21Matrix B(3, 3);
+  B(0, 0) = 1e5;
+  B(1, 1) = 1e5;
+  B(2, 2) = 1e-5;
+  B(0, 1) = 1;
+  S21Matrix expected = CofactorsByDefinition(B);
+  complements = B.CalcComplements();
+  EXPECT_NEAR(complements(0, 0), 1, 1e-12);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++)
+      EXPECT_NEAR(complements(i, j), expected(i, j),
+                  1e-12 * std::abs(expected(i, j)) + 1e-12);
+}
+
+// count matrices of rows x cols, each a shifted pattern with a heavy
+// diagonal so that every square one is invertible.
+static S21MatrixBatch PatternBatch(int count, int rows, int cols, int seed) {
+  S21MatrixBatch batch(count, rows, cols);
+  for (int k = 0; k < count; k++) {
+    S21Matrix matrix = PatternMatrix(rows, cols, seed + k);
+    for (int i = 0; i < std::min(rows, cols); i++) matrix(i, i) += 4 + k % 7;
+    batch.Set(k, matrix);
+  }
+  return batch;
+}
+
+TEST(S21MatrixBatchTest, Operations_MatchPerMatrix) {
+  const int count = 1001;
+  S21MatrixBatch A = PatternBatch(count, 4, 4, 1);
+  S21MatrixBatch B = PatternBatch(count, 4, 3, 2);
+  S21MatrixBatch product = A;
+  product.MulMatrix(B);
+  S21MatrixBatch inverse = A.InverseMatrix();
+  S21MatrixBatch transposed = B.Transpose();
+  std::vector<double> determinants = A.Determinant();
+  ASSERT_EQ(product.getRows(), 4);
+  ASSERT_EQ(product.getCols(), 3);
+  ASSERT_EQ(transposed.getRows(), 3);
+  ASSERT_EQ((int)determinants.size(), count);
+  for (int k = 0; k < count; k += 37) {
+    S21Matrix a = A.Get(k);
+    EXPECT_TRUE(product.Get(k) == a * B.Get(k));
+    EXPECT_TRUE(inverse.Get(k) == a.InverseMatrix());
+    EXPECT_TRUE(transposed.Get(k) == B.Get(k).Transpose());
+    EXPECT_NEAR(determinants[k], a.Determinant(),
+                1e-9 * std::abs(a.Determinant()));
+  }
+}
+
+TEST(S21MatrixBatchTest, PivotsPerMatrix) {
+  // Zero leading entries force a different row exchange in each matrix.
+  S21MatrixBatch A(3, 3, 3);
+  double values[3][9] = {{0, 1, 2, 1, 0, 3, 4, -3, 8},
+                         {0, 0, 1, 0, 1, 0, 1, 0, 0},
+                         {2, 1, 1, 4, 3, 3, 8, 7, 9}};
+  for (int k = 0; k < 3; k++)
+    for (int e = 0; e < 9; e++) A(k, e / 3, e % 3) = values[k][e];
+  std::vector<double> determinants = A.Determinant();
+  S21MatrixBatch inverse = A.InverseMatrix();
+  for (int k = 0; k < 3; k++) {
+    EXPECT_NEAR(determinants[k], A.Get(k).Determinant(), 1e-12);
+    EXPECT_TRUE(inverse.Get(k) == A.Get(k).InverseMatrix());
+  }
+}
+
+TEST(S21MatrixBatchTest, SingularAndInvalid) {
+  S21MatrixBatch A = PatternBatch(100, 3, 3, 5);
+  S21Matrix singular(3, 3);
+  singular(0, 0) = 1;
+  singular(1, 1) = 2;
+  A.Set(70, singular);
+  EXPECT_EQ(A.Determinant()[70], 0.0);
+  EXPECT_THROW(A.InverseMatrix(), std::invalid_argument);
+
+  // Nearly singular: rejected like S21Matrix::InverseMatrix does.
+  S21MatrixBatch C = PatternBatch(100, 2, 2, 5);
+  S21Matrix near_singular(2, 2);
+  near_singular(0, 0) = 1;
+  near_singular(0, 1) = 2;
+  near_singular(1, 0) = 2;
+  near_singular(1, 1) = 4 + 1e-10;
+  EXPECT_THROW(near_singular.InverseMatrix(), std::invalid_argument);
+  C.Set(41, near_singular);
+  EXPECT_THROW(C.InverseMatrix(), std::invalid_argument);
+
+  S21MatrixBatch B(99, 3, 3);
+  EXPECT_THROW(A.MulMatrix(B), std::invalid_argument);
+  EXPECT_THROW(A.MulMatrix(S21MatrixBatch(100, 2, 3)), std::invalid_argument);
+  EXPECT_THROW(S21MatrixBatch(4, 2, 3).Determinant(), std::invalid_argument);
+  EXPECT_THROW(A(100, 0, 0), std::invalid_argument);
+  EXPECT_THROW(A(0, 3, 0), std::invalid_argument);
+  EXPECT_THROW(A.Set(0, S21Matrix(2, 2)), std::invalid_argument);
+  EXPECT_THROW(S21MatrixBatch(0, 2, 2), std::invalid_argument);
+  EXPECT_THROW(S21MatrixBatch(4, -1, -1), std::invalid_argument);
+  EXPECT_TRUE(A.EqMatrix(A));
+  EXPECT_FALSE(A.EqMatrix(B));
+}
+
+TEST(S21MatrixBatchTest, Float_MatchesDouble) {
+  S21MatrixBatch A = PatternBatch(300, 5, 5, 3);
+  S21MatrixBatchF F(300, 5, 5);
+  for (int k = 0; k < 300; k++)
+    for (int i = 0; i < 5; i++)
+      for (int j = 0; j < 5; j++) F(k, i, j) = (float)A(k, i, j);
+  S21MatrixBatch inverse = A.InverseMatrix();
+  S21MatrixBatchF inverse_f = F.InverseMatrix();
+  for (int k = 0; k < 300; k += 11)
+    for (int i = 0; i < 5; i++)
+      for (int j = 0; j < 5; j++)
+        EXPECT_NEAR(inverse_f(k, i, j), inverse(k, i, j), 1e-5);
+}
+
+// About one element in ten nonzero, at pattern-dependent positions.
+static S21Matrix SparsePattern(int rows, int cols, int seed) {
+  S21Matrix result(rows, cols);
+  for (int i = 0; i < rows; i++)
+    for (int j = 0; j < cols; j++)
+      if ((i * 7 + j * 13 + seed) % 10 == 0)
+        result(i, j) = ((i + 2 * j + seed) % 9) - 4.0;
+  return result;
+}
+
+TEST(S21SparseMatrixTest, Conversions_RoundTrip) {
+  S21Matrix dense = SparsePattern(30, 17, 1);
+  S21SparseMatrix csr(dense);
+  S21SparseMatrix csc(dense, S21SparseFormat::kCsc);
+  EXPECT_TRUE(csr.ToDense() == dense);
+  EXPECT_TRUE(csc.ToDense() == dense);
+  EXPECT_EQ(csr.getNonZeros(), csc.getNonZeros());
+  EXPECT_EQ(csc.ToCsr().getIndices(), csr.getIndices());
+  EXPECT_EQ(csr.ToCsc().getOffsets(), csc.getOffsets());
+  EXPECT_EQ((int)csr.getOffsets().size(), 31);
+  EXPECT_TRUE(csr.EqMatrix(csc));
+  for (int i = 0; i < 30; i++)
+    for (int j = 0; j < 17; j++) EXPECT_EQ(csc(i, j), dense(i, j));
+  EXPECT_TRUE(csr.Transpose().ToDense() == dense.Transpose());
+  EXPECT_TRUE(csc.Transpose().ToDense() == dense.Transpose());
+  EXPECT_EQ(csc.Transpose().getFormat(), S21SparseFormat::kCsc);
+}
+
+TEST(S21SparseMatrixTest, Triplets_SumDuplicatesAndValidate) {
+  std::vector<S21Triplet<double>> triplets = {
+      {2, 1, 1.5}, {0, 3, 2.0}, {2, 1, 2.5}, {1, 0, 1.0}, {1, 0, -1.0}};
+  S21SparseMatrix A(3, 4, triplets);
+  EXPECT_EQ(A.getNonZeros(), 2);
+  EXPECT_EQ(A(2, 1), 4.0);
+  EXPECT_EQ(A(0, 3), 2.0);
+  EXPECT_EQ(A(1, 0), 0.0);
+  S21SparseMatrix B(3, 4, triplets, S21SparseFormat::kCsc);
+  EXPECT_TRUE(A.EqMatrix(B));
+  EXPECT_THROW(S21SparseMatrix(3, 4, {{3, 0, 1.0}}), std::invalid_argument);
+  EXPECT_THROW(S21SparseMatrix(0, 4), std::invalid_argument);
+  EXPECT_THROW(A(0, 4), std::invalid_argument);
+}
+
+TEST(S21SparseMatrixTest, Arithmetic_MatchesDense) {
+  S21Matrix a = SparsePattern(40, 25, 2);
+  S21Matrix b = SparsePattern(25, 33, 3);
+  S21Matrix c = SparsePattern(40, 25, 4);
+  for (S21SparseFormat lhs : {S21SparseFormat::kCsr, S21SparseFormat::kCsc}) {
+    for (S21SparseFormat rhs :
+         {S21SparseFormat::kCsr, S21SparseFormat::kCsc}) {
+      S21SparseMatrix product(a, lhs);
+      product.MulMatrix(S21SparseMatrix(b, rhs));
+      EXPECT_EQ(product.getFormat(), lhs);
+      EXPECT_TRUE(product.ToDense() == a * b);
+
+      S21SparseMatrix sum(a, lhs);
+      sum.SumMatrix(S21SparseMatrix(c, rhs));
+      EXPECT_TRUE(sum.ToDense() == a + c);
+      sum.SubMatrix(S21SparseMatrix(c, rhs));
+      sum.SubMatrix(S21SparseMatrix(a, rhs));
+      EXPECT_EQ(sum.getNonZeros(), 0);
+    }
+    S21SparseMatrix sparse(a, lhs);
+    EXPECT_TRUE(sparse.MulMatrix(b) == a * b);
+    sparse.MulNumber(2);
+    EXPECT_TRUE(sparse.ToDense() == a * 2.0);
+  }
+  EXPECT_THROW(S21SparseMatrix(a).MulMatrix(S21SparseMatrix(a)),
+               std::invalid_argument);
+  EXPECT_THROW(S21SparseMatrix(a).SumMatrix(S21SparseMatrix(b)),
+               std::invalid_argument);
+}
+
+TEST(S21SparseMatrixTest, MulVector_LargeParallel) {
+  const int n = 20000;
+  std::vector<S21Triplet<double>> triplets;
+  for (int i = 0; i < n; i++) {
+    triplets.push_back({i, i, 4.0});
+    if (i > 0) triplets.push_back({i, i - 1, -1.0});
+    if (i + 7 < n) triplets.push_back({i, i + 7, 0.5});
+  }
+  S21SparseMatrix csr(n, n, triplets);
+  S21SparseMatrix csc(n, n, triplets, S21SparseFormat::kCsc);
+  std::vector<double> x(n);
+  for (int i = 0; i < n; i++) x[i] = i % 5;
+  std::vector<double> y = csr.MulVector(x);
+  std::vector<double> z = csc.MulVector(x);
+  for (int i = 0; i < n; i += 97) {
+    double expected = 4.0 * x[i] + (i > 0 ? -x[i - 1] : 0) +
+                      (i + 7 < n ? 0.5 * x[i + 7] : 0);
+    EXPECT_DOUBLE_EQ(y[i], expected);
+    EXPECT_DOUBLE_EQ(z[i], expected);
+  }
+  S21SparseMatrix square = csr;
+  square.MulMatrix(csr);
+  // Diagonals 0, -1, -2, +6, +7 and +14.
+  EXPECT_EQ(square.getNonZeros(), 6 * n - (1 + 2 + 6 + 7 + 14));
+  EXPECT_THROW(csr.MulVector(std::vector<double>(3)), std::invalid_argument);
+}
+
+// B^T * B + n * I: symmetric positive definite.
+static S21Matrix SpdMatrix(int n, int seed) {
+  S21Matrix B = PatternMatrix(n, n, seed);
+  S21Matrix A = B.Transpose() * B;
+  for (int i = 0; i < n; i++) A(i, i) += n;
+  return A;
+}
+
+TEST(S21MatrixSolverTest, Cholesky_FactorsAndSolves) {
+  S21Matrix A = SpdMatrix(60, 1);
+  S21MatrixCholesky cholesky = A.Cholesky();
+  const S21Matrix& L = cholesky.getL();
+  EXPECT_EQ(L(0, 1), 0.0);
+  S21Matrix product = L * L.Transpose();
+  for (int i = 0; i < 60; i += 7)
+    for (int j = 0; j < 60; j += 5)
+      EXPECT_NEAR(product(i, j), A(i, j), 1e-9 * A(i, i));
+  EXPECT_NEAR(cholesky.Determinant() / A.Determinant(), 1.0, 1e-9);
+
+  S21Matrix b = PatternMatrix(60, 3, 2);
+  S21Matrix x = cholesky.Solve(b);
+  EXPECT_TRUE(A * x == b);
+  EXPECT_THROW(cholesky.Solve(S21Matrix(59, 1)), std::invalid_argument);
+
+  S21Matrix indefinite(2, 2);
+  indefinite(0, 0) = 1;
+  indefinite(0, 1) = indefinite(1, 0) = 2;
+  indefinite(1, 1) = 1;
+  EXPECT_THROW(indefinite.Cholesky(), std::invalid_argument);
+  EXPECT_THROW(S21Matrix(2, 3).Cholesky(), std::invalid_argument);
+}
+
+TEST(S21MatrixSolverTest, QR_LeastSquares) {
+  // Overdetermined: the residual must be orthogonal to the columns of A.
+  S21Matrix A = PatternMatrix(40, 6, 3);
+  S21Matrix b = PatternMatrix(40, 2, 4);
+  S21Matrix x = A.QR().Solve(b);
+  ASSERT_EQ(x.getRows(), 6);
+  S21Matrix normal = A.Transpose() * (A * x - b);
+  for (int i = 0; i < 6; i++)
+    for (int j = 0; j < 2; j++) EXPECT_NEAR(normal(i, j), 0.0, 1e-8);
+
+  // Rank deficient but consistent: some exact solution is found.
+  S21Matrix R(5, 5);
+  for (int i = 0; i < 5; i++)
+    for (int j = 0; j < 5; j++) R(i, j) = (i + 1) * (j + 1) + (i == j);
+  for (int j = 0; j < 5; j++) R(4, j) = R(0, j) + R(1, j);
+  S21Matrix y = PatternMatrix(5, 1, 1);
+  S21Matrix rhs = R * y;
+  EXPECT_TRUE(R * R.QR().Solve(rhs) == rhs);
+}
+
+TEST(S21MatrixSolverTest, Solver_PicksBackEndAndReusesIt) {
+  S21Matrix spd = SpdMatrix(30, 5);
+  S21Matrix general = PatternMatrix(30, 30, 6);
+  for (int i = 0; i < 30; i++) general(i, i) += 30;
+  S21Matrix tall = PatternMatrix(30, 8, 7);
+  S21Matrix singular(3, 3);
+  singular(0, 0) = 1;
+  singular(1, 1) = 1;
+
+  EXPECT_EQ(S21Solver(spd).getMethod(), S21SolverMethod::kCholesky);
+  EXPECT_EQ(S21Solver(general).getMethod(), S21SolverMethod::kLU);
+  EXPECT_EQ(S21Solver(tall).getMethod(), S21SolverMethod::kQR);
+  EXPECT_EQ(S21Solver(singular).getMethod(), S21SolverMethod::kQR);
+  EXPECT_EQ(S21Solver(-spd).getMethod(), S21SolverMethod::kLU);
+
+  S21Solver solver(general);
+  for (int seed = 0; seed < 4; seed++) {
+    S21Matrix b = PatternMatrix(30, seed + 1, seed);
+    EXPECT_TRUE(general * solver.Solve(b) == b);
+  }
+  for (S21SolverMethod method :
+       {S21SolverMethod::kLU, S21SolverMethod::kCholesky,
+        S21SolverMethod::kQR}) {
+    S21Matrix b = PatternMatrix(30, 2, 9);
+    EXPECT_TRUE(spd * S21Solve(spd, b, method) == b);
+  }
+  std::vector<double> rhs(30, 1.0);
+  std::vector<double> x = S21Solver(spd).Solve(rhs);
+  S21Matrix column(30, 1);
+  for (int i = 0; i < 30; i++) column(i, 0) = x[i];
+  S21Matrix ones = spd * column;
+  for (int i = 0; i < 30; i++) EXPECT_NEAR(ones(i, 0), 1.0, 1e-9);
+
+  EXPECT_THROW(S21Solver(singular, S21SolverMethod::kLU),
+               std::invalid_argument);
+  EXPECT_THROW(S21Solver(-spd, S21SolverMethod::kCholesky),
+               std::invalid_argument);
+  EXPECT_THROW(solver.Solve(S21Matrix(29, 1)), std::invalid_argument);
+  EXPECT_THROW(solver.Solve(std::vector<double>(29)), std::invalid_argument);
+}
+
+// Overwrites count bytes at offset of a file.
+static void PatchFile(const char* path, long offset, const void* bytes,
+                      std::size_t count) {
+  std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(offset);
+  file.write(static_cast<const char*>(bytes), count);
+}
+
+TEST(S21MatrixIOTest, SaveLoad_RoundTripsAndConverts) {
+  const char* path = "s21_test_matrix.bin";
+  S21Matrix A = PatternMatrix(37, 23, 1) * 0.1;
+  A.SaveBinary(path);
+  EXPECT_TRUE(S21Matrix::LoadBinary(path) == A);
+  S21BinaryHeader header = S21ReadBinaryHeader(path);
+  EXPECT_EQ(header.rows, 37u);
+  EXPECT_EQ(header.cols, 23u);
+  EXPECT_EQ(header.element_type, S21ElementType::kDouble);
+  EXPECT_EQ(header.payload_offset % S21Matrix::kAlignment, 0u);
+
+  S21MatrixF F = S21MatrixF::LoadBinary(path);
+  EXPECT_NEAR(F(5, 7), A(5, 7), 1e-6);
+  S21MatrixLD L = CastMatrix<long double>(A);
+  L.SaveBinary(path);
+  EXPECT_TRUE(S21Matrix::LoadBinary(path) == A);
+
+  // A column-major file of the same elements loads as the same matrix.
+  S21Matrix T = A.Transpose();
+  T.SaveBinary(path);
+  S21MatrixLayout layout = S21MatrixLayout::kColMajor;
+  std::uint64_t dims[2] = {37, 23};
+  PatchFile(path, 16, dims, sizeof(dims));
+  PatchFile(path, 40, &layout, sizeof(layout));
+  EXPECT_TRUE(S21Matrix::LoadBinary(path) == A);
+  std::remove(path);
+}
+
+TEST(S21MatrixIOTest, Map_SharesTheFileWithoutChangingIt) {
+  const char* path = "s21_test_mapped.bin";
+  S21Matrix A = PatternMatrix(64, 48, 2);
+  A.SaveBinary(path);
+  {
+    S21Matrix mapped = S21Matrix::MapBinary(path, true);
+    EXPECT_NE(mapped.getResource(), S21HeapResource());
+    EXPECT_EQ((std::uintptr_t)mapped.data() % S21Matrix::kAlignment, 0u);
+    EXPECT_TRUE(mapped == A);
+    EXPECT_TRUE(mapped * A.Transpose() == A * A.Transpose());
+    mapped(0, 0) = 1000;
+    S21Matrix copy = mapped;
+    EXPECT_EQ(copy(0, 0), 1000);
+    mapped.setRows(70);
+    EXPECT_EQ(mapped(1, 1), A(1, 1));
+  }
+  EXPECT_TRUE(S21Matrix::LoadBinary(path) == A);
+  EXPECT_THROW(S21MatrixF::MapBinary(path), std::runtime_error);
+  std::remove(path);
+}
+
+TEST(S21MatrixIOTest, RejectsDamagedFiles) {
+  const char* path = "s21_test_damaged.bin";
+  EXPECT_THROW(S21Matrix::LoadBinary("no_such_matrix.bin"),
+               std::runtime_error);
+  EXPECT_THROW(S21Matrix::MapBinary("no_such_matrix.bin"),
+               std::runtime_error);
+  S21Matrix A = PatternMatrix(10, 10, 3);
+  A.SaveBinary(path);
+  double changed = 12345;
+  PatchFile(path, 64 + 8 * 17, &changed, sizeof(changed));
+  EXPECT_THROW(S21Matrix::LoadBinary(path), std::runtime_error);
+  EXPECT_THROW(S21Matrix::MapBinary(path, true), std::runtime_error);
+  EXPECT_EQ(S21Matrix::MapBinary(path)(1, 7), 12345);
+
+  PatchFile(path, 0, "X", 1);
+  EXPECT_THROW(S21ReadBinaryHeader(path), std::runtime_error);
+  A.SaveBinary(path);
+  std::uint64_t rows = 11;
+  PatchFile(path, 16, &rows, sizeof(rows));
+  EXPECT_THROW(S21Matrix::LoadBinary(path), std::runtime_error);
+  EXPECT_THROW(S21Matrix::MapBinary(path), std::runtime_error);
+  std::remove(path);
+}
+
+TEST(S21MatrixIOTest, Checksum_IndependentOfPieces) {
+  std::vector<unsigned char> bytes(1000);
+  for (std::size_t i = 0; i < bytes.size(); i++) bytes[i] = i * 7 + 3;
+  S21Checksum whole;
+  whole.Update(bytes.data(), bytes.size());
+  S21Checksum pieces;
+  for (std::size_t p = 0; p < bytes.size(); p += 13)
+    pieces.Update(bytes.data() + p, std::min<std::size_t>(13, 1000 - p));
+  EXPECT_EQ(whole.Finish(), pieces.Finish());
+  bytes[500] ^= 1;
+  S21Checksum flipped;
+  flipped.Update(bytes.data(), bytes.size());
+  EXPECT_NE(whole.Finish(), flipped.Finish());
+}
+
+// Eight 16 x 16 tiles of cache, so the tests below evict and write back.
+constexpr int kTestTile = 16;
+constexpr std::size_t kTestCache = 8 * kTestTile * kTestTile * sizeof(double);
+
+TEST(S21TiledMatrixTest, StoresTilesOfAnyShape) {
+  S21Matrix A = PatternMatrix(37, 53, 1);
+  S21TiledMatrix tiled = S21TiledMatrix::FromMatrix(A, kTestTile, kTestCache);
+  EXPECT_EQ(tiled.getRows(), 37);
+  EXPECT_EQ(tiled.getCols(), 53);
+  EXPECT_TRUE(tiled.ToMatrix() == A);
+  EXPECT_EQ(tiled.Get(36, 52), A(36, 52));
+  tiled.Set(20, 30, 7);
+  EXPECT_EQ(tiled.Get(20, 30), 7);
+  S21Matrix block = tiled.ReadBlock(10, 12, 20, 30);
+  EXPECT_EQ(block(10, 18), 7);
+  EXPECT_EQ(block(0, 0), A(10, 12));
+  EXPECT_THROW(tiled.Get(37, 0), std::invalid_argument);
+  EXPECT_THROW(tiled.ReadBlock(30, 0, 8, 1), std::invalid_argument);
+
+  S21TileCacheStats stats = tiled.getCacheStats();
+  EXPECT_GT(stats.evictions, 0);
+  EXPECT_GT(stats.write_backs, 0);
+  S21TiledMatrix zero(5, 5, 2);
+  EXPECT_TRUE(zero.ToMatrix() == S21Matrix(5, 5));
+}
+
+TEST(S21TiledMatrixTest, OperationsMatchDense) {
+  S21Matrix A = PatternMatrix(45, 70, 1), B = PatternMatrix(70, 33, 2);
+  S21TiledMatrix a = S21TiledMatrix::FromMatrix(A, kTestTile, kTestCache);
+  S21TiledMatrix b = S21TiledMatrix::FromMatrix(B, kTestTile, kTestCache);
+  S21TiledMatrix t = a.Transpose();
+  EXPECT_TRUE(t.ToMatrix() == A.Transpose());
+
+  a.SumMatrix(S21TiledMatrix::FromMatrix(A, kTestTile, kTestCache));
+  EXPECT_TRUE(a.ToMatrix() == A * 2.0);
+  a.MulMatrix(b);
+  EXPECT_EQ(a.getCols(), 33);
+  EXPECT_TRUE(a.ToMatrix() == A * 2.0 * B);
+  EXPECT_GT(a.getCacheStats().misses, 0);
+
+  EXPECT_THROW(a.SumMatrix(b), std::invalid_argument);
+  EXPECT_THROW(t.MulMatrix(t), std::invalid_argument);
+  S21TiledMatrix other_tiles = S21TiledMatrix::FromMatrix(B, 8);
+  EXPECT_THROW(t.MulMatrix(other_tiles), std::invalid_argument);
+}
+
+TEST(S21TiledMatrixTest, LUMatchesDense) {
+  S21Matrix A = PatternMatrix(75, 75, 3);
+  for (int i = 0; i < 75; i++) A(i, (i * 7) % 75) += 5;
+  S21TiledMatrix tiled = S21TiledMatrix::FromMatrix(A, kTestTile, kTestCache);
+  S21TiledLU lu = tiled.LU();
+  S21MatrixLU dense(A);
+  EXPECT_FALSE(lu.IsSingular());
+  EXPECT_EQ(lu.getPivots(), dense.getPivots());
+  EXPECT_TRUE(lu.getLU().ToMatrix() == dense.getLU());
+  EXPECT_NEAR(lu.Determinant() / dense.Determinant(), 1, 1e-9);
+
+  S21Matrix b = PatternMatrix(75, 4, 4);
+  S21Matrix x = lu.Solve(b);
+  EXPECT_TRUE(A * x == b);
+  EXPECT_THROW(lu.Solve(S21Matrix(74, 1)), std::invalid_argument);
+
+  S21Matrix singular(20, 20);
+  S21TiledLU singular_lu =
+      S21TiledMatrix::FromMatrix(singular, kTestTile).LU();
+  EXPECT_TRUE(singular_lu.IsSingular());
+  EXPECT_EQ(singular_lu.Determinant(), 0);
+  EXPECT_THROW(S21TiledMatrix(3, 4).LU(), std::invalid_argument);
+}
+
+TEST(S21TiledMatrixTest, ConvertsBinaryFiles) {
+  const char* path = "s21_test_tiled.bin";
+  S21Matrix A = PatternMatrix(50, 41, 5);
+  A.SaveBinary(path);
+  S21TiledMatrix tiled = S21TiledMatrix::FromBinary(path, kTestTile);
+  EXPECT_TRUE(tiled.ToMatrix() == A);
+  tiled.Set(49, 40, -1);
+  tiled.SaveBinary(path);
+  S21Matrix loaded = S21Matrix::LoadBinary(path);
+  EXPECT_EQ(loaded(49, 40), -1);
+  EXPECT_EQ(loaded(0, 0), A(0, 0));
+  EXPECT_THROW(S21BasicTiledMatrix<float>::FromBinary(path),
+               std::runtime_error);
+  std::remove(path);
+}
+
+static void WriteFile(const char* path, const std::string& text) {
+  std::ofstream(path, std::ios::binary) << text;
+}
+
+TEST(S21MatrixTextTest, CsvRoundTripsExactly) {
+  const char* path = "s21_test_matrix.csv";
+  // Over a megabyte of text, so it is parsed in several chunks.
+  S21Matrix A = PatternMatrix(3000, 40, 1) * 0.1;
+  A(0, 0) = 1e-300;
+  A(1, 1) = -123456789.125;
+  A.ToCSV(path);
+  S21Matrix B = S21Matrix::FromCSV(path);
+  ASSERT_EQ(B.getRows(), 3000);
+  ASSERT_EQ(B.getCols(), 40);
+  bool identical = true;
+  for (int i = 0; i < 3000; i++)
+    for (int j = 0; j < 40; j++) identical &= A(i, j) == B(i, j);
+  EXPECT_TRUE(identical);
+
+  A.ToCSV(path, ';');
+  EXPECT_TRUE(S21Matrix::FromCSV(path, ';') == A);
+  EXPECT_THROW(S21Matrix::FromCSV(path), std::runtime_error);
+  S21MatrixF F = S21MatrixF::FromCSV(path, ';');
+  EXPECT_FLOAT_EQ(F(1, 1), -123456789.125f);
+
+  // Blank delimiters separate fields instead of being skipped as padding.
+  for (char delimiter : {'\t', ' '}) {
+    A.ToCSV(path, delimiter);
+    EXPECT_TRUE(S21Matrix::FromCSV(path, delimiter) == A);
+  }
+  std::remove(path);
+}
+
+TEST(S21MatrixTextTest, ParsesWhitespaceAndBlankLines) {
+  const char* path = "s21_test_matrix.txt";
+  WriteFile(path, "\n  1 2\t3\r\n\n+4   -5e1 inf \r\n\t\n7 8 9");
+  S21Matrix A = S21Matrix::FromText(path);
+  ASSERT_EQ(A.getRows(), 3);
+  ASSERT_EQ(A.getCols(), 3);
+  EXPECT_EQ(A(1, 0), 4);
+  EXPECT_EQ(A(1, 1), -50);
+  EXPECT_TRUE(std::isinf(A(1, 2)));
+  EXPECT_EQ(A(2, 2), 9);
+
+  S21Matrix B = PatternMatrix(5, 7, 2);
+  B.ToText(path);
+  EXPECT_TRUE(S21Matrix::FromText(path) == B);
+  WriteFile(path, " 1 , 2\n3,4 \n");
+  S21Matrix C = S21Matrix::FromCSV(path);
+  EXPECT_EQ(C.getCols(), 2);
+  EXPECT_EQ(C(0, 1), 2);
+  EXPECT_EQ(C(1, 0), 3);
+  std::remove(path);
+}
+
+TEST(S21MatrixTextTest, RejectsMalformedFiles) {
+  const char* path = "s21_test_bad.csv";
+  EXPECT_THROW(S21Matrix::FromCSV("no_such_matrix.csv"), std::runtime_error);
+  for (const char* text : {"", "\n \n", "1,2\n3\n", "1,2\n3,4,5\n",
+                           "1,x\n", "1,,2\n", "1,2,\n", "1 2\n"}) {
+    WriteFile(path, text);
+    EXPECT_THROW(S21Matrix::FromCSV(path), std::runtime_error) << text;
+  }
+  WriteFile(path, "1 2\n3 4x\n");
+  EXPECT_THROW(S21Matrix::FromText(path), std::runtime_error);
+  std::remove(path);
+}
+
+TEST(S21MatrixViewTest, BlocksReadAndWriteInPlace) {
+  S21Matrix A = PatternMatrix(6, 5, 1);
+  S21Matrix original = A;
+  S21MatrixView block = A.block(1, 2, 3, 2);
+  EXPECT_EQ(block.getRows(), 3);
+  EXPECT_EQ(block.getCols(), 2);
+  EXPECT_EQ(block(2, 1), A(3, 3));
+  EXPECT_EQ(&block(0, 0), &A(1, 2));
+
+  block = block * 2.0 + A.block(0, 0, 3, 2);
+  block(0, 0) = 100;
+  EXPECT_EQ(A(1, 2), 100);
+  EXPECT_EQ(A(3, 3), 2 * original(3, 3) + original(2, 1));
+  EXPECT_EQ(A(0, 2), original(0, 2));
+  EXPECT_EQ(A(4, 3), original(4, 3));
+  S21Matrix copy = A.block(1, 2, 3, 2);
+  EXPECT_EQ(copy.getRows(), 3);
+  EXPECT_EQ(copy(2, 1), A(3, 3));
+
+  EXPECT_THROW(A.block(4, 0, 3, 1), std::invalid_argument);
+  EXPECT_THROW(A.block(0, 0, 0, 1), std::invalid_argument);
+  EXPECT_THROW(block(3, 0), std::invalid_argument);
+  EXPECT_THROW(block = S21Matrix(2, 2), std::invalid_argument);
+  const S21Matrix& constant = A;
+  S21BasicMatrixView<const double> read_only = constant.block(0, 0, 2, 2);
+  EXPECT_EQ(read_only(1, 1), A(1, 1));
+}
+
+TEST(S21MatrixViewTest, MinorLeavesOutRowAndColumn) {
+  S21Matrix A = PatternMatrix(4, 4, 3);
+  for (int i = 0; i < 4; i++) A(i, i) += 10;
+  S21MatrixView minor = A.Minor(1, 2);
+  ASSERT_EQ(minor.getRows(), 3);
+  ASSERT_EQ(minor.getCols(), 3);
+  EXPECT_EQ(minor.getSkippedRow(), 1);
+  EXPECT_EQ(minor.getSkippedCol(), 2);
+  for (int i = 0; i < 3; i++)
+    for (int j = 0; j < 3; j++)
+      EXPECT_EQ(minor(i, j), A(i + (i >= 1), j + (j >= 2)));
+  // Cofactor expansion along row 0.
+  double det = 0;
+  for (int j = 0; j < 4; j++)
+    det += (j % 2 ? -1 : 1) * A(0, j) * S21Matrix(A.Minor(0, j)).Determinant();
+  EXPECT_NEAR(det, A.Determinant(), 1e-9 * std::fabs(det));
+  EXPECT_THROW(minor.Minor(0, 0), std::invalid_argument);
+  EXPECT_THROW(minor.block(0, 0, 1, 1), std::invalid_argument);
+  EXPECT_THROW(S21Matrix(1, 3).Minor(0, 0), std::invalid_argument);
+  S21Matrix expected = A.Minor(0, 3);
+  A = A.Minor(0, 3);
+  EXPECT_TRUE(A == expected);
+}
+
+TEST(S21MatrixViewTest, ProductsReadViewsInPlace) {
+  S21Matrix A = PatternMatrix(9, 8, 1);
+  S21Matrix B = PatternMatrix(8, 7, 2);
+  S21Matrix a = A.block(2, 1, 5, 6);
+  S21Matrix b = B.block(1, 0, 6, 4);
+  EXPECT_TRUE(A.block(2, 1, 5, 6) * B.block(1, 0, 6, 4) == a * b);
+  EXPECT_TRUE(A.block(2, 1, 5, 6) * b == a * b);
+  EXPECT_TRUE(a * B.block(1, 0, 6, 4) == a * b);
+  EXPECT_TRUE(A.view().Transpose() * A == A.Transpose() * A);
+
+  S21Matrix square = PatternMatrix(8, 8, 4);
+  for (int skip_a = 0; skip_a < 8; skip_a += 3) {
+    for (int skip_b = 0; skip_b < 8; skip_b += 2) {
+      S21Matrix ma = square.Minor(skip_a, 7 - skip_a);
+      S21Matrix mb = B.Minor(skip_b, skip_a);
+      EXPECT_TRUE(square.Minor(skip_a, 7 - skip_a) * B.Minor(skip_b, skip_a) ==
+                  ma * mb);
+      EXPECT_TRUE(square.Minor(skip_a, skip_b).Transpose() * ma ==
+                  S21Matrix(square.Minor(skip_a, skip_b)).Transpose() * ma);
+    }
+  }
+  EXPECT_THROW(A.block(0, 0, 2, 3) * B.block(0, 0, 2, 3),
+               std::invalid_argument);
+}
+
+TEST(S21MatrixViewTest, AssignmentsReadingTheTargetAgainAreEvaluatedFirst) {
+  // Large enough for the assignment to run on the thread pool.
+  S21Matrix original = PatternMatrix(300, 300, 5);
+  S21Matrix A = original;
+  A = A.view().Transpose();
+  EXPECT_TRUE(A == original.Transpose());
+  A = original;
+  A += A.view().Transpose();
+  EXPECT_TRUE(A == original + original.Transpose());
+  A = original;
+  A -= A.view().Transpose() * 2.0;
+  EXPECT_TRUE(A == original - original.Transpose() * 2.0);
+  A = original;
+  A = A.view().Transpose() * 1.0;
+  EXPECT_TRUE(A == original.Transpose());
+
+  S21Matrix B = PatternMatrix(6, 6, 2);
+  S21Matrix expected = B;
+  expected.block(0, 0, 4, 4) = S21Matrix(B.block(1, 1, 4, 4));
+  B.block(0, 0, 4, 4) = B.block(1, 1, 4, 4);
+  EXPECT_TRUE(B == expected);
+  expected.block(1, 1, 4, 4) += S21Matrix(expected.view().block(0, 0, 4, 4));
+  B.block(1, 1, 4, 4) += B.block(0, 0, 4, 4);
+  EXPECT_TRUE(B == expected);
+  B.view() = B.view() * 2.0 + B.view();
+  EXPECT_TRUE(B == expected * 3.0);
+}
+
+TEST(S21MatrixCapacityTest, GrowsGeometricallyAndShrinksInPlace) {
+  S21Matrix A(1, 3);
+  const double* buffer = A.data();
+  int reallocations = 0;
+  for (int i = 1; i < 1000; i++) {
+    A.AppendRow({(double)i, 2.0 * i, 3.0 * i});
+    if (A.data() != buffer) reallocations++;
+    buffer = A.data();
+  }
+  EXPECT_EQ(A.getRows(), 1000);
+  EXPECT_LE(reallocations, 10);
+  EXPECT_GE(A.getRowCapacity(), 1000);
+  EXPECT_EQ(A(999, 2), 2997);
+
+  A.setRows(10);
+  A.setCols(2);
+  EXPECT_EQ(A.data(), buffer);
+  EXPECT_EQ(A.getColCapacity(), 3);
+  // Regrowing within the capacity brings zeros back, not old elements.
+  A.setCols(3);
+  A.setRows(20);
+  EXPECT_EQ(A.data(), buffer);
+  EXPECT_EQ(A(5, 2), 0);
+  EXPECT_EQ(A(15, 0), 0);
+  EXPECT_EQ(A(5, 1), 10);
+
+  A.shrink_to_fit();
+  EXPECT_EQ(A.getRowCapacity(), 20);
+  EXPECT_EQ(A.getColCapacity(), 3);
+  EXPECT_EQ(A(5, 1), 10);
+  EXPECT_THROW(A.AppendRow({1, 2}), std::invalid_argument);
+  EXPECT_THROW(A.setRows(0), std::invalid_argument);
+  EXPECT_THROW(A.setCols(-1), std::invalid_argument);
+  EXPECT_THROW(A.reserve(0, 5), std::invalid_argument);
+}
+
+TEST(S21MatrixCapacityTest, PaddedRowsWorkEverywhere) {
+  S21Matrix dense = PatternMatrix(30, 20, 1);
+  S21Matrix A(30, 1);
+  A.reserve(64, 64);
+  EXPECT_EQ(A.getColCapacity(), 64);
+  EXPECT_EQ(A.getRowCapacity(), 64);
+  const double* buffer = A.data();
+  for (int j = 1; j < 20; j++) {
+    std::vector<double> column(30);
+    for (int i = 0; i < 30; i++) column[i] = dense(i, j);
+    A.AppendCol(column);
+  }
+  for (int i = 0; i < 30; i++) A(i, 0) = dense(i, 0);
+  EXPECT_EQ(A.data(), buffer);
+  EXPECT_EQ(A.stride(), 64);
+
+  EXPECT_TRUE(A == dense);
+  EXPECT_TRUE(A * A.Transpose() == dense * dense.Transpose());
+  EXPECT_TRUE(A + dense * 2.0 == dense * 3.0);
+  S21Matrix copy = A;
+  EXPECT_EQ(copy.stride(), 20);
+  EXPECT_TRUE(copy == dense);
+  S21Matrix square = A * A.Transpose();
+  square.setCols(31);
+  square.setCols(30);
+  S21Matrix expected = dense * dense.Transpose();
+  for (int i = 0; i < 30; i++) square(i, i) += 1000;
+  for (int i = 0; i < 30; i++) expected(i, i) += 1000;
+  EXPECT_NEAR(square.Determinant() / expected.Determinant(), 1, 1e-9);
+  A.TransposeInPlace();
+  EXPECT_TRUE(A == dense.Transpose());
+}
+
+TEST(S21MatrixBlasTest, GemmAccumulatesIntoMatricesAndViews) {
+  S21Matrix A = PatternMatrix(9, 7, 1);
+  S21Matrix B = PatternMatrix(7, 6, 2);
+  S21Matrix C = PatternMatrix(9, 6, 3);
+  S21Matrix expected = NaiveProduct(A, B) * 2.0 + C * 0.5;
+  S21Gemm(2.0, A, S21Op::kNoTrans, B, S21Op::kNoTrans, 0.5, C);
+  EXPECT_TRUE(C == expected);
+
+  S21Matrix At = A.Transpose();
+  S21Matrix Bt = B.Transpose();
+  for (S21Op op_a : {S21Op::kNoTrans, S21Op::kTrans}) {
+    for (S21Op op_b : {S21Op::kNoTrans, S21Op::kTrans}) {
+      S21Matrix product(9, 6);
+      product(0, 0) = std::numeric_limits<double>::quiet_NaN();
+      S21Gemm(1.0, op_a == S21Op::kTrans ? At : A, op_a,
+              op_b == S21Op::kTrans ? Bt : B, op_b, 0.0, product);
+      EXPECT_TRUE(product == NaiveProduct(A, B));
+    }
+  }
+
+  // Blocks, minors and a transposed result are written in place.
+  S21Matrix big = PatternMatrix(12, 12, 4);
+  S21Matrix untouched = big;
+  S21Gemm(1.0, A.Minor(3, 2), S21Op::kNoTrans, B.Minor(2, 5),
+          S21Op::kNoTrans, 0.0, big.block(1, 2, 8, 5));
+  EXPECT_TRUE(S21Matrix(big.block(1, 2, 8, 5)) ==
+              NaiveProduct(A.Minor(3, 2), B.Minor(2, 5)));
+  EXPECT_EQ(big(0, 2), untouched(0, 2));
+  EXPECT_EQ(big(1, 7), untouched(1, 7));
+  S21Matrix Ct(6, 9);
+  S21Gemm(1.0, A, S21Op::kNoTrans, B, S21Op::kNoTrans, 0.0,
+          Ct.view().Transpose());
+  EXPECT_TRUE(Ct == NaiveProduct(A, B).Transpose());
+
+  S21Matrix square = PatternMatrix(6, 6, 5);
+  EXPECT_THROW(S21Gemm(1.0, square, S21Op::kNoTrans, B, S21Op::kTrans, 0.0,
+                       square),
+               std::invalid_argument);
+  EXPECT_THROW(S21Gemm(1.0, A, S21Op::kTrans, B, S21Op::kNoTrans, 0.0, C),
+               std::invalid_argument);
+  EXPECT_THROW(S21Gemm(1.0, A, S21Op::kNoTrans, B, S21Op::kNoTrans, 0.0,
+                       big.block(0, 0, 9, 5)),
+               std::invalid_argument);
+}
+
+TEST(S21MatrixBlasTest, GemvAndGerOnRowsAndColumns) {
+  S21Matrix A = PatternMatrix(8, 5, 1);
+  S21Matrix x = PatternMatrix(5, 1, 2);
+  S21Matrix y = PatternMatrix(8, 1, 3);
+  S21Matrix expected = NaiveProduct(A, x) * 3.0 - y;
+  S21Gemv(3.0, A, S21Op::kNoTrans, x, -1.0, y);
+  EXPECT_TRUE(y == expected);
+
+  // A row of one matrix into a column of another, through A^T.
+  S21Matrix source = PatternMatrix(4, 8, 4);
+  S21Matrix target(5, 3);
+  S21Gemv(1.0, A, S21Op::kTrans, source.block(2, 0, 1, 8), 0.0,
+          target.block(0, 1, 5, 1));
+  S21Matrix row = source.block(2, 0, 1, 8);
+  EXPECT_TRUE(S21Matrix(target.block(0, 1, 5, 1)) ==
+              NaiveProduct(A.Transpose(), row.Transpose()));
+  EXPECT_EQ(target(0, 0), 0);
+  S21Matrix pair_x = PatternMatrix(5, 2, 6), pair_y(8, 2);
+  S21Gemv(1.0, A.Minor(2, 1), S21Op::kNoTrans, pair_x.Minor(1, 0), 0.0,
+          pair_y.Minor(6, 0));
+  EXPECT_TRUE(S21Matrix(pair_y.Minor(6, 0)) ==
+              NaiveProduct(A.Minor(2, 1), pair_x.Minor(1, 0)));
+
+  S21Matrix M = PatternMatrix(8, 5, 5);
+  expected = M + NaiveProduct(y, x.Transpose()) * 0.5;
+  S21Ger(0.5, y, x.Transpose(), M);
+  EXPECT_TRUE(M == expected);
+  S21Matrix Mt = PatternMatrix(8, 5, 5).Transpose();
+  S21Ger(0.5, x, y, Mt.view());
+  EXPECT_TRUE(Mt == expected.Transpose());
+
+  EXPECT_THROW(S21Gemv(1.0, A, S21Op::kNoTrans, y, 0.0, y),
+               std::invalid_argument);
+  EXPECT_THROW(S21Gemv(1.0, A, S21Op::kNoTrans, x, 0.0, A.block(0, 0, 8, 1)),
+               std::invalid_argument);
+  EXPECT_THROW(S21Ger(1.0, x, y, M), std::invalid_argument);
+}
+
+TEST(S21MatrixBlasTest, ConjugateGradientLoopDoesNotAllocate) {
+  const int n = 40;
+  S21Matrix A = SpdMatrix(n, 6);
+  S21Matrix b = PatternMatrix(n, 1, 7);
+  S21Matrix x(n, 1), r = b, p = b, Ap(n, 1), scalar(1, 1);
+  S21Matrix correction(n, n), product(n, n);
+  auto dot = [](const S21Matrix& u, const S21Matrix& v, S21Matrix& out) {
+    S21Gemm(1.0, u, S21Op::kTrans, v, S21Op::kNoTrans, 0.0, out);
+    return out(0, 0);
+  };
+  // The first product sizes the packing buffers of this thread.
+  S21Gemm(1.0, A, S21Op::kNoTrans, A, S21Op::kNoTrans, 0.0, product);
+
+  long before = aligned_allocations.load() + heap_allocations.load();
+  double rr = dot(r, r, scalar);
+  for (int iteration = 0; iteration < n && rr > 1e-24; iteration++) {
+    S21Gemv(1.0, A, S21Op::kNoTrans, p, 0.0, Ap);
+    double step = rr / dot(p, Ap, scalar);
+    for (int i = 0; i < n; i++) {
+      x(i, 0) += step * p(i, 0);
+      r(i, 0) -= step * Ap(i, 0);
+    }
+    double next = dot(r, r, scalar);
+    for (int i = 0; i < n; i++) p(i, 0) = r(i, 0) + next / rr * p(i, 0);
+    rr = next;
+    // Rank-1 updates and minor products take the same allocation-free paths.
+    S21Ger(1.0, p, Ap, correction);
+    S21Gemm(1.0, A.Minor(0, 1), S21Op::kNoTrans, correction.Minor(1, 0),
+            S21Op::kTrans, 0.0, product.block(0, 0, n - 1, n - 1));
+  }
+  EXPECT_EQ(aligned_allocations.load() + heap_allocations.load() - before, 0);
+  EXPECT_TRUE(A * x == b);
+}
+
+TEST(S21MatrixBlasTest, ParallelProductsDoNotAllocate) {
+  S21ThreadPool& pool = S21ThreadPool::Instance();
+  int threads = pool.getThreadCount();
+  pool.SetThreadCount(4);
+  // Above the volume GEMM splits over the pool at.
+  const int n = 200;
+  S21Matrix A = PatternMatrix(n, n, 1);
+  S21Matrix B = PatternMatrix(n, n, 2);
+  S21Matrix C(n, n), x = PatternMatrix(n, 1, 3), y(n, 1);
+  S21Matrix expected = A * B;
+  auto products = [&] {
+    for (int i = 0; i < 10; i++) {
+      S21Gemm(1.0, A, S21Op::kNoTrans, B, S21Op::kNoTrans, 0.0, C);
+      S21Gemm(1.0, A.view().Transpose(), S21Op::kTrans, B, S21Op::kNoTrans,
+              0.0, C);
+      S21Gemv(1.0, A, S21Op::kNoTrans, x, 0.0, y);
+      S21Ger(1.0, x, y, C);
+    }
+  };
+  // The first products size the packing buffers of every thread.
+  for (int i = 0; i < 5; i++) products();
+
+  long before = aligned_allocations.load() + heap_allocations.load();
+  products();
+  long allocations = aligned_allocations.load() + heap_allocations.load();
+  pool.SetThreadCount(threads);
+  EXPECT_EQ(allocations - before, 0);
+  S21Gemm(1.0, A, S21Op::kNoTrans, B, S21Op::kNoTrans, 0.0, C);
+  EXPECT_TRUE(C == expected);
+}
+
+TEST(S21MatrixStatsTest, ExportsSnapshotAsPrometheusText) {
+  S21ResetStats();
+  S21OpStats delta;
+  delta.calls = 2;
+  delta.nanoseconds = 1500000000;
+  delta.flops = 54;
+  S21RecordStats(S21StatOp::kMulMatrix, delta);
+  S21RecordStats(S21StatOp::kMulMatrix, delta);
+  S21MatrixStats stats = S21GetStats();
+  EXPECT_EQ(stats[S21StatOp::kMulMatrix].calls, 4u);
+  EXPECT_EQ(stats[S21StatOp::kMulMatrix].flops, 108u);
+  EXPECT_STREQ(S21StatOpName(S21StatOp::kCalcComplements),
+               "calc_complements");
+
+  std::string text = S21StatsPrometheus(stats);
+  EXPECT_NE(text.find("# TYPE s21_matrix_calls_total counter\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_calls_total{op=\"mul_matrix\"} 4\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_seconds_total{op=\"mul_matrix\"} "
+                      "3.000000000\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("s21_matrix_allocated_bytes_total{op=\"ger\"} 0\n"),
+            std::string::npos);
+  S21ResetStats();
+  EXPECT_EQ(S21GetStats()[S21StatOp::kMulMatrix].calls, 0u);
+}
+
+TEST(S21MatrixStatsTest, OperationsRecordOnlyWhenEnabled) {
+  S21Matrix A = PatternMatrix(10, 20, 1);
+  S21Matrix B = PatternMatrix(20, 30, 2);
+  S21ResetStats();
+  S21Matrix C = A * B;
+  S21Matrix copy = C;
+  copy = A;
+  EXPECT_NE(PatternMatrix(6, 6, 3).Determinant(), 0);
+  S21MatrixStats stats = S21GetStats();
+  if (!S21StatsEnabled()) {
+    EXPECT_EQ(stats[S21StatOp::kMulMatrix].calls, 0u);
+    EXPECT_EQ(stats[S21StatOp::kAllocate].calls, 0u);
+    return;
+  }
+  const S21OpStats& mul = stats[S21StatOp::kMulMatrix];
+  EXPECT_EQ(mul.calls, 1u);
+  EXPECT_EQ(mul.flops, 2u * 10 * 30 * 20);
+  EXPECT_EQ(mul.bytes_allocated, 10u * 30 * sizeof(double));
+  // The copy of C and the one the LU factorization works on.
+  EXPECT_EQ(stats[S21StatOp::kCopyConstruct].bytes_copied,
+            (10u * 30 + 6 * 6) * sizeof(double));
+  // A fits into the buffer of the copy.
+  EXPECT_EQ(stats[S21StatOp::kCopyAssign].bytes_allocated, 0u);
+  EXPECT_EQ(stats[S21StatOp::kCopyAssign].bytes_copied,
+            10u * 20 * sizeof(double));
+  EXPECT_EQ(stats[S21StatOp::kDeterminant].calls, 1u);
+  EXPECT_GE(stats[S21StatOp::kAllocate].bytes_allocated,
+            mul.bytes_allocated + 10u * 30 * sizeof(double));
+}
+
 int main(int argc, char** argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();